@@ -0,0 +1,43 @@
+// BattleLog.cpp
+#include "BattleLog.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+DEFINE_LOG_CATEGORY(LogBattle);
+DEFINE_LOG_CATEGORY(LogBattleUnits);
+DEFINE_LOG_CATEGORY(LogBattleCombat);
+DEFINE_LOG_CATEGORY(LogBattleAI);
+
+#if UE_BUILD_DEVELOPMENT
+static TAutoConsoleVariable<int32> CVarBattleLogMaxPerSecond(
+    TEXT("Battle.Log.MaxPerSecond"),
+    10,
+    TEXT("Lines each battle log call site may print per second. 0 disables the limit."));
+#endif
+
+bool FBattleLogRateLimit::Allow(int32& OutDropped)
+{
+#if UE_BUILD_DEVELOPMENT
+    const int32 MaxPerSecond = CVarBattleLogMaxPerSecond.GetValueOnAnyThread();
+    if (MaxPerSecond > 0)
+    {
+        const double Now = FPlatformTime::Seconds();
+        if (Now - WindowStart >= 1.0)
+        {
+            WindowStart = Now;
+            LinesInWindow = 0;
+        }
+
+        if (LinesInWindow >= MaxPerSecond)
+        {
+            ++Dropped;
+            return false;
+        }
+        ++LinesInWindow;
+    }
+#endif
+
+    OutDropped = Dropped;
+    Dropped = 0;
+    return true;
+}
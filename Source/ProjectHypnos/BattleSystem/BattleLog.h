@@ -0,0 +1,53 @@
+// BattleLog.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Logging/LogMacros.h"
+
+// Battle logging is compiled out of Shipping and Test builds entirely
+#if UE_BUILD_SHIPPING || UE_BUILD_TEST
+    #define BATTLE_LOG_COMPILE_VERBOSITY NoLogging
+#else
+    #define BATTLE_LOG_COMPILE_VERBOSITY All
+#endif
+
+// One category per subsystem, so each can be turned up or down on its own ("log LogBattleUnits Verbose")
+DECLARE_LOG_CATEGORY_EXTERN(LogBattle, Log, BATTLE_LOG_COMPILE_VERBOSITY);          // Battle flow, replays, setup
+DECLARE_LOG_CATEGORY_EXTERN(LogBattleUnits, Log, BATTLE_LOG_COMPILE_VERBOSITY);     // Unit state: position, timers, EO
+DECLARE_LOG_CATEGORY_EXTERN(LogBattleCombat, Log, BATTLE_LOG_COMPILE_VERBOSITY);    // Attacks, defense, skills
+DECLARE_LOG_CATEGORY_EXTERN(LogBattleAI, Log, BATTLE_LOG_COMPILE_VERBOSITY);        // Enemy planning
+
+// How many lines one BATTLE_LOG call site may print per second (Battle.Log.MaxPerSecond). Only
+// Development builds limit; Debug prints everything. Not synchronized: meant for game thread call sites.
+struct PROJECTHYPNOS_API FBattleLogRateLimit
+{
+    double WindowStart = 0.0;
+    int32 LinesInWindow = 0;
+    int32 Dropped = 0;
+
+    // True if the line may print. OutDropped is how many lines were dropped since the last one that printed.
+    bool Allow(int32& OutDropped);
+};
+
+/**
+ * UE_LOG for battle code. Checks the category's verbosity before anything else, so a suppressed
+ * line costs one compare and no formatting, and is limited per call site so a line hit every frame
+ * cannot flood the log.
+ */
+#define BATTLE_LOG(CategoryName, Verbosity, Format, ...) \
+    do \
+    { \
+        if (UE_LOG_ACTIVE(CategoryName, Verbosity)) \
+        { \
+            static FBattleLogRateLimit BattleLogRateLimit; \
+            int32 BattleLogDropped = 0; \
+            if (BattleLogRateLimit.Allow(BattleLogDropped)) \
+            { \
+                if (BattleLogDropped > 0) \
+                { \
+                    UE_LOG(CategoryName, Verbosity, TEXT("(%d more of the next line dropped)"), BattleLogDropped); \
+                } \
+                UE_LOG(CategoryName, Verbosity, Format, ##__VA_ARGS__); \
+            } \
+        } \
+    } while (0)
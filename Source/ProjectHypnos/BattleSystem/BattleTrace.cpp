@@ -0,0 +1,377 @@
+// BattleTrace.cpp
+#include "BattleTrace.h"
+#include "Simulation/BattleSimState.h"
+#include "BattleLog.h"
+#include "Algo/StableSort.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include <atomic>
+
+#if BATTLE_TRACE_ENABLED
+
+namespace
+{
+    // Written only by its thread, read only by the writer
+    struct FTraceRing
+    {
+        static constexpr uint32 Capacity = 4096; // 128 KB, a few seconds of the busiest battle
+        static constexpr uint32 Mask = Capacity - 1;
+
+        FBattleTraceRecord Records[Capacity];
+        alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> Head{0};    // Next slot the thread writes
+        alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> Tail{0};    // Next slot the writer reads
+        std::atomic<uint32> Dropped{0};
+        uint8 Thread = 0;
+    };
+
+    // Rings are kept for the life of the process: a thread that recorded once keeps a pointer to its ring
+    FCriticalSection RingsLock;
+    TArray<FTraceRing*> Rings;
+    thread_local FTraceRing* ThreadRing = nullptr;
+
+    std::atomic<bool> bRecording{false};
+
+    FTraceRing* GetThreadRing()
+    {
+        if (ThreadRing) return ThreadRing;
+
+        FScopeLock Lock(&RingsLock);
+        if (Rings.Num() > MAX_uint8) return nullptr;
+
+        ThreadRing = new FTraceRing;
+        ThreadRing->Thread = (uint8)Rings.Num();
+        Rings.Add(ThreadRing);
+        return ThreadRing;
+    }
+
+    // Drains every ring to the file a few times a second, and once more when stopped
+    class FTraceWriter final : public FRunnable
+    {
+    public:
+        static constexpr uint32 FlushIntervalMs = 100;
+
+        explicit FTraceWriter(IFileHandle* InFile)
+            : File(InFile), WakeEvent(FPlatformProcess::GetSynchEventFromPool())
+        {
+        }
+
+        virtual ~FTraceWriter() override
+        {
+            FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        }
+
+        virtual uint32 Run() override
+        {
+            while (!bStopping.load(std::memory_order_relaxed))
+            {
+                WakeEvent->Wait(FlushIntervalMs);
+                Drain();
+            }
+            Drain();
+            return 0;
+        }
+
+        virtual void Stop() override
+        {
+            bStopping = true;
+            WakeEvent->Trigger();
+        }
+
+        int64 GetRecordsWritten() const { return RecordsWritten; }
+
+    private:
+        void Drain()
+        {
+            TArray<FTraceRing*, TInlineAllocator<16>> Snapshot;
+            {
+                FScopeLock Lock(&RingsLock);
+                Snapshot.Append(Rings);
+            }
+
+            for (FTraceRing* Ring : Snapshot)
+            {
+                const uint32 Tail = Ring->Tail.load(std::memory_order_relaxed);
+                const uint32 Head = Ring->Head.load(std::memory_order_acquire);
+                if (Head == Tail) continue;
+
+                // Written straight from the ring, in at most two pieces where it wraps
+                const uint32 Start = Tail & FTraceRing::Mask;
+                const uint32 Count = Head - Tail;
+                const uint32 FirstCount = FMath::Min(Count, FTraceRing::Capacity - Start);
+                File->Write(reinterpret_cast<const uint8*>(&Ring->Records[Start]), FirstCount * sizeof(FBattleTraceRecord));
+                if (FirstCount < Count)
+                {
+                    File->Write(reinterpret_cast<const uint8*>(&Ring->Records[0]), (Count - FirstCount) * sizeof(FBattleTraceRecord));
+                }
+                RecordsWritten += Count;
+
+                Ring->Tail.store(Head, std::memory_order_release);
+            }
+            File->Flush();
+        }
+
+        IFileHandle* File;
+        FEvent* WakeEvent;
+        std::atomic<bool> bStopping{false};
+        int64 RecordsWritten = 0;
+    };
+
+    // Session state; only touched by Start and Stop
+    FCriticalSection SessionLock;
+    TUniquePtr<IFileHandle> SessionFile;
+    TUniquePtr<FTraceWriter> SessionWriter;
+    TUniquePtr<FRunnableThread> SessionThread;
+    FString SessionPath;
+}
+
+static FAutoConsoleCommand CmdBattleTraceStart(
+    TEXT("Battle.Trace.Start"),
+    TEXT("Starts recording battle events. Optional argument: output path (default Saved/BattleTraces)."),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        BattleTrace::Start(Args.Num() > 0 ? Args[0] : FString());
+    }));
+
+static FAutoConsoleCommand CmdBattleTraceStop(
+    TEXT("Battle.Trace.Stop"),
+    TEXT("Stops recording battle events and closes the trace file."),
+    FConsoleCommandDelegate::CreateStatic(&BattleTrace::Stop));
+
+bool BattleTrace::Start(const FString& Path)
+{
+    FScopeLock Lock(&SessionLock);
+    if (SessionWriter) return false;
+
+    SessionPath = !Path.IsEmpty() ? Path : FPaths::ProjectSavedDir() / TEXT("BattleTraces")
+        / FString::Printf(TEXT("Trace-%s.btrace"), *FDateTime::Now().ToString());
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    PlatformFile.CreateDirectoryTree(*FPaths::GetPath(SessionPath));
+    SessionFile.Reset(PlatformFile.OpenWrite(*SessionPath));
+    if (!SessionFile)
+    {
+        BATTLE_LOG(LogBattle, Error, TEXT("Battle trace: could not open %s"), *SessionPath);
+        return false;
+    }
+
+    FBattleTraceFileHeader Header;
+    Header.SecondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+    SessionFile->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+
+    // Discard anything left from an earlier session; nothing reads the rings until the writer starts
+    {
+        FScopeLock RingLock(&RingsLock);
+        for (FTraceRing* Ring : Rings)
+        {
+            Ring->Tail.store(Ring->Head.load(std::memory_order_acquire), std::memory_order_relaxed);
+            Ring->Dropped = 0;
+        }
+    }
+
+    SessionWriter = MakeUnique<FTraceWriter>(SessionFile.Get());
+    SessionThread.Reset(FRunnableThread::Create(SessionWriter.Get(), TEXT("BattleTraceWriter"), 0, TPri_BelowNormal));
+    if (!SessionThread)
+    {
+        SessionWriter.Reset();
+        SessionFile.Reset();
+        BATTLE_LOG(LogBattle, Error, TEXT("Battle trace: could not start the writer thread"));
+        return false;
+    }
+
+    static bool bStopOnExitRegistered = false;
+    if (!bStopOnExitRegistered)
+    {
+        bStopOnExitRegistered = true;
+        FCoreDelegates::OnPreExit.AddStatic(&BattleTrace::Stop);
+    }
+
+    bRecording = true;
+    BATTLE_LOG(LogBattle, Log, TEXT("Battle trace: recording to %s"), *SessionPath);
+    return true;
+}
+
+void BattleTrace::Stop()
+{
+    FScopeLock Lock(&SessionLock);
+    if (!SessionWriter) return;
+
+    bRecording = false;
+
+    // Stop makes the writer drain once more before the thread exits
+    SessionThread->Kill(true);
+    SessionThread.Reset();
+
+    uint32 Dropped = 0;
+    {
+        FScopeLock RingLock(&RingsLock);
+        for (FTraceRing* Ring : Rings)
+        {
+            Dropped += Ring->Dropped.load(std::memory_order_relaxed);
+        }
+    }
+
+    BATTLE_LOG(LogBattle, Log, TEXT("Battle trace: wrote %lld events to %s (%u dropped)"),
+               SessionWriter->GetRecordsWritten(), *SessionPath, Dropped);
+
+    SessionWriter.Reset();
+    SessionFile.Reset();
+}
+
+void BattleTrace::StartFromCommandLine()
+{
+    static bool bChecked = false;
+    if (bChecked) return;
+    bChecked = true;
+
+    // -BattleTrace, or -BattleTrace=Path
+    FString Path;
+    if (FParse::Value(FCommandLine::Get(), TEXT("BattleTrace="), Path) || FParse::Param(FCommandLine::Get(), TEXT("BattleTrace")))
+    {
+        Start(Path);
+    }
+}
+
+bool BattleTrace::IsRecording()
+{
+    return bRecording.load(std::memory_order_relaxed);
+}
+
+void BattleTrace::RecordEvents(int32 Battle, const FBattleSimState& State, TArrayView<const FBattleSimEvent> Events)
+{
+    if (!bRecording.load(std::memory_order_relaxed) || Events.Num() == 0) return;
+
+    FTraceRing* Ring = GetThreadRing();
+    if (!Ring) return;
+
+    // Events flushed together happened on the same frame, so they share one timestamp
+    const uint64 Cycles = FPlatformTime::Cycles64();
+    uint32 Head = Ring->Head.load(std::memory_order_relaxed);
+    const uint32 Tail = Ring->Tail.load(std::memory_order_acquire);
+
+    const uint32 Free = FTraceRing::Capacity - (Head - Tail);
+    const uint32 Count = FMath::Min<uint32>(Events.Num(), Free);
+    for (uint32 Index = 0; Index < Count; ++Index)
+    {
+        const FBattleSimEvent& Event = Events[Index];
+        FBattleTraceRecord& Record = Ring->Records[Head++ & FTraceRing::Mask];
+        Record.Cycles = Cycles;
+        Record.ClockTick = State.ClockTick;
+        Record.Value = Event.Value;
+        Record.SetNumber = State.CurrentSetNumber;
+        Record.Unit = (int16)Event.Unit;
+        Record.OtherUnit = (int16)Event.OtherUnit;
+        Record.Battle = (uint16)Battle;
+        Record.Type = Event.Type;
+        Record.Thread = Ring->Thread;
+    }
+    Ring->Head.store(Head, std::memory_order_release);
+
+    if (Count < (uint32)Events.Num())
+    {
+        Ring->Dropped.fetch_add(Events.Num() - Count, std::memory_order_relaxed);
+    }
+}
+
+#endif // BATTLE_TRACE_ENABLED
+
+const TCHAR* BattleTrace::GetEventName(EBattleSimEventType Type)
+{
+    switch (Type)
+    {
+    case EBattleSimEventType::BattleStateChanged: return TEXT("BattleStateChanged");
+    case EBattleSimEventType::UnitTurnStarted:    return TEXT("UnitTurnStarted");
+    case EBattleSimEventType::UnitTurnEnded:      return TEXT("UnitTurnEnded");
+    case EBattleSimEventType::SetComplete:        return TEXT("SetComplete");
+    case EBattleSimEventType::EnemyTurnStarted:   return TEXT("EnemyTurnStarted");
+    case EBattleSimEventType::UnitMoved:          return TEXT("UnitMoved");
+    case EBattleSimEventType::Damage:             return TEXT("Damage");
+    case EBattleSimEventType::WeaknessHit:        return TEXT("WeaknessHit");
+    case EBattleSimEventType::UnitDefeated:       return TEXT("UnitDefeated");
+    case EBattleSimEventType::TFNApplied:         return TEXT("TFNApplied");
+    case EBattleSimEventType::StockpileGained:    return TEXT("StockpileGained");
+    case EBattleSimEventType::EOTransformed:      return TEXT("EOTransformed");
+    case EBattleSimEventType::EOFormExited:       return TEXT("EOFormExited");
+    case EBattleSimEventType::StressedOut:        return TEXT("StressedOut");
+    case EBattleSimEventType::DefenseResolved:    return TEXT("DefenseResolved");
+    case EBattleSimEventType::CounterAttack:      return TEXT("CounterAttack");
+    case EBattleSimEventType::SkillUsed:          return TEXT("SkillUsed");
+    case EBattleSimEventType::RantiUsed:          return TEXT("RantiUsed");
+    case EBattleSimEventType::TimerExpired:       return TEXT("TimerExpired");
+    case EBattleSimEventType::SetStarted:         return TEXT("SetStarted");
+    }
+    return TEXT("Unknown");
+}
+
+bool FBattleTraceReader::Load(const FString& Path)
+{
+    Records.Reset();
+    FirstCycles = 0;
+
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *Path) || Bytes.Num() < (int32)sizeof(FBattleTraceFileHeader))
+    {
+        return false;
+    }
+
+    FMemory::Memcpy(&Header, Bytes.GetData(), sizeof(Header));
+    if (Header.Magic != FBattleTraceFileHeader::ExpectedMagic || Header.Version != FBattleTraceFileHeader::CurrentVersion
+        || Header.RecordSize != sizeof(FBattleTraceRecord))
+    {
+        return false;
+    }
+
+    // A session cut short by a crash can end partway through a record
+    const int32 NumRecords = (Bytes.Num() - (int32)sizeof(Header)) / (int32)sizeof(FBattleTraceRecord);
+    Records.SetNumUninitialized(NumRecords);
+    FMemory::Memcpy(Records.GetData(), Bytes.GetData() + sizeof(Header), NumRecords * sizeof(FBattleTraceRecord));
+
+    // Each drain writes one thread's ring after another, so records are only in order per thread
+    Algo::StableSortBy(Records, &FBattleTraceRecord::Cycles);
+    FirstCycles = NumRecords > 0 ? Records[0].Cycles : 0;
+    return true;
+}
+
+double FBattleTraceReader::GetSeconds(const FBattleTraceRecord& Record) const
+{
+    return (double)(Record.Cycles - FirstCycles) * Header.SecondsPerCycle;
+}
+
+FString FBattleTraceReader::ToCSV() const
+{
+    FString Out;
+    Out.Reserve(64 * (Records.Num() + 1));
+    Out += TEXT("Seconds,Battle,Thread,Set,Tick,Event,Unit,OtherUnit,Value\n");
+    for (const FBattleTraceRecord& Record : Records)
+    {
+        Out.Appendf(TEXT("%.6f,%d,%d,%d,%lld,%s,%d,%d,%g\n"),
+                    GetSeconds(Record), (int32)Record.Battle, (int32)Record.Thread, Record.SetNumber, Record.ClockTick,
+                    BattleTrace::GetEventName(Record.Type), Record.Unit, Record.OtherUnit, Record.Value);
+    }
+    return Out;
+}
+
+FString FBattleTraceReader::ToJson() const
+{
+    FString Out;
+    Out.Reserve(128 * (Records.Num() + 1));
+    Out += TEXT("[\n");
+    for (int32 Index = 0; Index < Records.Num(); ++Index)
+    {
+        const FBattleTraceRecord& Record = Records[Index];
+        Out.Appendf(TEXT("  {\"seconds\": %.6f, \"battle\": %d, \"thread\": %d, \"set\": %d, \"tick\": %lld, \"event\": \"%s\", \"unit\": %d, \"otherUnit\": %d, \"value\": %g}%s\n"),
+                    GetSeconds(Record), (int32)Record.Battle, (int32)Record.Thread, Record.SetNumber, Record.ClockTick,
+                    BattleTrace::GetEventName(Record.Type), Record.Unit, Record.OtherUnit, Record.Value,
+                    Index + 1 < Records.Num() ? TEXT(",") : TEXT(""));
+    }
+    Out += TEXT("]\n");
+    return Out;
+}
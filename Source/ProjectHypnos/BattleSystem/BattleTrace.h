@@ -0,0 +1,92 @@
+// BattleTrace.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Simulation/BattleSimTypes.h"
+
+struct FBattleSimState;
+
+// Tracing is compiled out of Shipping builds; Record calls become empty inlines
+#define BATTLE_TRACE_ENABLED !UE_BUILD_SHIPPING
+
+// One traced sim event. Fixed size and layout, so the file is just a header followed by records.
+struct FBattleTraceRecord
+{
+    uint64 Cycles = 0;          // FPlatformTime::Cycles64 when recorded
+    int64 ClockTick = 0;        // Battle clock tick
+    float Value = 0.0f;         // FBattleSimEvent::Value
+    int32 SetNumber = 0;
+    int16 Unit = INDEX_NONE;    // Index into FBattleSimState::Units
+    int16 OtherUnit = INDEX_NONE;
+    uint16 Battle = 0;          // FBattleHandle index
+    EBattleSimEventType Type = EBattleSimEventType::BattleStateChanged;
+    uint8 Thread = 0;           // Order the recording thread first recorded in, from 0
+};
+static_assert(sizeof(FBattleTraceRecord) == 32, "Trace records are written to disk as-is");
+
+struct FBattleTraceFileHeader
+{
+    static constexpr uint32 ExpectedMagic = 0x43525442; // "BTRC"
+    static constexpr uint16 CurrentVersion = 1;
+
+    uint32 Magic = ExpectedMagic;
+    uint16 Version = CurrentVersion;
+    uint16 RecordSize = sizeof(FBattleTraceRecord);
+    double SecondsPerCycle = 0.0;   // Converts record Cycles to seconds
+};
+static_assert(sizeof(FBattleTraceFileHeader) == 16, "Trace headers are written to disk as-is");
+
+/**
+ * Binary trace of battle sim events for playtest sessions. Recording copies a 32-byte record into
+ * a ring owned by the calling thread and never blocks or allocates; a writer thread drains every
+ * ring to disk a few times a second. If a ring fills before it is drained, new records are dropped
+ * and counted rather than stalling the game.
+ *
+ * Start with -BattleTrace on the command line or "Battle.Trace.Start [Path]" in the console. Files
+ * go to Saved/BattleTraces by default; convert them with -run=BattleTrace.
+ */
+namespace BattleTrace
+{
+#if BATTLE_TRACE_ENABLED
+    PROJECTHYPNOS_API bool Start(const FString& Path = FString());
+    PROJECTHYPNOS_API void Stop();
+
+    // Starts a session if -BattleTrace is on the command line and none has been started yet
+    PROJECTHYPNOS_API void StartFromCommandLine();
+
+    PROJECTHYPNOS_API bool IsRecording();
+
+    // Records every event in Events, stamped with State's clock and set
+    PROJECTHYPNOS_API void RecordEvents(int32 Battle, const FBattleSimState& State, TArrayView<const FBattleSimEvent> Events);
+#else
+    inline bool Start(const FString& Path = FString()) { return false; }
+    inline void Stop() {}
+    inline void StartFromCommandLine() {}
+    inline bool IsRecording() { return false; }
+    inline void RecordEvents(int32 Battle, const FBattleSimState& State, TArrayView<const FBattleSimEvent> Events) {}
+#endif
+
+    PROJECTHYPNOS_API const TCHAR* GetEventName(EBattleSimEventType Type);
+}
+
+// Reads a trace file back and converts it for spreadsheets and scripts
+class PROJECTHYPNOS_API FBattleTraceReader
+{
+public:
+    // Fails on a missing file, a different version or a truncated header
+    bool Load(const FString& Path);
+
+    const FBattleTraceFileHeader& GetHeader() const { return Header; }
+    const TArray<FBattleTraceRecord>& GetRecords() const { return Records; }
+
+    // Seconds since the first record
+    double GetSeconds(const FBattleTraceRecord& Record) const;
+
+    FString ToCSV() const;
+    FString ToJson() const;
+
+private:
+    FBattleTraceFileHeader Header;
+    TArray<FBattleTraceRecord> Records;
+    uint64 FirstCycles = 0;
+};
@@ -0,0 +1,345 @@
+// BattleSimCommandlet.cpp
+#include "BattleSimCommandlet.h"
+#include "../Simulation/BattleSimRules.h"
+#include "../Simulation/BattleSimRunner.h"
+#include "../Simulation/BattleReplay.h"
+#include "../Skills/SkillDatabase.h"
+#include "../Skills/RantiDatabase.h"
+#include "../Units/CombatUnit.h"
+#include "../BattleLog.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+    struct FBattleSimReport
+    {
+        int32 Battles = 0;
+        int32 Victories = 0;
+        int32 Defeats = 0;
+        int32 Timeouts = 0;
+        int64 TotalSets = 0;
+        int32 MinSets = MAX_int32;
+        int32 MaxSets = 0;
+        int64 PlayerActions = 0;
+        int64 WeaknessHits = 0;
+        double SPGained = 0.0;
+        int64 EOTransforms = 0;
+        int32 BattlesWithTransform = 0;
+        int64 ForcedEOExits = 0;
+        int64 DefenseAttempts = 0;
+        int64 Counters = 0;
+
+        void Add(const FBattleSimOutcome& Outcome)
+        {
+            ++Battles;
+            Victories += Outcome.IsVictory() ? 1 : 0;
+            Defeats += Outcome.IsDefeat() ? 1 : 0;
+            Timeouts += (!Outcome.IsVictory() && !Outcome.IsDefeat()) ? 1 : 0;
+            TotalSets += Outcome.Sets;
+            MinSets = FMath::Min(MinSets, Outcome.Sets);
+            MaxSets = FMath::Max(MaxSets, Outcome.Sets);
+            PlayerActions += Outcome.PlayerActions;
+            WeaknessHits += Outcome.WeaknessHits;
+            SPGained += Outcome.SPGained;
+            EOTransforms += Outcome.EOTransforms;
+            BattlesWithTransform += Outcome.EOTransforms > 0 ? 1 : 0;
+            ForcedEOExits += Outcome.ForcedEOExits;
+            DefenseAttempts += Outcome.DefenseAttempts;
+            Counters += Outcome.Counters;
+        }
+
+        void Merge(const FBattleSimReport& Other)
+        {
+            Battles += Other.Battles;
+            Victories += Other.Victories;
+            Defeats += Other.Defeats;
+            Timeouts += Other.Timeouts;
+            TotalSets += Other.TotalSets;
+            MinSets = FMath::Min(MinSets, Other.MinSets);
+            MaxSets = FMath::Max(MaxSets, Other.MaxSets);
+            PlayerActions += Other.PlayerActions;
+            WeaknessHits += Other.WeaknessHits;
+            SPGained += Other.SPGained;
+            EOTransforms += Other.EOTransforms;
+            BattlesWithTransform += Other.BattlesWithTransform;
+            ForcedEOExits += Other.ForcedEOExits;
+            DefenseAttempts += Other.DefenseAttempts;
+            Counters += Other.Counters;
+        }
+
+        double PerBattle(double Value) const
+        {
+            return Battles > 0 ? Value / Battles : 0.0;
+        }
+    };
+
+    // Built-in party matching the blueprint setup guide: four players weak to Fire and one boss
+    void BuildDefaultRoster(FBattleSimState& State)
+    {
+        for (int32 PlayerIndex = 0; PlayerIndex < 4; ++PlayerIndex)
+        {
+            FBattleSimUnit Player;
+            Player.UnitType = EUnitType::Player;
+
+            FElementalResistance Weakness;
+            Weakness.ElementType = EElementalType::Fire;
+            Weakness.ResistanceMultiplier = 1.5f;
+            Player.ElementalResistances.Add(Weakness);
+
+            BattleSim::AddUnit(State, Player);
+        }
+
+        FBattleSimUnit Enemy;
+        Enemy.UnitType = EUnitType::Enemy;
+        Enemy.Position = EBattlePosition::Center;
+        Enemy.MaxHP = 150.0f;
+
+        FElementalResistance Weakness;
+        Weakness.ElementType = EElementalType::Light;
+        Weakness.ResistanceMultiplier = 1.5f;
+        Enemy.ElementalResistances.Add(Weakness);
+
+        FElementalResistance Resistance;
+        Resistance.ElementType = EElementalType::Dark;
+        Resistance.ResistanceMultiplier = 0.5f;
+        Enemy.ElementalResistances.Add(Resistance);
+
+        BattleSim::AddUnit(State, Enemy);
+    }
+
+    // Adds the class defaults of each comma separated ACombatUnit blueprint in -Key=
+    bool AddRosterFromParam(FBattleSimState& State, const FString& Params, const TCHAR* Key, EUnitType Side)
+    {
+        FString PathList;
+        if (!FParse::Value(*Params, Key, PathList, false))
+        {
+            return true;
+        }
+
+        TArray<FString> Paths;
+        PathList.ParseIntoArray(Paths, TEXT(","));
+        for (FString Path : Paths)
+        {
+            // Accept plain asset paths as well as full generated class paths
+            if (!Path.Contains(TEXT(".")))
+            {
+                Path = FString::Printf(TEXT("%s.%s_C"), *Path, *FPackageName::GetShortName(Path));
+            }
+
+            UClass* UnitClass = LoadClass<ACombatUnit>(nullptr, *Path);
+            if (!UnitClass)
+            {
+                UE_LOG(LogBattle, Error, TEXT("BattleSim: could not load combat unit class %s"), *Path);
+                return false;
+            }
+
+            FBattleSimUnit Unit = UnitClass->GetDefaultObject<ACombatUnit>()->MakeSimUnit();
+            Unit.UnitType = Side;
+            if (Side == EUnitType::Enemy)
+            {
+                Unit.Position = EBattlePosition::Center;
+            }
+            BattleSim::ResetForBattle(Unit);
+            BattleSim::AddUnit(State, Unit);
+        }
+        return true;
+    }
+
+    FString ReportToJson(const FBattleSimReport& Report, int32 Seed, int32 NumWorkers, double Seconds)
+    {
+        return FString::Printf(
+            TEXT("{\n")
+            TEXT("  \"battles\": %d,\n")
+            TEXT("  \"seed\": %d,\n")
+            TEXT("  \"workers\": %d,\n")
+            TEXT("  \"seconds\": %.3f,\n")
+            TEXT("  \"battles_per_second\": %.1f,\n")
+            TEXT("  \"win_rate\": %.4f,\n")
+            TEXT("  \"defeat_rate\": %.4f,\n")
+            TEXT("  \"timeout_rate\": %.4f,\n")
+            TEXT("  \"avg_sets\": %.3f,\n")
+            TEXT("  \"min_sets\": %d,\n")
+            TEXT("  \"max_sets\": %d,\n")
+            TEXT("  \"avg_player_actions\": %.3f,\n")
+            TEXT("  \"avg_weakness_hits\": %.3f,\n")
+            TEXT("  \"avg_sp_gained\": %.3f,\n")
+            TEXT("  \"avg_eo_transforms\": %.3f,\n")
+            TEXT("  \"eo_transform_battle_rate\": %.4f,\n")
+            TEXT("  \"avg_forced_eo_exits\": %.3f,\n")
+            TEXT("  \"avg_defense_attempts\": %.3f,\n")
+            TEXT("  \"avg_counters\": %.3f\n")
+            TEXT("}\n"),
+            Report.Battles, Seed, NumWorkers, Seconds, Seconds > 0.0 ? Report.Battles / Seconds : 0.0,
+            Report.PerBattle(Report.Victories), Report.PerBattle(Report.Defeats), Report.PerBattle(Report.Timeouts),
+            Report.PerBattle(Report.TotalSets), Report.Battles > 0 ? Report.MinSets : 0, Report.MaxSets,
+            Report.PerBattle(Report.PlayerActions), Report.PerBattle(Report.WeaknessHits), Report.PerBattle(Report.SPGained),
+            Report.PerBattle(Report.EOTransforms), Report.PerBattle(Report.BattlesWithTransform),
+            Report.PerBattle(Report.ForcedEOExits), Report.PerBattle(Report.DefenseAttempts), Report.PerBattle(Report.Counters));
+    }
+
+    // Plays a saved action log headlessly as fast as possible and checks it against its own checkpoints
+    int32 RunReplay(const FString& Params, FString ReplayPath)
+    {
+        if (FPaths::IsRelative(ReplayPath))
+        {
+            ReplayPath = FPaths::Combine(FPaths::ProjectDir(), ReplayPath);
+        }
+
+        TArray<uint8> Bytes;
+        if (!FFileHelper::LoadFileToArray(Bytes, *ReplayPath))
+        {
+            UE_LOG(LogBattle, Error, TEXT("BattleSim: could not read action log %s"), *ReplayPath);
+            return 1;
+        }
+        const int32 NumBytes = Bytes.Num();
+
+        // Logs with skills or Ranti need the databases the battle was recorded with
+        FSkillTable Skills;
+        FRantiRegistry Ranti;
+        USkillDatabase* SkillDatabase = nullptr;
+        FString AssetPath;
+        if (FParse::Value(*Params, TEXT("Skills="), AssetPath))
+        {
+            SkillDatabase = LoadObject<USkillDatabase>(nullptr, *AssetPath);
+            if (!SkillDatabase || !SkillDatabase->LoadTable(Skills))
+            {
+                UE_LOG(LogBattle, Error, TEXT("BattleSim: could not load skill database %s"), *AssetPath);
+                return 1;
+            }
+        }
+        if (FParse::Value(*Params, TEXT("Ranti="), AssetPath))
+        {
+            const URantiDatabase* RantiDatabase = LoadObject<URantiDatabase>(nullptr, *AssetPath);
+            if (!RantiDatabase)
+            {
+                UE_LOG(LogBattle, Error, TEXT("BattleSim: could not load Ranti database %s"), *AssetPath);
+                return 1;
+            }
+            RantiDatabase->BuildRegistry(Ranti, SkillDatabase);
+        }
+
+        FBattleSimState State;
+        FBattleReplay Replay;
+        if (!Replay.Open(MoveTemp(Bytes), State, &Skills, &Ranti))
+        {
+            UE_LOG(LogBattle, Error, TEXT("BattleSim: %s is not a valid action log"), *ReplayPath);
+            return 1;
+        }
+
+        const double StartTime = FPlatformTime::Seconds();
+        Replay.RunToEnd(State);
+        const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+        UE_LOG(LogBattle, Display, TEXT("BattleSim: replayed %s (%d bytes, seed %u) in %.3f ms: state %d, set %d, %d desyncs"),
+               *ReplayPath, NumBytes, Replay.GetSeed(), Seconds * 1000.0, (int32)State.BattleState, State.CurrentSetNumber, Replay.GetNumDesyncs());
+
+        if (Replay.GetNumDesyncs() > 0)
+        {
+            UE_LOG(LogBattle, Error, TEXT("BattleSim: replay desynced, first at byte %d"), Replay.GetFirstDesyncOffset());
+            return 1;
+        }
+        return 0;
+    }
+}
+
+UBattleSimCommandlet::UBattleSimCommandlet()
+{
+    IsClient = false;
+    IsEditor = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UBattleSimCommandlet::Main(const FString& Params)
+{
+    int32 NumBattles = 10000;
+    int32 Seed = 1;
+    FBattleSimRunSettings Settings;
+    FString ReportPath;
+
+    FParse::Value(*Params, TEXT("Battles="), NumBattles);
+    FParse::Value(*Params, TEXT("Seed="), Seed);
+    FParse::Value(*Params, TEXT("MaxSets="), Settings.MaxSets);
+    FParse::Value(*Params, TEXT("Report="), ReportPath);
+
+    FString ReplayPath;
+    if (FParse::Value(*Params, TEXT("Replay="), ReplayPath))
+    {
+        return RunReplay(Params, ReplayPath);
+    }
+
+    NumBattles = FMath::Max(1, NumBattles);
+
+    // Every battle starts as a copy of this template
+    FBattleSimState Template;
+    if (!AddRosterFromParam(Template, Params, TEXT("Players="), EUnitType::Player) ||
+        !AddRosterFromParam(Template, Params, TEXT("Enemies="), EUnitType::Enemy))
+    {
+        return 1;
+    }
+    if (Template.PlayerOrder.Num() == 0 && Template.EnemyIndices.Num() == 0)
+    {
+        BuildDefaultRoster(Template);
+    }
+    if (Template.PlayerOrder.Num() == 0 || Template.EnemyIndices.Num() == 0)
+    {
+        UE_LOG(LogBattle, Error, TEXT("BattleSim: need at least one player and one enemy"));
+        return 1;
+    }
+
+    // Oversplit so uneven battle lengths still balance across workers
+    const int32 NumWorkers = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+    const int32 NumChunks = FMath::Min(NumBattles, NumWorkers * 8);
+    TArray<FBattleSimReport> ChunkReports;
+    ChunkReports.SetNum(NumChunks);
+
+    UE_LOG(LogBattle, Display, TEXT("BattleSim: running %d battles (seed %d) on %d workers"), NumBattles, Seed, NumWorkers);
+
+    const double StartTime = FPlatformTime::Seconds();
+    ParallelFor(NumChunks, [&](int32 Chunk)
+    {
+        const int32 FirstBattle = (int32)((int64)NumBattles * Chunk / NumChunks);
+        const int32 EndBattle = (int32)((int64)NumBattles * (Chunk + 1) / NumChunks);
+
+        // Each chunk reuses one state and writes only to its own report, so workers share nothing
+        FBattleSimState State;
+        FBattleSimReport& Report = ChunkReports[Chunk];
+        for (int32 BattleIndex = FirstBattle; BattleIndex < EndBattle; ++BattleIndex)
+        {
+            State = Template;
+            FRandomStream Stream((int32)HashCombine(GetTypeHash(Seed), GetTypeHash(BattleIndex)));
+            Report.Add(BattleSim::RunBattle(State, Stream, Settings));
+        }
+    });
+    const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+    FBattleSimReport Report;
+    for (const FBattleSimReport& ChunkReport : ChunkReports)
+    {
+        Report.Merge(ChunkReport);
+    }
+
+    const FString Json = ReportToJson(Report, Seed, NumWorkers, Seconds);
+    UE_LOG(LogBattle, Display, TEXT("BattleSim report:\n%s"), *Json);
+
+    if (!ReportPath.IsEmpty())
+    {
+        if (FPaths::IsRelative(ReportPath))
+        {
+            ReportPath = FPaths::Combine(FPaths::ProjectDir(), ReportPath);
+        }
+        if (!FFileHelper::SaveStringToFile(Json, *ReportPath))
+        {
+            UE_LOG(LogBattle, Error, TEXT("BattleSim: failed to write report to %s"), *ReportPath);
+            return 1;
+        }
+        UE_LOG(LogBattle, Display, TEXT("BattleSim: report written to %s"), *ReportPath);
+    }
+
+    return 0;
+}
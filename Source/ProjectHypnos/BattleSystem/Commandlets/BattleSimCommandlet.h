@@ -0,0 +1,30 @@
+// BattleSimCommandlet.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BattleSimCommandlet.generated.h"
+
+/**
+ * Monte Carlo balance runner. Plays N seeded headless battles across all worker threads and
+ * reports aggregate win rate, set count, SP and EO usage.
+ *
+ * UnrealEditor-Cmd ProjectHypnos.uproject -run=BattleSim -nullrhi -unattended
+ *     [-Battles=10000] [-Seed=1] [-MaxSets=50] [-Report=Saved/BattleSim.json]
+ *     [-Players=/Game/Path/BP_A,/Game/Path/BP_B] [-Enemies=/Game/Path/BP_C]
+ *
+ * With -Replay= it instead plays one saved action log headlessly and fails on any desync:
+ *
+ * UnrealEditor-Cmd ProjectHypnos.uproject -run=BattleSim -nullrhi -unattended
+ *     -Replay=Saved/Battle.hlog [-Skills=/Game/Path/DA_Skills.DA_Skills] [-Ranti=/Game/Path/DA_Ranti.DA_Ranti]
+ */
+UCLASS()
+class PROJECTHYPNOS_API UBattleSimCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UBattleSimCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,58 @@
+// BattleTraceCommandlet.cpp
+#include "BattleTraceCommandlet.h"
+#include "../BattleLog.h"
+#include "../BattleTrace.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+UBattleTraceCommandlet::UBattleTraceCommandlet()
+{
+    IsClient = false;
+    IsEditor = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UBattleTraceCommandlet::Main(const FString& Params)
+{
+    FString TracePath;
+    FString Format = TEXT("csv");
+    FString OutPath;
+
+    if (!FParse::Value(*Params, TEXT("Trace="), TracePath))
+    {
+        UE_LOG(LogBattle, Error, TEXT("BattleTrace: need -Trace=<file>"));
+        return 1;
+    }
+    FParse::Value(*Params, TEXT("Format="), Format);
+    FParse::Value(*Params, TEXT("Out="), OutPath);
+
+    const bool bJson = Format.Equals(TEXT("json"), ESearchCase::IgnoreCase);
+    if (!bJson && !Format.Equals(TEXT("csv"), ESearchCase::IgnoreCase))
+    {
+        UE_LOG(LogBattle, Error, TEXT("BattleTrace: unknown format %s, expected csv or json"), *Format);
+        return 1;
+    }
+
+    FBattleTraceReader Reader;
+    if (!Reader.Load(TracePath))
+    {
+        UE_LOG(LogBattle, Error, TEXT("BattleTrace: %s is missing or not a battle trace of this version"), *TracePath);
+        return 1;
+    }
+
+    if (OutPath.IsEmpty())
+    {
+        OutPath = FPaths::ChangeExtension(TracePath, bJson ? TEXT("json") : TEXT("csv"));
+    }
+
+    const FString Text = bJson ? Reader.ToJson() : Reader.ToCSV();
+    if (!FFileHelper::SaveStringToFile(Text, *OutPath))
+    {
+        UE_LOG(LogBattle, Error, TEXT("BattleTrace: failed to write %s"), *OutPath);
+        return 1;
+    }
+
+    UE_LOG(LogBattle, Display, TEXT("BattleTrace: wrote %d events to %s"), Reader.GetRecords().Num(), *OutPath);
+    return 0;
+}
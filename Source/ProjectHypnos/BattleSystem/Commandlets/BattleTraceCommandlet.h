@@ -0,0 +1,25 @@
+// BattleTraceCommandlet.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BattleTraceCommandlet.generated.h"
+
+/**
+ * Converts a battle trace (see BattleTrace.h) to CSV or JSON, ordered by time.
+ *
+ * UnrealEditor-Cmd ProjectHypnos.uproject -run=BattleTrace -nullrhi -unattended
+ *     -Trace=Saved/BattleTraces/Trace.btrace [-Format=csv|json] [-Out=Saved/Trace.csv]
+ *
+ * Without -Out the result is written next to the trace with the format's extension.
+ */
+UCLASS()
+class PROJECTHYPNOS_API UBattleTraceCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UBattleTraceCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -1,13 +1,25 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "BattleManager.h"
+#include "PositionManager.h"
 #include "../Units/CombatUnit.h"
-#include "Kismet/GameplayStatics.h"
+#include "../Simulation/BattleSimRules.h"
+#include "../Simulation/BattleSimHash.h"
+#include "../Simulation/BattleSimRunner.h"
+#include "../Skills/SkillDatabase.h"
+#include "../Skills/RantiDatabase.h"
+#include "../UI/BattleHUDViewModel.h"
+#include "../BattleLog.h"
+#include "../BattleTrace.h"
+#include "Async/Async.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
 #include "Engine/World.h"
 
 ABattleManager::ABattleManager()
 {
-    PrimaryActorTick.bCanEverTick = true;
+    // UBattleWorldSubsystem ticks every battle in one pass
+    PrimaryActorTick.bCanEverTick = false;
     CurrentBattleState = EBattleState::PlayerTurn;
     CurrentUnitIndex = 0;
     CurrentSetNumber = 1;
@@ -16,116 +28,167 @@ ABattleManager::ABattleManager()
     CurrentTimerRemaining = BaseTimerDuration;
     bTFNActive = false;
     TFNSpeedMultiplier = 1.0f;
+
+    HUDViewModel = CreateDefaultSubobject<UBattleHUDViewModel>(TEXT("HUDViewModel"));
+}
+
+void ABattleManager::PostInitializeComponents()
+{
+    Super::PostInitializeComponents();
+
+    if (UBattleWorldSubsystem* Battles = UBattleWorldSubsystem::Get(this))
+    {
+        BattleHandle = Battles->Register(this, BattleId);
+    }
 }
 
 void ABattleManager::BeginPlay()
 {
     Super::BeginPlay();
+    BattleTrace::StartFromCommandLine();
     InitializePlayerUnits();
     InitializeEnemyUnits();
+    LoadSkillData();
+    BuildSimState();
 }
 
-void ABattleManager::Tick(float DeltaTime)
+void ABattleManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-    Super::Tick(DeltaTime);
-
-    if (CurrentBattleState == EBattleState::PlayerTurn && !bIsSetComplete)
+    for (ACombatUnit* Unit : SimUnitActors)
     {
-        // During action animations, do not tick the timer
-        if (!bIsActionAnimationPlaying)
-        {
-            // Apply TFN effect to timer and decrement the active unit's remaining time
-            float ActualDeltaTime = DeltaTime * TFNSpeedMultiplier;
-
-            if (ACombatUnit* ActiveUnit = GetCurrentUnit())
-            {
-                ActiveUnit->TimerRemaining = FMath::Max(0.0f, ActiveUnit->TimerRemaining - ActualDeltaTime);
-                CurrentTimerRemaining = ActiveUnit->TimerRemaining;
-            }
-        }
-
-        // Check if current unit's time is up
-        if (CurrentTimerRemaining <= 0.0f)
+        if (Unit)
         {
-            EndCurrentUnitTurn();
+            Unit->UnbindFromSimulation();
         }
     }
+    SimUnitActors.Reset();
 
-    // Check battle end conditions
-    if (CheckBattleEndConditions())
+    // The planner reads the skill tables owned by this actor
+    CancelEnemyPlanning(true);
+
+    if (UBattleWorldSubsystem* Battles = UBattleWorldSubsystem::Get(this))
     {
-        return;
+        Battles->Unregister(this, BattleHandle);
     }
+
+    Super::EndPlay(EndPlayReason);
 }
 
-void ABattleManager::StartBattle()
+void ABattleManager::TickBattle(float DeltaTime)
 {
-    CurrentBattleState = EBattleState::PlayerTurn;
-    CurrentUnitIndex = 0;
-    CurrentSetNumber = 1;
-    bIsSetComplete = false;
-    CurrentTimerRemaining = BaseTimerDuration;
-    bTFNActive = false;
-    TFNSpeedMultiplier = 1.0f;
-
-    // Reset all player units
-    for (ACombatUnit* Unit : PlayerUnits)
+    // A paused battle is suspended as a whole: no clock, so no timers, passive EO, enemy plan commits
+    // or enemy actions. ResumeBattle returns to the paused phase, and all of them pick up from there.
+    // A replay keeps going, since its own Resume record is what ends the pause.
+    if (SimState.BattleState == EBattleState::Paused && !IsReplaying()) return;
+
+    // Real frame time only moves the fixed-step clock forward. Passive EO and the active timer are
+    // settled lazily, so a frame costs one deadline compare unless the current turn actually runs out.
+    const int32 NumTicks = ClockAccumulator.Advance(DeltaTime);
+    if (Replay.IsValid())
     {
-        if (Unit)
+        // The log carries its own damage resolves, so only the clock and the records move the battle
+        if (NumTicks > 0 && !Replay->Advance(SimState, NumTicks))
         {
-            Unit->ResetForBattle();
-            Unit->SetPosition(EBattlePosition::West); // Start all units in West
+            FinishReplay();
         }
     }
+    else
+    {
+        const int32 FirstNewEvent = SimState.Events.Num();
+        if (NumTicks > 0)
+        {
+            BattleSim::StepTicks(SimState, NumTicks);
+        }
 
-    // Start first unit's turn
-    StartNextUnitTurn();
-    OnBattleStateChanged(CurrentBattleState);
-}
+        // Recorded so a replay can check its turns run out at the same ticks
+        for (int32 EventIndex = FirstNewEvent; EventIndex < SimState.Events.Num(); ++EventIndex)
+        {
+            if (SimState.Events[EventIndex].Type == EBattleSimEventType::TimerExpired)
+            {
+                FBattleLogEntry Entry(EBattleLogRecord::TimerExpired);
+                Entry.Unit = SimState.Events[EventIndex].Unit;
+                RecordInput(Entry);
+            }
+        }
 
-void ABattleManager::EndCurrentUnitTurn()
-{
-    ACombatUnit* CurrentUnit = GetCurrentUnit();
-    if (CurrentUnit)
+        // Hits queued this frame resolve as one batch
+        if (SimState.PendingDamage.Num() > 0)
+        {
+            RecordInput(FBattleLogEntry(EBattleLogRecord::ResolveDamage));
+            BattleSim::ResolveDamage(SimState);
+        }
+    }
+
+    if (SimState.Events.Num() > 0)
     {
-        OnUnitTurnEnded(CurrentUnit);
+        FlushSimEvents();
+    }
+    else if (NumTicks > 0)
+    {
+        CurrentTimerRemaining = BattleClock::TimerUnitsToSeconds(BattleSim::GetTimerRemaining(SimState));
+        HUDViewModel->Refresh(*this);
     }
 
-    // Move to next unit
-    CurrentUnitIndex++;
+    CancelledEnemyPlans.RemoveAllSwap([](const TFuture<FEnemyPlan>& Plan) { return Plan.IsReady(); });
 
-    // Check if we've completed a full cycle through all units
-    if (CurrentUnitIndex >= PlayerUnits.Num())
+    // Polled, never waited on: the plan is committed on the first frame after the worker finishes
+    if (PendingEnemyPlan.IsValid() && PendingEnemyPlan.IsReady())
     {
-        // Check if any units still have time remaining
-        bool bAnyUnitHasTime = false;
-        for (ACombatUnit* Unit : PlayerUnits)
-        {
-            if (Unit && Unit->TimerRemaining > 0.0f)
-            {
-                bAnyUnitHasTime = true;
-                break;
-            }
-        }
+        const FEnemyPlan Plan = PendingEnemyPlan.Get();
+        const bool bCommit = bCommitPendingPlan;
+        PendingEnemyPlan.Reset();
+        EnemyPlanCancel.Reset();
+        bCommitPendingPlan = false;
 
-        if (bAnyUnitHasTime)
+        if (EnemyPlanCache.Num() >= MaxCachedEnemyPlans)
         {
-            // Continue the set with remaining time
-            CurrentUnitIndex = 0;
-            StartNextUnitTurn();
+            EnemyPlanCache.Reset();
         }
-        else
+        EnemyPlanCache.Add(PendingPlanHash, Plan);
+
+        if (bCommit)
         {
-            // Set is complete
-            bIsSetComplete = true;
-            OnSetComplete();
-            StartEnemyTurn();
+            CommitEnemyPlan(Plan);
         }
     }
-    else
+
+    // One enemy action at a time, each after the previous one has played out
+    if (NextEnemyAction != INDEX_NONE && !bEnemyActionInProgress)
+    {
+        AdvanceEnemyPhase();
+    }
+}
+
+void ABattleManager::StartBattle()
+{
+    // Pick up any roster changes made since BeginPlay
+    CancelEnemyPlanning(false);
+    StopEnemyPhase();
+    EnemyPlanCache.Reset();
+    EnemySearchTable.Reset(); // A cancelled search may still hold the old table
+    Replay.Reset();
+    History.Reset();
+    BuildSimState();
+    ClockAccumulator.Reset();
+
+    BattleSeed = FPlatformTime::Cycles();
+    ActionLog.Reset();
+    if (bRecordActionLog)
     {
-        StartNextUnitTurn();
+        ActionLog.Begin(SimState, BattleSeed);
     }
+
+    RecordInput(FBattleLogEntry(EBattleLogRecord::StartBattle));
+    BattleSim::StartBattle(SimState);
+    FlushSimEvents();
+}
+
+void ABattleManager::EndCurrentUnitTurn()
+{
+    if (!RecordInput(FBattleLogEntry(EBattleLogRecord::EndTurn))) return;
+
+    BattleSim::EndCurrentUnitTurn(SimState);
+    FlushSimEvents();
 }
 
 void ABattleManager::PassTurn()
@@ -136,28 +199,10 @@ void ABattleManager::PassTurn()
 
 void ABattleManager::StartNextUnitTurn()
 {
-    ACombatUnit* CurrentUnit = GetCurrentUnit();
-    if (CurrentUnit)
-    {
-        // If unit cannot act (KO or incapacitated), immediately skip
-        if (!CurrentUnit->CanAct())
-        {
-            EndCurrentUnitTurn();
-            return;
-        }
+    if (!RecordInput(FBattleLogEntry(EBattleLogRecord::StartNextUnitTurn))) return;
 
-        // Reset timer for this unit
-        CurrentTimerRemaining = CurrentUnit->TimerRemaining;
-        
-        // Apply TFN effect if active
-        if (bTFNActive)
-        {
-            CurrentUnit->ApplyTFN(TFNSpeedMultiplier);
-            bTFNActive = false; // Reset TFN after applying
-        }
-
-        OnUnitTurnStarted(CurrentUnit);
-    }
+    BattleSim::StartNextUnitTurn(SimState);
+    FlushSimEvents();
 }
 
 void ABattleManager::ExecuteAction(const FBattleAction& Action)
@@ -172,11 +217,11 @@ void ABattleManager::ExecuteAction(const FBattleAction& Action)
         case EActionType::Attack:
             if (Action.TargetUnit)
             {
-                AttackUnit(Action.ActingUnit, Action.TargetUnit);
+                AttackUnit(Action.ActingUnit, Action.TargetUnit, Action.Element);
             }
             break;
         case EActionType::Skill:
-            UseSkill(Action.ActingUnit, Action.SkillName, Action.TargetUnit);
+            UseSkill(Action.ActingUnit, Action.SkillId, Action.TargetUnit);
             break;
         case EActionType::Item:
             // TODO: Implement item system
@@ -185,7 +230,11 @@ void ABattleManager::ExecuteAction(const FBattleAction& Action)
             // Just pass turn
             break;
         case EActionType::Ranti:
-            // TODO: Implement Ranti skill system
+            // SkillId names the combo
+            UseRantiSkill(Action.SkillId, Action.ActingUnit, Action.TargetUnit);
+            break;
+        case EActionType::Transform:
+            TransformToEO(Action.ActingUnit);
             break;
     }
 }
@@ -194,180 +243,612 @@ void ABattleManager::MoveUnit(ACombatUnit* Unit, EBattlePosition NewPosition)
 {
     if (!Unit) return;
 
-    Unit->SetPosition(NewPosition);
-    UE_LOG(LogTemp, Log, TEXT("%s moved to position %d"), *Unit->UnitName, (int32)NewPosition);
+    const int32 UnitIndex = GetSimIndex(Unit);
+    if (UnitIndex == INDEX_NONE)
+    {
+        // Not part of this battle, move the actor on its own
+        Unit->SetPosition(NewPosition);
+        return;
+    }
+
+    FBattleLogEntry Entry(EBattleLogRecord::Action);
+    Entry.Action.ActingUnit = UnitIndex;
+    Entry.Action.ActionType = EActionType::Move;
+    Entry.Action.TargetPosition = NewPosition;
+    if (!RecordInput(Entry)) return;
+    CaptureActionSnapshot();
+
+    BattleSim::MoveUnit(SimState, UnitIndex, NewPosition);
+    FlushSimEvents();
+}
+
+void ABattleManager::TransformToEO(ACombatUnit* Unit)
+{
+    if (!Unit) return;
+
+    const int32 UnitIndex = GetSimIndex(Unit);
+    if (UnitIndex == INDEX_NONE)
+    {
+        // Not part of this battle, transform the actor on its own
+        Unit->TransformToEO();
+        return;
+    }
+
+    FBattleLogEntry Entry(EBattleLogRecord::Action);
+    Entry.Action.ActingUnit = UnitIndex;
+    Entry.Action.ActionType = EActionType::Transform;
+    if (!RecordInput(Entry)) return;
+    CaptureActionSnapshot();
+
+    BattleSim::TransformToEO(SimState, UnitIndex);
+    FlushSimEvents();
 }
 
 void ABattleManager::AttackUnit(ACombatUnit* Attacker, ACombatUnit* Target, EElementalType ElementType)
 {
     if (!Attacker || !Target) return;
 
-    // Calculate damage (simplified for now)
-    float BaseDamage = 20.0f;
-    
-    // Apply elemental damage
-    float ElementalMultiplier = Target->GetElementalDamageMultiplier(ElementType);
-    float FinalDamage = BaseDamage * ElementalMultiplier;
+    const int32 AttackerIndex = GetSimIndex(Attacker);
+    const int32 TargetIndex = GetSimIndex(Target);
+    if (AttackerIndex == INDEX_NONE || TargetIndex == INDEX_NONE)
+    {
+        BATTLE_LOG(LogBattleCombat, Warning, TEXT("AttackUnit: %s or %s is not part of this battle"), *Attacker->UnitName, *Target->UnitName);
+        return;
+    }
+
+    FBattleLogEntry Entry(EBattleLogRecord::Action);
+    Entry.Action.ActingUnit = AttackerIndex;
+    Entry.Action.ActionType = EActionType::Attack;
+    Entry.Action.TargetUnit = TargetIndex;
+    Entry.Action.Element = ElementType;
+    if (!RecordInput(Entry)) return;
+    CaptureActionSnapshot();
+
+    const float ElementalMultiplier = BattleSim::GetElementalDamageMultiplier(SimState.Units, TargetIndex, ElementType);
+    const float FinalDamage = SimState.Tuning.BaseAttackDamage * ElementalMultiplier;
 
-    // Apply damage
-    Target->TakeDamageCustom(FinalDamage, ElementType);
+    BattleSim::AttackUnit(SimState, AttackerIndex, TargetIndex, ElementType);
+
+    BATTLE_LOG(LogBattleCombat, Log, TEXT("%s attacked %s for %f damage (Elemental Multiplier: %f)"),
+           *Attacker->UnitName, *Target->UnitName, FinalDamage, ElementalMultiplier);
 
-    // Check for weakness hit
-    if (ElementalMultiplier > 1.0f)
+    FlushSimEvents();
+}
+
+void ABattleManager::AttackUnits(ACombatUnit* Attacker, const TArray<ACombatUnit*>& Targets, EElementalType ElementType)
+{
+    const int32 AttackerIndex = GetSimIndex(Attacker);
+    if (AttackerIndex == INDEX_NONE) return;
+
+    TArray<int32, TInlineAllocator<BattleSim::MaxDamageBatchTargets>> TargetIndices;
+    for (ACombatUnit* Target : Targets)
     {
-        HandleWeaknessHit(Attacker, Target, ElementType);
+        const int32 TargetIndex = GetSimIndex(Target);
+        if (TargetIndex != INDEX_NONE && TargetIndices.Num() < BattleSim::MaxDamageBatchTargets)
+        {
+            TargetIndices.Add(TargetIndex);
+        }
     }
+    if (TargetIndices.Num() == 0) return;
 
-    UE_LOG(LogTemp, Log, TEXT("%s attacked %s for %f damage (Elemental Multiplier: %f)"), 
-           *Attacker->UnitName, *Target->UnitName, FinalDamage, ElementalMultiplier);
+    FBattleLogEntry Entry(EBattleLogRecord::AttackBatch);
+    Entry.Damage.Attacker = AttackerIndex;
+    Entry.Damage.Element = ElementType;
+    Entry.Targets.Append(TargetIndices);
+    if (!RecordInput(Entry)) return;
+    CaptureActionSnapshot();
+
+    const FBattleSimDamageBatchResult Result = BattleSim::ApplyDamage(SimState, AttackerIndex, TargetIndices, ElementType, SimState.Tuning.BaseAttackDamage);
+
+    BATTLE_LOG(LogBattleCombat, Log, TEXT("%s hit %d targets for %f total damage (%d weakness hits)"),
+           *Attacker->UnitName, TargetIndices.Num(), Result.TotalDamage, FMath::CountBits(Result.WeaknessMask));
+
+    FlushSimEvents();
+}
+
+void ABattleManager::QueueAttack(ACombatUnit* Attacker, ACombatUnit* Target, EElementalType ElementType, float Damage)
+{
+    const int32 TargetIndex = GetSimIndex(Target);
+    if (TargetIndex == INDEX_NONE) return;
+
+    FDamageRequest Request;
+    Request.Attacker = GetSimIndex(Attacker);
+    Request.Target = TargetIndex;
+    Request.Element = ElementType;
+    Request.BaseDamage = Damage >= 0.0f ? Damage : SimState.Tuning.BaseAttackDamage;
+
+    FBattleLogEntry Entry(EBattleLogRecord::QueueDamage);
+    Entry.Damage = Request;
+    if (!RecordInput(Entry)) return;
+
+    // Hits queued together undo together
+    if (SimState.PendingDamage.Num() == 0)
+    {
+        CaptureActionSnapshot();
+    }
+
+    BattleSim::QueueDamage(SimState, Request);
+}
+
+void ABattleManager::ResolvePendingDamage()
+{
+    if (SimState.PendingDamage.Num() == 0) return;
+    if (!RecordInput(FBattleLogEntry(EBattleLogRecord::ResolveDamage))) return;
+
+    BattleSim::ResolveDamage(SimState);
+    FlushSimEvents();
 }
 
-void ABattleManager::UseSkill(ACombatUnit* Caster, const FString& SkillName, ACombatUnit* Target)
+EDefenseResult ABattleManager::ResolveDefense(ACombatUnit* Defender, ACombatUnit* Attacker, EDefenseType DefenseType, float TimingAccuracy, float Damage, const FBattleSimDefenseTuning& DefenseTuning)
+{
+    const int32 DefenderIndex = GetSimIndex(Defender);
+    if (DefenderIndex == INDEX_NONE) return EDefenseResult::Failure;
+    if (IsReplaying()) return EDefenseResult::Failure;
+
+    // Tuning is content that rarely changes, so it is only logged when it does
+    if (FMemory::Memcmp(&SimState.DefenseTuning, &DefenseTuning, sizeof(FBattleSimDefenseTuning)) != 0)
+    {
+        FBattleLogEntry TuningEntry(EBattleLogRecord::DefenseTuning);
+        TuningEntry.DefenseTuning = DefenseTuning;
+        RecordInput(TuningEntry);
+    }
+
+    FBattleLogEntry Entry(EBattleLogRecord::Defense);
+    Entry.Damage.Target = DefenderIndex;
+    Entry.Damage.Attacker = GetSimIndex(Attacker);
+    Entry.Damage.Defense = DefenseType;
+    Entry.Damage.TimingAccuracy = TimingAccuracy;
+    Entry.Damage.BaseDamage = Damage;
+    RecordInput(Entry);
+
+    SimState.DefenseTuning = DefenseTuning;
+    const EDefenseResult Result = BattleSim::ResolveDefense(SimState, DefenderIndex, GetSimIndex(Attacker), DefenseType, TimingAccuracy, Damage);
+    FlushSimEvents();
+    return Result;
+}
+
+void ABattleManager::UseSkill(ACombatUnit* Caster, FName SkillId, ACombatUnit* Target)
 {
     if (!Caster) return;
 
-    // TODO: Implement skill system
-    UE_LOG(LogTemp, Log, TEXT("%s used skill: %s"), *Caster->UnitName, *SkillName);
+    const int32 CasterIndex = GetSimIndex(Caster);
+    if (CasterIndex == INDEX_NONE)
+    {
+        BATTLE_LOG(LogBattleCombat, Warning, TEXT("UseSkill: %s is not part of this battle"), *Caster->UnitName);
+        return;
+    }
+
+    const int32 SkillIndex = LoadedSkillDatabase ? LoadedSkillDatabase->FindSkillIndex(SkillId) : INDEX_NONE;
+    if (SkillIndex == INDEX_NONE)
+    {
+        BATTLE_LOG(LogBattleCombat, Warning, TEXT("UseSkill: %s is not in the skill database"), *SkillId.ToString());
+        return;
+    }
+
+    FBattleLogEntry Entry(EBattleLogRecord::Action);
+    Entry.Action.ActingUnit = CasterIndex;
+    Entry.Action.ActionType = EActionType::Skill;
+    Entry.Action.SkillIndex = SkillIndex;
+    Entry.Action.TargetUnit = GetSimIndex(Target);
+    if (!RecordInput(Entry)) return;
+    CaptureActionSnapshot();
+
+    if (!BattleSim::UseSkill(SimState, CasterIndex, SkillIndex, Entry.Action.TargetUnit))
+    {
+        BATTLE_LOG(LogBattleCombat, Log, TEXT("%s cannot use skill %s"), *Caster->UnitName, *SkillId.ToString());
+    }
+
+    FlushSimEvents();
+}
+
+void ABattleManager::UseRantiSkill(FName ComboId, ACombatUnit* Initiator, ACombatUnit* Target)
+{
+    if (!Initiator) return;
+
+    const int32 InitiatorIndex = GetSimIndex(Initiator);
+    if (InitiatorIndex == INDEX_NONE)
+    {
+        BATTLE_LOG(LogBattleCombat, Warning, TEXT("UseRantiSkill: %s is not part of this battle"), *Initiator->UnitName);
+        return;
+    }
+
+    const int32 Combo = LoadedRantiDatabase ? LoadedRantiDatabase->FindComboIndex(ComboId) : INDEX_NONE;
+    if (Combo == INDEX_NONE)
+    {
+        BATTLE_LOG(LogBattleCombat, Warning, TEXT("UseRantiSkill: %s is not in the ranti database"), *ComboId.ToString());
+        return;
+    }
+
+    const int32 TargetIndex = GetSimIndex(Target);
+
+    FBattleLogEntry Entry(EBattleLogRecord::Action);
+    Entry.Action.ActingUnit = InitiatorIndex;
+    Entry.Action.ActionType = EActionType::Ranti;
+    Entry.Action.ComboIndex = Combo;
+    Entry.Action.TargetUnit = TargetIndex;
+    if (!RecordInput(Entry)) return;
+    CaptureActionSnapshot();
+
+    if (!BattleSim::UseRanti(SimState, Combo, InitiatorIndex, TargetIndex))
+    {
+        BATTLE_LOG(LogBattleCombat, Log, TEXT("Ranti %s is not available to %s"), *ComboId.ToString(), *Initiator->UnitName);
+    }
+
+    FlushSimEvents();
 }
 
-void ABattleManager::UseRantiSkill(const FString& SkillName, TArray<ACombatUnit*> RequiredUnits)
+bool ABattleManager::IsAnyRantiAvailable(const ACombatUnit* Unit) const
 {
-    // TODO: Implement Ranti skill system
-    UE_LOG(LogTemp, Log, TEXT("Ranti skill used: %s"), *SkillName);
+    const uint64 UnitMask = GetRantiCharacterMask(Unit);
+    return UnitMask != 0 && RantiRegistry.IsAnyAvailable(FRantiRegistry::MakePartyState(SimState), UnitMask);
+}
+
+void ABattleManager::GetAvailableRantiCombos(const ACombatUnit* Unit, TArray<FName>& OutComboIds) const
+{
+    OutComboIds.Reset();
+
+    const uint64 UnitMask = GetRantiCharacterMask(Unit);
+    if (UnitMask == 0 || !LoadedRantiDatabase) return;
+
+    TArray<int32> Combos;
+    RantiRegistry.GetAvailable(FRantiRegistry::MakePartyState(SimState), UnitMask, Combos);
+    for (int32 Combo : Combos)
+    {
+        OutComboIds.Add(LoadedRantiDatabase->Combos[Combo].ComboId);
+    }
+}
+
+uint64 ABattleManager::GetRantiCharacterMask(const ACombatUnit* Unit) const
+{
+    const int32 UnitIndex = GetSimIndex(Unit);
+    if (UnitIndex == INDEX_NONE) return 0;
+
+    const int32 Bit = SimState.Units.CharacterBit[UnitIndex];
+    return Bit != INDEX_NONE ? 1ull << Bit : 0;
 }
 
 void ABattleManager::ApplyTFNToNextUnit(float SpeedMultiplier)
 {
-    bTFNActive = true;
-    TFNSpeedMultiplier = FMath::Max(0.25f, SpeedMultiplier); // Capped at 0.25x
-    UE_LOG(LogTemp, Log, TEXT("TFN applied to next unit with speed multiplier: %f"), TFNSpeedMultiplier);
+    FBattleLogEntry Entry(EBattleLogRecord::TFNToNextUnit);
+    Entry.Value = SpeedMultiplier;
+    if (!RecordInput(Entry)) return;
+
+    BattleSim::ApplyTFNToNextUnit(SimState, SpeedMultiplier);
+    SyncFromSimState();
+    BATTLE_LOG(LogBattleCombat, Log, TEXT("TFN applied to next unit with speed multiplier: %f"), TFNSpeedMultiplier);
 }
 
 void ABattleManager::AddStockpiledTime(ACombatUnit* Unit, float TimeToAdd)
 {
-    if (Unit)
+    if (!Unit) return;
+
+    const int32 UnitIndex = GetSimIndex(Unit);
+    if (UnitIndex == INDEX_NONE)
     {
         Unit->AddStockpiledTime(TimeToAdd);
+        return;
     }
+
+    FBattleLogEntry Entry(EBattleLogRecord::AddStockpile);
+    Entry.Unit = UnitIndex;
+    Entry.Value = TimeToAdd;
+    if (!RecordInput(Entry)) return;
+
+    BattleSim::AddStockpiledTime(SimState, UnitIndex, TimeToAdd);
+    FlushSimEvents();
 }
 
 void ABattleManager::HandleWeaknessHit(ACombatUnit* Attacker, ACombatUnit* Target, EElementalType ElementType)
 {
-    // Add SP time to attacker
-    float SPGain = 2.0f; // Base SP gain for weakness hit
-    AddStockpiledTime(Attacker, SPGain);
+    FBattleLogEntry Entry(EBattleLogRecord::WeaknessHit);
+    Entry.Damage.Attacker = GetSimIndex(Attacker);
+    Entry.Damage.Target = GetSimIndex(Target);
+    Entry.Damage.Element = ElementType;
+    if (!RecordInput(Entry)) return;
+
+    BattleSim::HandleWeaknessHit(SimState, GetSimIndex(Attacker), GetSimIndex(Target), ElementType);
+    FlushSimEvents();
+}
 
-    // Apply TFN to next unit in turn order
-    const float NextUnitSpeedMultiplier = 0.75f; // Slow down next unit
-    ApplyTFNToNextUnit(NextUnitSpeedMultiplier);
+void ABattleManager::CheckSetCompletion()
+{
+    if (!RecordInput(FBattleLogEntry(EBattleLogRecord::CheckSetCompletion))) return;
 
-    UE_LOG(LogTemp, Warning, TEXT("Weakness hit! %s gained %f SP, TFN applied to next unit"), 
-           *Attacker->UnitName, SPGain);
+    BattleSim::CheckSetCompletion(SimState);
+    FlushSimEvents();
 }
 
-void ABattleManager::CheckSetCompletion()
+void ABattleManager::StartEnemyTurn()
 {
-    bool bAllUnitsOutOfTime = true;
-    for (ACombatUnit* Unit : PlayerUnits)
+    if (!RecordInput(FBattleLogEntry(EBattleLogRecord::StartEnemyTurn))) return;
+
+    BattleSim::StartEnemyTurn(SimState);
+    FlushSimEvents();
+}
+
+void ABattleManager::EndEnemyTurn()
+{
+    if (!RecordInput(FBattleLogEntry(EBattleLogRecord::EndEnemyTurn))) return;
+
+    BattleSim::EndEnemyTurn(SimState);
+    FlushSimEvents();
+}
+
+void ABattleManager::RunEnemyPhase()
+{
+    // The log already holds the actions the enemies took
+    if (IsReplaying()) return;
+
+    const uint64 PlanningHash = BattleSim::HashPlanningState(SimState);
+
+    // Planned while the players were acting: no pause at all
+    if (const FEnemyPlan* CachedPlan = EnemyPlanCache.Find(PlanningHash))
     {
-        if (Unit && Unit->TimerRemaining > 0.0f)
+        const FEnemyPlan Plan = *CachedPlan;
+        CommitEnemyPlan(Plan);
+        return;
+    }
+
+    // Still being planned for this exact state, so claim it instead of starting over
+    if (PendingEnemyPlan.IsValid() && PendingPlanHash == PlanningHash)
+    {
+        bCommitPendingPlan = true;
+        return;
+    }
+
+    StartEnemyPlanning(SimState, PlanningHash, true);
+}
+
+void ABattleManager::SpeculateEnemyPlan()
+{
+    if (IsReplaying()) return;
+    if (SimState.BattleState != EBattleState::PlayerTurn || SimState.EnemyIndices.Num() == 0) return;
+
+    const uint64 PlanningHash = BattleSim::HashPlanningState(SimState);
+    if (EnemyPlanCache.Contains(PlanningHash)) return;
+    if (PendingEnemyPlan.IsValid() && PendingPlanHash == PlanningHash) return;
+
+    // Plan from the enemy turn this state would lead to. Anything older is out of date.
+    FBattleSimState PlanningState = SimState;
+    BattleSim::StartEnemyTurn(PlanningState);
+    PlanningState.Events.Reset();
+    StartEnemyPlanning(PlanningState, PlanningHash, false);
+}
+
+void ABattleManager::StartEnemyPlanning(const FBattleSimState& PlanningState, uint64 PlanningHash, bool bCommitWhenReady)
+{
+    CancelEnemyPlanning(false);
+
+    FEnemyPlannerSettings Settings = FEnemyPlannerSettings::ForDifficulty(EnemyDifficulty);
+    if (EnemyPlanningBudget > 0.0f)
+    {
+        Settings.TimeBudgetSeconds = EnemyPlanningBudget;
+    }
+
+    // The planner searches its own copy of the state, so the game thread never waits on it. Seeding
+    // from the hash makes a speculative plan identical to one made when the turn starts.
+    TSharedPtr<std::atomic<bool>, ESPMode::ThreadSafe> Cancel = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+    const int32 Seed = (int32)HashCombine(GetTypeHash(PlanningHash), BattleSeed);
+    EnemyPlanCancel = Cancel;
+    PendingPlanHash = PlanningHash;
+    bCommitPendingPlan = bCommitWhenReady;
+
+    if (HasBossEnemy())
+    {
+        FEnemySearchSettings SearchSettings;
+        SearchSettings.TimeBudgetSeconds = BossSearchBudget;
+        if (!EnemySearchTable)
         {
-            bAllUnitsOutOfTime = false;
-            break;
+            EnemySearchTable = MakeShared<FTranspositionTable, ESPMode::ThreadSafe>();
         }
+
+        PendingEnemyPlan = Async(EAsyncExecution::ThreadPool, [State = PlanningState, SearchSettings, Seed, Cancel, Table = EnemySearchTable]()
+        {
+            return BattleSim::SearchEnemyPhase(State, *Table, SearchSettings, Seed, Cancel.Get());
+        });
+        return;
     }
 
-    if (bAllUnitsOutOfTime)
+    PendingEnemyPlan = Async(EAsyncExecution::ThreadPool, [State = PlanningState, Settings, Seed, Cancel]()
+    {
+        return BattleSim::PlanEnemyPhase(State, Settings, Seed, Cancel.Get());
+    });
+}
+
+bool ABattleManager::HasBossEnemy() const
+{
+    for (const ACombatUnit* Unit : EnemyUnits)
     {
-        bIsSetComplete = true;
-        OnSetComplete();
-        StartEnemyTurn();
+        if (Unit && Unit->bIsBoss)
+        {
+            return true;
+        }
     }
+    return false;
 }
 
-void ABattleManager::StartEnemyTurn()
+void ABattleManager::CommitEnemyPlan(const FEnemyPlan& Plan)
 {
-    CurrentBattleState = EBattleState::EnemyTurn;
-    OnEnemyTurnStarted();
-    OnBattleStateChanged(CurrentBattleState);
+    if (SimState.BattleState != EBattleState::EnemyTurn) return;
 
-    // TODO: Implement enemy AI logic
-    UE_LOG(LogTemp, Warning, TEXT("Enemy turn started!"));
+    if (Plan.SearchNodes > 0)
+    {
+        BATTLE_LOG(LogBattleAI, Log, TEXT("Boss plan ready: %d actions, depth %d over %lld nodes"),
+               Plan.Actions.Num(), Plan.SearchDepth, Plan.SearchNodes);
+    }
+    else
+    {
+        BATTLE_LOG(LogBattleAI, Log, TEXT("Enemy plan ready: %d actions from %d rollouts%s"),
+               Plan.Actions.Num(), Plan.Rollouts, Plan.bHitBudget ? TEXT(" (budget reached)") : TEXT(""));
+    }
 
-    // For now, just end enemy turn immediately
-    EndEnemyTurn();
+    ActiveEnemyPlan = Plan;
+    NextEnemyAction = 0;
+    bEnemyActionInProgress = false;
+    EnemyDefenseStream.Initialize((int32)HashCombine(GetTypeHash(SimState.CurrentSetNumber), BattleSeed));
+    AdvanceEnemyPhase();
 }
 
-void ABattleManager::EndEnemyTurn()
+void ABattleManager::AdvanceEnemyPhase()
 {
-    CurrentBattleState = EBattleState::PlayerTurn;
-    CurrentUnitIndex = 0;
-    CurrentSetNumber++;
-    bIsSetComplete = false;
+    if (NextEnemyAction == INDEX_NONE) return;
 
-    // Reset all player units for new set
-    for (ACombatUnit* Unit : PlayerUnits)
+    if (CheckBattleEndConditions() || SimState.BattleState != EBattleState::EnemyTurn)
     {
-        if (Unit)
-        {
-            Unit->ResetTimer();
-        }
+        StopEnemyPhase();
+        return;
+    }
+
+    if (NextEnemyAction >= ActiveEnemyPlan.Actions.Num())
+    {
+        StopEnemyPhase();
+        EndEnemyTurn();
+        return;
     }
 
-    // Start new set
-    StartNewSet();
+    const FBattleSimAction& SimAction = ActiveEnemyPlan.Actions[NextEnemyAction++];
+    FBattleAction Action;
+    Action.ActingUnit = GetUnitActor(SimAction.ActingUnit);
+    Action.ActionType = SimAction.ActionType;
+    Action.TargetUnit = GetUnitActor(SimAction.TargetUnit);
+    Action.Element = SimAction.Element;
+
+    bEnemyActionInProgress = true;
+    ExecuteEnemyAction(Action);
 }
 
-void ABattleManager::RetryBattle()
+void ABattleManager::ContinueEnemyPhase()
 {
-    // Reset battle state to beginning
-    CurrentBattleState = EBattleState::PlayerTurn;
-    CurrentUnitIndex = 0;
-    CurrentSetNumber = 1;
-    bIsSetComplete = false;
-    bTFNActive = false;
-    TFNSpeedMultiplier = 1.0f;
-    bIsActionAnimationPlaying = false;
+    bEnemyActionInProgress = false;
+}
+
+void ABattleManager::StopEnemyPhase()
+{
+    ActiveEnemyPlan = FEnemyPlan();
+    NextEnemyAction = INDEX_NONE;
+    bEnemyActionInProgress = false;
+}
 
-    for (ACombatUnit* Unit : PlayerUnits)
+void ABattleManager::CancelEnemyPlanning(bool bWaitForWorker)
+{
+    if (EnemyPlanCancel)
     {
-        if (Unit)
-        {
-            Unit->ResetForBattle();
-            Unit->SetPosition(EBattlePosition::West);
-        }
+        EnemyPlanCancel->store(true);
     }
 
-    for (ACombatUnit* Enemy : EnemyUnits)
+    // A cancelled worker stops at its next check, but may still be reading the tables until then
+    if (PendingEnemyPlan.IsValid() && !PendingEnemyPlan.IsReady())
     {
-        if (Enemy)
+        CancelledEnemyPlans.Add(MoveTemp(PendingEnemyPlan));
+    }
+
+    // Only needed when the tables the workers read are about to go away
+    if (bWaitForWorker)
+    {
+        for (const TFuture<FEnemyPlan>& Plan : CancelledEnemyPlans)
         {
-            Enemy->ResetForBattle();
-            Enemy->SetPosition(EBattlePosition::Center);
+            Plan.Wait();
         }
+        CancelledEnemyPlans.Reset();
     }
 
-    StartNextUnitTurn();
-    OnBattleStateChanged(CurrentBattleState);
+    PendingEnemyPlan.Reset();
+    EnemyPlanCancel.Reset();
+    bCommitPendingPlan = false;
+}
+
+void ABattleManager::ExecuteEnemyAction_Implementation(const FBattleAction& Action)
+{
+    // Attacks resolve as defended hits, the way ApplyPlannedEnemyAction scored them
+    const int32 Target = GetSimIndex(Action.TargetUnit);
+    if (Action.ActionType == EActionType::Attack && Target != INDEX_NONE)
+    {
+        const EDefenseType Defense = BattleSim::PickScriptedDefense(SimState, Target, EnemyDefenseStream);
+        const float TimingAccuracy = EnemyDefenseStream.FRand();
+        ResolveDefense(Action.TargetUnit, Action.ActingUnit, Defense, TimingAccuracy, SimState.Tuning.BaseAttackDamage, SimState.DefenseTuning);
+    }
+    else
+    {
+        ExecuteAction(Action);
+    }
+    ContinueEnemyPhase();
+}
+
+void ABattleManager::RetryBattle()
+{
+    if (!RecordInput(FBattleLogEntry(EBattleLogRecord::RetryBattle))) return;
+
+    CancelEnemyPlanning(false);
+    StopEnemyPhase();
+    EnemyPlanCache.Reset();
+    ClockAccumulator.Reset();
+    History.Reset(); // Sets of the lost attempt are gone
+    BattleSim::RetryBattle(SimState);
+    FlushSimEvents();
+}
+
+bool ABattleManager::RetryFromSet(int32 SetNumber)
+{
+    return RewindTo(History.FindSetStart(SetNumber), false);
+}
+
+bool ABattleManager::UndoLastAction()
+{
+    if (CurrentBattleState != EBattleState::PlayerTurn) return false;
+
+    return RewindTo(History.FindLastAction(), true);
+}
+
+bool ABattleManager::CanRetryFromSet(int32 SetNumber) const
+{
+    return !IsReplaying() && History.FindSetStart(SetNumber) != nullptr;
+}
+
+bool ABattleManager::CanUndoLastAction() const
+{
+    return !IsReplaying() && CurrentBattleState == EBattleState::PlayerTurn && History.FindLastAction() != nullptr;
+}
+
+void ABattleManager::CaptureActionSnapshot()
+{
+    // Only player actions can be undone, so enemy actions would just push them out of the ring
+    if (SimState.BattleState != EBattleState::PlayerTurn) return;
+
+    History.Capture(SimState, EBattleSnapshotKind::Action);
+}
+
+bool ABattleManager::RewindTo(const FBattleSnapshot* Snapshot, bool bDiscardSnapshot)
+{
+    if (!Snapshot || IsReplaying()) return false;
+
+    // The log carries the snapshot itself, so a replay rewinds without keeping history
+    FBattleLogEntry Entry(EBattleLogRecord::Rewind);
+    Entry.Snapshot = MakeShared<FBattleSnapshot>(*Snapshot);
+    RecordInput(Entry);
+
+    // A plan in flight was made for a timeline that no longer exists. Cached plans are keyed by
+    // state, so they stay valid.
+    CancelEnemyPlanning(false);
+    StopEnemyPhase();
+
+    BattleSim::RestoreSnapshot(SimState, *Snapshot);
+    History.DiscardAfter(Snapshot, bDiscardSnapshot);
+
+    FlushSimEvents();
+    return true;
 }
 
 void ABattleManager::StartNewSet()
 {
-    CurrentTimerRemaining = BaseTimerDuration;
-    bTFNActive = false;
-    TFNSpeedMultiplier = 1.0f;
+    if (!RecordInput(FBattleLogEntry(EBattleLogRecord::StartNewSet))) return;
 
-    StartNextUnitTurn();
-    OnBattleStateChanged(CurrentBattleState);
+    BattleSim::StartNewSet(SimState);
+    FlushSimEvents();
 }
 
 ACombatUnit* ABattleManager::GetCurrentUnit() const
 {
-    if (PlayerUnits.IsValidIndex(CurrentUnitIndex))
-    {
-        return PlayerUnits[CurrentUnitIndex];
-    }
-    return nullptr;
+    return GetUnitActor(BattleSim::GetCurrentUnit(SimState));
 }
 
 bool ABattleManager::IsPlayerTurn() const
@@ -375,6 +856,16 @@ bool ABattleManager::IsPlayerTurn() const
     return CurrentBattleState == EBattleState::PlayerTurn;
 }
 
+void ABattleManager::GetPredictedTurnOrder(TArray<ACombatUnit*>& OutUnits, int32 MaxTurns) const
+{
+    OutUnits.Reset();
+    const int32 NumTurns = FMath::Min(MaxTurns, TurnTimeline.Num());
+    for (int32 Turn = 0; Turn < NumTurns; ++Turn)
+    {
+        OutUnits.Add(GetUnitActor(TurnTimeline[Turn].Unit));
+    }
+}
+
 bool ABattleManager::IsSetComplete() const
 {
     return bIsSetComplete;
@@ -382,75 +873,349 @@ bool ABattleManager::IsSetComplete() const
 
 void ABattleManager::PauseBattle()
 {
-    CurrentBattleState = EBattleState::Paused;
-    OnBattleStateChanged(CurrentBattleState);
+    if (!RecordInput(FBattleLogEntry(EBattleLogRecord::Pause))) return;
+
+    BattleSim::PauseBattle(SimState);
+    FlushSimEvents();
 }
 
 void ABattleManager::ResumeBattle()
 {
-    CurrentBattleState = EBattleState::PlayerTurn;
-    OnBattleStateChanged(CurrentBattleState);
+    if (!RecordInput(FBattleLogEntry(EBattleLogRecord::Resume))) return;
+
+    BattleSim::ResumeBattle(SimState);
+    FlushSimEvents();
 }
 
 void ABattleManager::BeginActionAnimation()
 {
-    bIsActionAnimationPlaying = true;
+    if (!RecordInput(FBattleLogEntry(EBattleLogRecord::AnimationStarted))) return;
+
+    BattleSim::SetActionAnimationPlaying(SimState, true);
+    SyncFromSimState();
 }
 
 void ABattleManager::EndActionAnimation()
 {
-    bIsActionAnimationPlaying = false;
+    if (!RecordInput(FBattleLogEntry(EBattleLogRecord::AnimationFinished))) return;
+
+    BattleSim::SetActionAnimationPlaying(SimState, false);
+    SyncFromSimState();
+}
+
+bool ABattleManager::SaveActionLog(const FString& FilePath) const
+{
+    if (!ActionLog.IsRecording()) return false;
+
+    TArray<uint8> Bytes;
+    ActionLog.Finish(SimState.ClockTick, BattleSim::HashState(SimState), Bytes);
+    if (!FFileHelper::SaveArrayToFile(Bytes, *FilePath))
+    {
+        BATTLE_LOG(LogBattle, Error, TEXT("Failed to write battle action log to %s"), *FilePath);
+        return false;
+    }
+
+    BATTLE_LOG(LogBattle, Log, TEXT("Wrote battle action log to %s (%d bytes)"), *FilePath, Bytes.Num());
+    return true;
+}
+
+bool ABattleManager::StartReplay(const FString& FilePath)
+{
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *FilePath))
+    {
+        BATTLE_LOG(LogBattle, Error, TEXT("Could not read battle action log %s"), *FilePath);
+        return false;
+    }
+
+    CancelEnemyPlanning(false);
+    StopEnemyPhase();
+    EnemyPlanCache.Reset();
+    EnemySearchTable.Reset();
+
+    // Rebinds the actors; the log's own starting state then replaces the one built from them
+    BuildSimState();
+
+    FBattleSimState ReplayState;
+    TUniquePtr<FBattleReplay> NewReplay = MakeUnique<FBattleReplay>();
+    if (!NewReplay->Open(MoveTemp(Bytes), ReplayState, &SkillTable, &RantiRegistry))
+    {
+        BATTLE_LOG(LogBattle, Error, TEXT("%s is not a valid battle action log"), *FilePath);
+        return false;
+    }
+    if (ReplayState.Units.Num() != SimUnitActors.Num())
+    {
+        BATTLE_LOG(LogBattle, Error, TEXT("Battle action log %s has %d units but this battle has %d"),
+               *FilePath, ReplayState.Units.Num(), SimUnitActors.Num());
+        return false;
+    }
+
+    SimState = MoveTemp(ReplayState);
+    ClockAccumulator.Reset();
+    ActionLog.Reset();
+    History.Reset();
+    BattleSeed = NewReplay->GetSeed();
+    Replay = MoveTemp(NewReplay);
+
+    BATTLE_LOG(LogBattle, Log, TEXT("Replaying battle action log %s"), *FilePath);
+    FlushSimEvents();
+    return true;
+}
+
+bool ABattleManager::RecordInput(const FBattleLogEntry& Entry)
+{
+    if (Replay.IsValid()) return false;
+
+    ActionLog.Write(SimState.ClockTick, Entry);
+    return true;
+}
+
+void ABattleManager::FinishReplay()
+{
+    if (!Replay.IsValid()) return;
+
+    if (Replay->GetNumDesyncs() > 0)
+    {
+        BATTLE_LOG(LogBattle, Error, TEXT("Replay desynced %d times, first at byte %d"),
+               Replay->GetNumDesyncs(), Replay->GetFirstDesyncOffset());
+    }
+    else
+    {
+        BATTLE_LOG(LogBattle, Log, TEXT("Replay finished in sync"));
+    }
+
+    Replay.Reset();
 }
 
 void ABattleManager::InitializePlayerUnits()
 {
     // TODO: Initialize player units from level or save data
-    UE_LOG(LogTemp, Log, TEXT("Initializing player units"));
+    BATTLE_LOG(LogBattle, Log, TEXT("Initializing player units"));
 }
 
 void ABattleManager::InitializeEnemyUnits()
 {
     // TODO: Initialize enemy units from level or spawn system
-    UE_LOG(LogTemp, Log, TEXT("Initializing enemy units"));
+    BATTLE_LOG(LogBattle, Log, TEXT("Initializing enemy units"));
 }
 
 bool ABattleManager::CheckBattleEndConditions()
 {
-    // Check if all player units are defeated
-    bool bAllPlayersDefeated = true;
-    for (ACombatUnit* Unit : PlayerUnits)
+    const bool bBattleOver = BattleSim::CheckBattleEndConditions(SimState);
+    FlushSimEvents();
+    return bBattleOver;
+}
+
+int32 ABattleManager::GetSimIndex(const ACombatUnit* Unit) const
+{
+    return Unit ? SimUnitActors.IndexOfByKey(Unit) : INDEX_NONE;
+}
+
+ACombatUnit* ABattleManager::GetUnitActor(int32 SimIndex) const
+{
+    return SimUnitActors.IsValidIndex(SimIndex) ? SimUnitActors[SimIndex] : nullptr;
+}
+
+void ABattleManager::BuildSimState()
+{
+    for (ACombatUnit* Unit : SimUnitActors)
     {
-        if (Unit && Unit->IsAlive())
+        if (Unit)
         {
-            bAllPlayersDefeated = false;
-            break;
+            Unit->UnbindFromSimulation();
         }
     }
+    SimUnitActors.Reset();
 
-    if (bAllPlayersDefeated)
+    SimState = FBattleSimState();
+    SimState.Tuning.BaseTimerDuration = BaseTimerDuration;
+    SimState.CurrentTimerRemaining = BattleClock::SecondsToTimerUnits(BaseTimerDuration);
+    SimState.Skills = &SkillTable;
+    SimState.Ranti = &RantiRegistry;
+
+    auto AddUnits = [this](const TArray<ACombatUnit*>& Units, EUnitType Side)
     {
-        CurrentBattleState = EBattleState::Defeat;
-        OnBattleStateChanged(CurrentBattleState);
-        return true;
+        for (ACombatUnit* Unit : Units)
+        {
+            if (!Unit || SimUnitActors.Contains(Unit)) continue;
+
+            // The roster a unit is listed in decides its side
+            FBattleSimUnit SimUnit = Unit->MakeSimUnit();
+            SimUnit.UnitType = Side;
+
+            // Carry over EO accrued on world time and continue on the battle clock
+            SimUnit.CurrentEO = Unit->GetCurrentEO();
+            SimUnit.EOSettledTick = SimState.ClockTick;
+            SimUnit.CharacterBit = RantiRegistry.FindCharacter(Unit->CharacterId);
+
+            const int32 UnitIndex = BattleSim::AddUnit(SimState, SimUnit);
+            check(UnitIndex == SimUnitActors.Num());
+            SimUnitActors.Add(Unit);
+        }
+    };
+
+    AddUnits(PlayerUnits, EUnitType::Player);
+    AddUnits(EnemyUnits, EUnitType::Enemy);
+
+    for (int32 UnitIndex = 0; UnitIndex < SimUnitActors.Num(); ++UnitIndex)
+    {
+        SimUnitActors[UnitIndex]->BindToSimulation(&SimState, UnitIndex);
     }
 
-    // Check if all enemy units are defeated
-    bool bAllEnemiesDefeated = true;
-    for (ACombatUnit* Unit : EnemyUnits)
+    SyncFromSimState();
+}
+
+void ABattleManager::LoadSkillData()
+{
+    SkillTable.Entries.Reset();
+    LoadedSkillDatabase = SkillDatabase.LoadSynchronous();
+    if (LoadedSkillDatabase)
+    {
+        LoadedSkillDatabase->LoadTable(SkillTable);
+    }
+
+    RantiRegistry.Reset();
+    LoadedRantiDatabase = RantiDatabase.LoadSynchronous();
+    if (LoadedRantiDatabase)
     {
-        if (Unit && Unit->IsAlive())
+        LoadedRantiDatabase->BuildRegistry(RantiRegistry, LoadedSkillDatabase);
+    }
+}
+
+void ABattleManager::SyncFromSimState()
+{
+    CurrentBattleState = SimState.BattleState;
+    CurrentUnitIndex = SimState.CurrentUnitIndex;
+    CurrentSetNumber = SimState.CurrentSetNumber;
+    bIsSetComplete = SimState.bIsSetComplete;
+    CurrentTimerRemaining = BattleClock::TimerUnitsToSeconds(BattleSim::GetTimerRemaining(SimState));
+    bTFNActive = SimState.bTFNActive;
+    TFNSpeedMultiplier = BattleClock::RateToMultiplier(SimState.TFNRate);
+    bIsActionAnimationPlaying = SimState.bIsActionAnimationPlaying;
+
+    for (ACombatUnit* Unit : SimUnitActors)
+    {
+        if (Unit)
         {
-            bAllEnemiesDefeated = false;
-            break;
+            Unit->RefreshFromSimUnit();
         }
     }
 
-    if (bAllEnemiesDefeated)
+    SyncUnitPositions();
+    TurnTimeline.Update(SimState);
+    HUDViewModel->Refresh(*this);
+}
+
+void ABattleManager::SyncUnitPositions()
+{
+    const UBattleWorldSubsystem* Battles = UBattleWorldSubsystem::Get(this);
+    APositionManager* Positions = Battles ? Battles->GetPositionManager(BattleHandle) : nullptr;
+    if (!Positions) return;
+
+    // Slots already at the right position return at once, so this only costs anything after a move
+    const int32 NumUnits = FMath::Min(SimUnitActors.Num(), SimState.Units.Num());
+    for (int32 UnitIndex = 0; UnitIndex < NumUnits; ++UnitIndex)
+    {
+        Positions->PlaceUnit(SimUnitActors[UnitIndex], SimState.Units.Position[UnitIndex]);
+    }
+}
+
+void ABattleManager::FlushSimEvents()
+{
+    SyncFromSimState();
+
+    if (SimState.Events.Num() == 0) return;
+
+    // Blueprint handlers may call back into the manager, which queues and flushes its own events
+    TArray<FBattleSimEvent> Events = MoveTemp(SimState.Events);
+    SimState.Events.Reset();
+    BattleTrace::RecordEvents(BattleHandle.Index, SimState, Events);
+
+    // Taken before any handler can act in the new set
+    if (!IsReplaying() && Events.ContainsByPredicate([](const FBattleSimEvent& Event) { return Event.Type == EBattleSimEventType::SetStarted; }))
     {
-        CurrentBattleState = EBattleState::Victory;
-        OnBattleStateChanged(CurrentBattleState);
-        return true;
+        History.Capture(SimState, EBattleSnapshotKind::SetStart);
+
+        // One hash per set lets a desynced replay report roughly where it went wrong
+        FBattleLogEntry Checkpoint(EBattleLogRecord::Checkpoint);
+        Checkpoint.Hash = BattleSim::HashState(SimState);
+        RecordInput(Checkpoint);
     }
 
-    return false;
-}
\ No newline at end of file
+    bool bEnemyTurnStarted = false;
+    for (const FBattleSimEvent& Event : Events)
+    {
+        ACombatUnit* Unit = GetUnitActor(Event.Unit);
+        ACombatUnit* OtherUnit = GetUnitActor(Event.OtherUnit);
+        const TCHAR* UnitName = Unit ? *Unit->UnitName : TEXT("Unknown");
+
+        switch (Event.Type)
+        {
+            case EBattleSimEventType::BattleStateChanged:
+                OnBattleStateChanged((EBattleState)(uint8)Event.Value);
+                break;
+            case EBattleSimEventType::UnitTurnStarted:
+                OnUnitTurnStarted(Unit);
+                break;
+            case EBattleSimEventType::UnitTurnEnded:
+                OnUnitTurnEnded(Unit);
+                break;
+            case EBattleSimEventType::SetComplete:
+                OnSetComplete();
+                break;
+            case EBattleSimEventType::EnemyTurnStarted:
+                OnEnemyTurnStarted();
+                BATTLE_LOG(LogBattle, Warning, TEXT("Enemy turn started!"));
+                bEnemyTurnStarted = true;
+                break;
+            case EBattleSimEventType::UnitMoved:
+                BATTLE_LOG(LogBattleUnits, Verbose, TEXT("%s moved to position %d"), UnitName, (int32)Event.Value);
+                break;
+            case EBattleSimEventType::UnitDefeated:
+                BATTLE_LOG(LogBattleCombat, Error, TEXT("%s has been defeated!"), UnitName);
+                break;
+            case EBattleSimEventType::WeaknessHit:
+                BATTLE_LOG(LogBattleCombat, Warning, TEXT("Weakness hit! %s gained %f SP, TFN applied to next unit"),
+                       OtherUnit ? *OtherUnit->UnitName : TEXT("Unknown"), SimState.Tuning.WeaknessSPGain);
+                break;
+            case EBattleSimEventType::TFNApplied:
+                BATTLE_LOG(LogBattleUnits, Verbose, TEXT("%s timer speed set to %f"), UnitName, Event.Value);
+                break;
+            case EBattleSimEventType::StockpileGained:
+                BATTLE_LOG(LogBattleUnits, Verbose, TEXT("%s gained %f stockpiled time (Total: %f)"), UnitName, Event.Value, Unit ? Unit->StockpiledTime : 0.0f);
+                break;
+            case EBattleSimEventType::EOTransformed:
+                BATTLE_LOG(LogBattleUnits, Warning, TEXT("%s transformed into EO form!"), UnitName);
+                break;
+            case EBattleSimEventType::SkillUsed:
+                BATTLE_LOG(LogBattleCombat, Log, TEXT("%s used skill: %s"), UnitName,
+                       LoadedSkillDatabase ? *LoadedSkillDatabase->GetSkillId((int32)Event.Value).ToString() : TEXT("Unknown"));
+                break;
+            case EBattleSimEventType::RantiUsed:
+                BATTLE_LOG(LogBattleCombat, Log, TEXT("%s led Ranti combo %d"), UnitName, (int32)Event.Value);
+                break;
+            case EBattleSimEventType::EOFormExited:
+                if (Event.Value != 0.0f)
+                {
+                    BATTLE_LOG(LogBattleUnits, Error, TEXT("%s was forced out of EO form and is now Stressed Out!"), UnitName);
+                }
+                else
+                {
+                    BATTLE_LOG(LogBattleUnits, Log, TEXT("%s exited EO form normally"), UnitName);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Enemy phase runs after the state change has been broadcast
+    if (bEnemyTurnStarted && CurrentBattleState == EBattleState::EnemyTurn)
+    {
+        RunEnemyPhase();
+    }
+    else if (CurrentBattleState == EBattleState::PlayerTurn)
+    {
+        SpeculateEnemyPlan();
+    }
+}
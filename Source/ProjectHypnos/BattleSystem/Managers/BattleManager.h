@@ -5,28 +5,19 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "../Units/CombatUnit.h"
+#include "../Simulation/EnemyPlanner.h"
+#include "../Simulation/EnemySearch.h"
+#include "../Simulation/BattleActionLog.h"
+#include "../Simulation/BattleReplay.h"
+#include "../Simulation/BattleSnapshot.h"
+#include "../Simulation/TurnTimeline.h"
+#include "BattleWorldSubsystem.h"
+#include "Async/Future.h"
 #include "BattleManager.generated.h"
 
-UENUM(BlueprintType)
-enum class EBattleState : uint8
-{
-    PlayerTurn,
-    EnemyTurn,
-    Victory,
-    Defeat,
-    Paused
-};
-
-UENUM(BlueprintType)
-enum class EActionType : uint8
-{
-    Move,
-    Attack,
-    Skill,
-    Item,
-    Pass,
-    Ranti
-};
+class USkillDatabase;
+class URantiDatabase;
+class UBattleHUDViewModel;
 
 USTRUCT(BlueprintType)
 struct FBattleAction
@@ -46,7 +37,10 @@ struct FBattleAction
     ACombatUnit* TargetUnit;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Action")
-    FString SkillName;
+    FName SkillId;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Action")
+    EElementalType Element;
 
     FBattleAction()
     {
@@ -54,7 +48,8 @@ struct FBattleAction
         ActionType = EActionType::Pass;
         TargetPosition = EBattlePosition::West;
         TargetUnit = nullptr;
-        SkillName = "";
+        SkillId = NAME_None;
+        Element = EElementalType::Physical;
     }
 };
 
@@ -66,8 +61,16 @@ class PROJECTHYPNOS_API ABattleManager : public AActor
 public:
     ABattleManager();
 
+    virtual void PostInitializeComponents() override;
     virtual void BeginPlay() override;
-    virtual void Tick(float DeltaTime) override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    // Advances the battle by one frame. Driven by UBattleWorldSubsystem rather than an actor tick.
+    void TickBattle(float DeltaTime);
+
+    // Managers and units with the same ID form one battle
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Battle")
+    FName BattleId;
 
     // Battle State
     UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Combat")
@@ -104,9 +107,29 @@ public:
     UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Combat")
     float TFNSpeedMultiplier = 1.0f;
 
-    // Ranti Skills
+    // Skills, compiled into a table that is loaded once when the battle begins
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combat")
+    TSoftObjectPtr<USkillDatabase> SkillDatabase;
+
+    // Enemy AI. Harder settings search further ahead.
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
-    TArray<FString> AvailableRantiSkills;
+    EEnemyAIDifficulty EnemyDifficulty = EEnemyAIDifficulty::Normal;
+
+    // Seconds the enemy may plan per turn. Zero uses the difficulty's default.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (ClampMin = "0.0"))
+    float EnemyPlanningBudget = 0.0f;
+
+    // Seconds a boss may search per turn. Bosses look ahead over every defense outcome instead of sampling.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (ClampMin = "0.0"))
+    float BossSearchBudget = 0.05f;
+
+    // Ranti combos, compiled to party bitmasks when the battle begins
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combat")
+    TSoftObjectPtr<URantiDatabase> RantiDatabase;
+
+    // Records every input into an action log that SaveActionLog writes out for replays
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|Replay")
+    bool bRecordActionLog = true;
 
     // Events
     UFUNCTION(BlueprintImplementableEvent, Category = "Combat")
@@ -124,6 +147,19 @@ public:
     UFUNCTION(BlueprintImplementableEvent, Category = "Combat")
     void OnEnemyTurnStarted();
 
+    // Carries out one planned enemy action. The planner scores attacks as hits the target defends,
+    // so an override plays the attack, lets the player defend and resolves the hit through
+    // ADefenseManager::ProcessDefenseAttempt, then calls ContinueEnemyPhase; the next action waits
+    // until then. ExecuteAction would land the hit undefended. The default resolves at once, with
+    // the target defending the way the planner's rollouts assume.
+    UFUNCTION(BlueprintNativeEvent, Category = "Combat")
+    void ExecuteEnemyAction(const FBattleAction& Action);
+
+    // Marks the enemy action in progress as finished. The next one starts on the following tick,
+    // and the enemy turn ends after the last.
+    UFUNCTION(BlueprintCallable, Category = "Combat")
+    void ContinueEnemyPhase();
+
     // Core Functions
     UFUNCTION(BlueprintCallable, Category = "Combat")
     void StartBattle();
@@ -137,20 +173,61 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Combat")
     void RetryBattle();
 
+    // Puts the battle back to the start of SetNumber. Only the most recent sets are kept; returns
+    // false if SetNumber is no longer available.
+    UFUNCTION(BlueprintCallable, Category = "Combat")
+    bool RetryFromSet(int32 SetNumber);
+
+    // Takes back the last player action of the current set. Can be repeated back to the set start.
+    UFUNCTION(BlueprintCallable, Category = "Combat")
+    bool UndoLastAction();
+
+    UFUNCTION(BlueprintPure, Category = "Combat")
+    bool CanRetryFromSet(int32 SetNumber) const;
+
+    UFUNCTION(BlueprintPure, Category = "Combat")
+    bool CanUndoLastAction() const;
+
     UFUNCTION(BlueprintCallable, Category = "Combat")
     void ExecuteAction(const FBattleAction& Action);
 
     UFUNCTION(BlueprintCallable, Category = "Combat")
     void MoveUnit(ACombatUnit* Unit, EBattlePosition NewPosition);
 
+    UFUNCTION(BlueprintCallable, Category = "Combat")
+    void TransformToEO(ACombatUnit* Unit);
+
     UFUNCTION(BlueprintCallable, Category = "Combat")
     void AttackUnit(ACombatUnit* Attacker, ACombatUnit* Target, EElementalType ElementType = EElementalType::Physical);
 
+    // One attack landing on several targets (AoE). Weakness SP/TFN is granted once for the whole hit.
+    UFUNCTION(BlueprintCallable, Category = "Combat")
+    void AttackUnits(ACombatUnit* Attacker, const TArray<ACombatUnit*>& Targets, EElementalType ElementType = EElementalType::Physical);
+
+    // Queues one hit for the damage pipeline. Queued hits resolve together at the end of the frame,
+    // or sooner through ResolvePendingDamage, so multi-hit skills and combos flush events once.
+    UFUNCTION(BlueprintCallable, Category = "Combat")
+    void QueueAttack(ACombatUnit* Attacker, ACombatUnit* Target, EElementalType ElementType = EElementalType::Physical, float Damage = -1.0f);
+
+    UFUNCTION(BlueprintCallable, Category = "Combat")
+    void ResolvePendingDamage();
+
+    // Defended hit: damage, EO reward and any counter resolve as one batch using the given tuning
+    EDefenseResult ResolveDefense(ACombatUnit* Defender, ACombatUnit* Attacker, EDefenseType DefenseType, float TimingAccuracy, float Damage, const FBattleSimDefenseTuning& DefenseTuning);
+
     UFUNCTION(BlueprintCallable, Category = "Combat")
-    void UseSkill(ACombatUnit* Caster, const FString& SkillName, ACombatUnit* Target = nullptr);
+    void UseSkill(ACombatUnit* Caster, FName SkillId, ACombatUnit* Target = nullptr);
+
+    // The combo declares its own party requirements; Initiator must be one of its members
+    UFUNCTION(BlueprintCallable, Category = "Combat")
+    void UseRantiSkill(FName ComboId, ACombatUnit* Initiator, ACombatUnit* Target = nullptr);
+
+    // True if any combo that includes Unit can be used right now
+    UFUNCTION(BlueprintPure, Category = "Combat")
+    bool IsAnyRantiAvailable(const ACombatUnit* Unit) const;
 
     UFUNCTION(BlueprintCallable, Category = "Combat")
-    void UseRantiSkill(const FString& SkillName, TArray<ACombatUnit*> RequiredUnits);
+    void GetAvailableRantiCombos(const ACombatUnit* Unit, TArray<FName>& OutComboIds) const;
 
     // TFN/SP System
     UFUNCTION(BlueprintCallable, Category = "Combat")
@@ -179,6 +256,10 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Combat")
     bool IsPlayerTurn() const;
 
+    // Units of the coming player turns, running turn first, through the next set. Assumes every turn runs its timer out.
+    UFUNCTION(BlueprintCallable, Category = "Combat")
+    void GetPredictedTurnOrder(TArray<ACombatUnit*>& OutUnits, int32 MaxTurns = 8) const;
+
     UFUNCTION(BlueprintCallable, Category = "Combat")
     bool IsSetComplete() const;
 
@@ -195,6 +276,21 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Combat")
     void EndActionAnimation();
 
+    // Writes the current battle's action log. Returns false if nothing was recorded or the write failed.
+    UFUNCTION(BlueprintCallable, Category = "Combat|Replay")
+    bool SaveActionLog(const FString& FilePath) const;
+
+    // Plays a saved log back at real time. The roster must match the one the log was recorded with;
+    // inputs are ignored until the replay ends or StartBattle is called.
+    UFUNCTION(BlueprintCallable, Category = "Combat|Replay")
+    bool StartReplay(const FString& FilePath);
+
+    UFUNCTION(BlueprintPure, Category = "Combat|Replay")
+    bool IsReplaying() const { return Replay.IsValid(); }
+
+    // What the HUD shows, refreshed as the battle moves. Widgets bind to its OnChanged instead of polling.
+    UBattleHUDViewModel* GetHUDViewModel() const { return HUDViewModel; }
+
 protected:
     void InitializePlayerUnits();
     void InitializeEnemyUnits();
@@ -205,4 +301,127 @@ protected:
     // If true, the current unit's timer should not tick (e.g., during attack/skill animations)
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat")
     bool bIsActionAnimationPlaying = false;
+
+public:
+    // Rules state driven by this actor. The properties above and the bound units are views over it.
+    const FBattleSimState& GetSimState() const { return SimState; }
+
+    // Predicted turns, brought up to date on every sync
+    const FTurnTimeline& GetTurnTimeline() const { return TurnTimeline; }
+
+    // Index of Unit in the simulation state, or INDEX_NONE if it is not part of this battle
+    int32 GetSimIndex(const ACombatUnit* Unit) const;
+    ACombatUnit* GetUnitActor(int32 SimIndex) const;
+
+    // Places every unit in the position manager's slots where the simulation has it
+    void SyncUnitPositions();
+
+protected:
+    // Rebuilds the simulation from PlayerUnits/EnemyUnits and binds the unit actors to it
+    void BuildSimState();
+
+    // Copies simulation state back into the Blueprint-visible properties
+    void SyncFromSimState();
+
+    // Refreshes views and forwards queued simulation events to the Blueprint events
+    void FlushSimEvents();
+
+    // Adds Entry to the action log at the current tick. Returns false while a replay drives the
+    // battle, in which case the caller drops the input.
+    bool RecordInput(const FBattleLogEntry& Entry);
+
+    // Logs how a replay ended and hands the battle back to input
+    void FinishReplay();
+
+    // Snapshots the state before a player unit acts, so UndoLastAction can take the action back
+    void CaptureActionSnapshot();
+
+    // Restores Snapshot from History and drops everything newer, Snapshot too if bDiscardSnapshot
+    bool RewindTo(const FBattleSnapshot* Snapshot, bool bDiscardSnapshot);
+
+    // Commits a plan made during the player phase if one matches, otherwise plans now on a worker
+    // thread and Tick commits the plan when it is ready
+    void RunEnemyPhase();
+    void CommitEnemyPlan(const FEnemyPlan& Plan);
+
+    // Starts the committed plan's next action, or ends the enemy turn after the last one
+    void AdvanceEnemyPhase();
+    void StopEnemyPhase();
+
+    // Plans the enemy phase that would follow the current state, while the player phase runs
+    void SpeculateEnemyPlan();
+
+    void StartEnemyPlanning(const FBattleSimState& PlanningState, uint64 PlanningHash, bool bCommitWhenReady);
+    void CancelEnemyPlanning(bool bWaitForWorker);
+
+    // True if any enemy in the battle is a boss
+    bool HasBossEnemy() const;
+
+    // Loads SkillDatabase and copies its compiled table into SkillTable, then compiles RantiRegistry
+    void LoadSkillData();
+
+    // Ranti bit of Unit's character, as a mask. Zero if no combo uses the character.
+    uint64 GetRantiCharacterMask(const ACombatUnit* Unit) const;
+
+    FBattleSimState SimState;
+
+    // Referenced by SimState.Skills and SimState.Ranti
+    FSkillTable SkillTable;
+    FRantiRegistry RantiRegistry;
+
+    UPROPERTY(Transient)
+    USkillDatabase* LoadedSkillDatabase = nullptr;
+
+    UPROPERTY(Transient)
+    URantiDatabase* LoadedRantiDatabase = nullptr;
+
+    // Plan being computed on a worker, and the planning hash of the state it was started from
+    TFuture<FEnemyPlan> PendingEnemyPlan;
+    TSharedPtr<std::atomic<bool>, ESPMode::ThreadSafe> EnemyPlanCancel;
+    uint64 PendingPlanHash = 0;
+    bool bCommitPendingPlan = false;
+
+    // Plan the enemy phase is playing out. NextEnemyAction is INDEX_NONE when no phase is running.
+    FEnemyPlan ActiveEnemyPlan;
+    int32 NextEnemyAction = INDEX_NONE;
+    bool bEnemyActionInProgress = false;
+
+    // Defenses the default ExecuteEnemyAction picks. Reseeded for each plan; the log records the picks.
+    FRandomStream EnemyDefenseStream;
+
+    // Cancelled plans whose workers have not returned yet. They still read SkillTable and
+    // RantiRegistry, so EndPlay waits for them too.
+    TArray<TFuture<FEnemyPlan>> CancelledEnemyPlans;
+
+    // Shared by every boss search this battle, so later turns start from what earlier ones found
+    TSharedPtr<FTranspositionTable, ESPMode::ThreadSafe> EnemySearchTable;
+
+    // Finished plans by BattleSim::HashPlanningState
+    static constexpr int32 MaxCachedEnemyPlans = 32;
+    TMap<uint64, FEnemyPlan> EnemyPlanCache;
+
+    // Converts frame time into fixed simulation ticks
+    FBattleClockAccumulator ClockAccumulator;
+
+    // Chosen each StartBattle and mixed into the planner seeds, so it is the only randomness a log needs
+    uint32 BattleSeed = 0;
+
+    FBattleActionLog ActionLog;
+
+    // Set while a saved log drives the battle instead of input
+    TUniquePtr<FBattleReplay> Replay;
+
+    // Recent set starts and actions of the current attempt, for RetryFromSet and UndoLastAction
+    FBattleSnapshotRing History;
+
+    FTurnTimeline TurnTimeline;
+
+    FBattleHandle BattleHandle;
+
+    UPROPERTY(Transient)
+    UBattleHUDViewModel* HUDViewModel = nullptr;
+
+    // Simulation unit index -> actor
+    UPROPERTY(Transient)
+    TArray<ACombatUnit*> SimUnitActors;
 };
\ No newline at end of file
@@ -0,0 +1,164 @@
+// BattleWorldSubsystem.cpp
+#include "BattleWorldSubsystem.h"
+#include "BattleManager.h"
+#include "DefenseManager.h"
+#include "PositionManager.h"
+#include "../Units/CombatUnit.h"
+#include "../BattleLog.h"
+#include "Engine/World.h"
+
+UBattleWorldSubsystem* UBattleWorldSubsystem::Get(const UObject* WorldContextObject)
+{
+    const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+    return World ? World->GetSubsystem<UBattleWorldSubsystem>() : nullptr;
+}
+
+void UBattleWorldSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    // By index: a battle's events may spawn actors that register new battles
+    for (int32 Index = 0; Index < Battles.Num(); ++Index)
+    {
+        ABattleManager* Manager = Battles[Index].BattleManager.Get();
+        if (Manager && Manager->HasActorBegunPlay())
+        {
+            Manager->TickBattle(DeltaTime);
+        }
+    }
+}
+
+TStatId UBattleWorldSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UBattleWorldSubsystem, STATGROUP_Tickables);
+}
+
+FBattleHandle UBattleWorldSubsystem::FindOrAddBattle(FName BattleId)
+{
+    FBattleHandle Handle;
+    if (const int32* Index = BattleIndices.Find(BattleId))
+    {
+        Handle.Index = *Index;
+        return Handle;
+    }
+
+    Handle.Index = Battles.AddDefaulted();
+    Battles[Handle.Index].BattleId = BattleId;
+    BattleIndices.Add(BattleId, Handle.Index);
+    return Handle;
+}
+
+const UBattleWorldSubsystem::FBattleEntry* UBattleWorldSubsystem::GetEntry(FBattleHandle Handle) const
+{
+    return Battles.IsValidIndex(Handle.Index) ? &Battles[Handle.Index] : nullptr;
+}
+
+FBattleHandle UBattleWorldSubsystem::Register(ABattleManager* Manager, FName BattleId)
+{
+    const FBattleHandle Handle = FindOrAddBattle(BattleId);
+    FBattleEntry& Entry = Battles[Handle.Index];
+    if (Entry.BattleManager.IsValid() && Entry.BattleManager.Get() != Manager)
+    {
+        BATTLE_LOG(LogBattle, Warning, TEXT("Battle '%s' already has a battle manager; %s replaces it"), *BattleId.ToString(), *GetNameSafe(Manager));
+    }
+    Entry.BattleManager = Manager;
+    return Handle;
+}
+
+FBattleHandle UBattleWorldSubsystem::Register(ADefenseManager* Manager, FName BattleId)
+{
+    const FBattleHandle Handle = FindOrAddBattle(BattleId);
+    FBattleEntry& Entry = Battles[Handle.Index];
+    if (Entry.DefenseManager.IsValid() && Entry.DefenseManager.Get() != Manager)
+    {
+        BATTLE_LOG(LogBattle, Warning, TEXT("Battle '%s' already has a defense manager; %s replaces it"), *BattleId.ToString(), *GetNameSafe(Manager));
+    }
+    Entry.DefenseManager = Manager;
+    return Handle;
+}
+
+FBattleHandle UBattleWorldSubsystem::Register(APositionManager* Manager, FName BattleId)
+{
+    const FBattleHandle Handle = FindOrAddBattle(BattleId);
+    FBattleEntry& Entry = Battles[Handle.Index];
+    if (Entry.PositionManager.IsValid() && Entry.PositionManager.Get() != Manager)
+    {
+        BATTLE_LOG(LogBattle, Warning, TEXT("Battle '%s' already has a position manager; %s replaces it"), *BattleId.ToString(), *GetNameSafe(Manager));
+    }
+    Entry.PositionManager = Manager;
+    return Handle;
+}
+
+FBattleHandle UBattleWorldSubsystem::Register(ACombatUnit* Unit, FName BattleId)
+{
+    const FBattleHandle Handle = FindOrAddBattle(BattleId);
+    Battles[Handle.Index].Units.AddUnique(Unit);
+    return Handle;
+}
+
+void UBattleWorldSubsystem::Unregister(const AActor* Actor, FBattleHandle Handle)
+{
+    if (!Actor || !Battles.IsValidIndex(Handle.Index)) return;
+
+    FBattleEntry& Entry = Battles[Handle.Index];
+    if (Entry.BattleManager.Get() == Actor)
+    {
+        Entry.BattleManager.Reset();
+    }
+    else if (Entry.DefenseManager.Get() == Actor)
+    {
+        Entry.DefenseManager.Reset();
+    }
+    else if (Entry.PositionManager.Get() == Actor)
+    {
+        Entry.PositionManager.Reset();
+    }
+    else
+    {
+        Entry.Units.RemoveAll([Actor](const TWeakObjectPtr<ACombatUnit>& Unit) { return Unit.Get() == Actor || !Unit.IsValid(); });
+    }
+}
+
+FBattleHandle UBattleWorldSubsystem::FindBattle(FName BattleId) const
+{
+    FBattleHandle Handle;
+    if (const int32* Index = BattleIndices.Find(BattleId))
+    {
+        Handle.Index = *Index;
+    }
+    return Handle;
+}
+
+ABattleManager* UBattleWorldSubsystem::GetBattleManager(FBattleHandle Handle) const
+{
+    const FBattleEntry* Entry = GetEntry(Handle);
+    return Entry ? Entry->BattleManager.Get() : nullptr;
+}
+
+ADefenseManager* UBattleWorldSubsystem::GetDefenseManager(FBattleHandle Handle) const
+{
+    const FBattleEntry* Entry = GetEntry(Handle);
+    return Entry ? Entry->DefenseManager.Get() : nullptr;
+}
+
+APositionManager* UBattleWorldSubsystem::GetPositionManager(FBattleHandle Handle) const
+{
+    const FBattleEntry* Entry = GetEntry(Handle);
+    return Entry ? Entry->PositionManager.Get() : nullptr;
+}
+
+TArray<ACombatUnit*> UBattleWorldSubsystem::GetUnits(FBattleHandle Handle) const
+{
+    TArray<ACombatUnit*> Units;
+    if (const FBattleEntry* Entry = GetEntry(Handle))
+    {
+        for (const TWeakObjectPtr<ACombatUnit>& Unit : Entry->Units)
+        {
+            if (ACombatUnit* Live = Unit.Get())
+            {
+                Units.Add(Live);
+            }
+        }
+    }
+    return Units;
+}
@@ -0,0 +1,86 @@
+// BattleWorldSubsystem.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "BattleWorldSubsystem.generated.h"
+
+class ABattleManager;
+class ADefenseManager;
+class APositionManager;
+class ACombatUnit;
+
+// One battle registered with UBattleWorldSubsystem. Stays valid for the life of the world.
+USTRUCT(BlueprintType)
+struct FBattleHandle
+{
+    GENERATED_BODY()
+
+    int32 Index = INDEX_NONE;
+
+    bool IsValid() const { return Index != INDEX_NONE; }
+};
+
+/**
+ * Registry of the battles in a world. Managers and units register under their BattleId from
+ * PostInitializeComponents, which runs before any BeginPlay, and keep the handle they get back.
+ * Lookups through a handle are an array index, so nothing walks the world's actor list, and
+ * battles with different IDs can share a world.
+ *
+ * Also the only thing in the battle system that ticks: each frame it advances every battle in
+ * registration order, so no manager or unit needs a tick function of its own.
+ */
+UCLASS()
+class PROJECTHYPNOS_API UBattleWorldSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // Null outside a game world
+    static UBattleWorldSubsystem* Get(const UObject* WorldContextObject);
+
+    FBattleHandle Register(ABattleManager* Manager, FName BattleId);
+    FBattleHandle Register(ADefenseManager* Manager, FName BattleId);
+    FBattleHandle Register(APositionManager* Manager, FName BattleId);
+    FBattleHandle Register(ACombatUnit* Unit, FName BattleId);
+
+    // Clears Actor from whichever slot of Handle's battle it holds
+    void Unregister(const AActor* Actor, FBattleHandle Handle);
+
+    // Invalid if nothing has registered under BattleId yet
+    UFUNCTION(BlueprintPure, Category = "Battle")
+    FBattleHandle FindBattle(FName BattleId) const;
+
+    UFUNCTION(BlueprintPure, Category = "Battle")
+    ABattleManager* GetBattleManager(FBattleHandle Handle) const;
+
+    UFUNCTION(BlueprintPure, Category = "Battle")
+    ADefenseManager* GetDefenseManager(FBattleHandle Handle) const;
+
+    UFUNCTION(BlueprintPure, Category = "Battle")
+    APositionManager* GetPositionManager(FBattleHandle Handle) const;
+
+    // Every live unit registered with the battle, in registration order
+    UFUNCTION(BlueprintPure, Category = "Battle")
+    TArray<ACombatUnit*> GetUnits(FBattleHandle Handle) const;
+
+private:
+    struct FBattleEntry
+    {
+        FName BattleId;
+        TWeakObjectPtr<ABattleManager> BattleManager;
+        TWeakObjectPtr<ADefenseManager> DefenseManager;
+        TWeakObjectPtr<APositionManager> PositionManager;
+        TArray<TWeakObjectPtr<ACombatUnit>> Units;
+    };
+
+    FBattleHandle FindOrAddBattle(FName BattleId);
+    const FBattleEntry* GetEntry(FBattleHandle Handle) const;
+
+    TArray<FBattleEntry> Battles;
+    TMap<FName, int32> BattleIndices;
+};
@@ -2,11 +2,22 @@
 #include "DefenseManager.h"
 #include "PositionManager.h"
 #include "BattleManager.h"
-#include "Kismet/GameplayStatics.h"
+#include "../Simulation/BattleSimRules.h"
+#include "../BattleLog.h"
 
 ADefenseManager::ADefenseManager()
 {
-    PrimaryActorTick.bCanEverTick = true;
+    PrimaryActorTick.bCanEverTick = false;
+}
+
+void ADefenseManager::PostInitializeComponents()
+{
+    Super::PostInitializeComponents();
+
+    if (UBattleWorldSubsystem* Battles = UBattleWorldSubsystem::Get(this))
+    {
+        BattleHandle = Battles->Register(this, BattleId);
+    }
 }
 
 void ADefenseManager::BeginPlay()
@@ -15,54 +26,55 @@ void ADefenseManager::BeginPlay()
     InitializeManagers();
 }
 
-void ADefenseManager::Tick(float DeltaTime)
+void ADefenseManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-    Super::Tick(DeltaTime);
+    if (UBattleWorldSubsystem* Battles = UBattleWorldSubsystem::Get(this))
+    {
+        Battles->Unregister(this, BattleHandle);
+    }
+
+    Super::EndPlay(EndPlayReason);
 }
 
 void ADefenseManager::InitializeManagers()
 {
-    // Find the position manager in the world
-    TArray<AActor*> FoundActors;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), APositionManager::StaticClass(), FoundActors);
-    if (FoundActors.Num() > 0)
-    {
-        PositionManager = Cast<APositionManager>(FoundActors[0]);
-    }
+    // Every manager in the level registered before any BeginPlay ran
+    UBattleWorldSubsystem* Battles = UBattleWorldSubsystem::Get(this);
+    if (!Battles) return;
 
-    // Find the battle manager in the world
-    FoundActors.Empty();
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABattleManager::StaticClass(), FoundActors);
-    if (FoundActors.Num() > 0)
+    PositionManager = Battles->GetPositionManager(BattleHandle);
+    BattleManager = Battles->GetBattleManager(BattleHandle);
+}
+
+const FDefenseOptions& ADefenseManager::GetDefenseOptions(EBattlePosition Position) const
+{
+    // The battle's own formation, so prompts offer exactly the defenses it will resolve
+    if (BattleManager)
     {
-        BattleManager = Cast<ABattleManager>(FoundActors[0]);
+        return BattleSim::GetDefenseOptions(BattleManager->GetSimState().Formation, Position);
     }
+    return BattleSim::GetDefenseOptions(PositionManager ? PositionManager->GetFormation() : 0, Position);
 }
 
 bool ADefenseManager::CanUseGuard(EBattlePosition Position) const
 {
     if (!PositionManager) return false;
-    
-    // Guard can only be used when multiple units are in the same position
-    int32 UnitCount = PositionManager->GetUnitCountAtPosition(Position);
-    return UnitCount >= 2;
+
+    return GetDefenseOptions(Position).IsAvailable(EDefenseType::Guard);
 }
 
 bool ADefenseManager::CanUseParry(EBattlePosition Position) const
 {
     if (!PositionManager) return false;
-    
-    // Parry can only be used when a single unit is alone in a position
-    int32 UnitCount = PositionManager->GetUnitCountAtPosition(Position);
-    return UnitCount == 1;
+
+    return GetDefenseOptions(Position).IsAvailable(EDefenseType::Parry);
 }
 
 bool ADefenseManager::CanUseDodge(EBattlePosition Position) const
 {
     if (!PositionManager) return false;
-    
-    // Dodge can be used in any position
-    return true;
+
+    return GetDefenseOptions(Position).IsAvailable(EDefenseType::Dodge);
 }
 
 FDefenseAttempt ADefenseManager::AttemptGuard(ACombatUnit* Unit, float TimingAccuracy)
@@ -75,7 +87,11 @@ FDefenseAttempt ADefenseManager::AttemptGuard(ACombatUnit* Unit, float TimingAcc
 
     if (Unit)
     {
-        Unit->SetDefenseType(EDefenseType::Guard);
+        // A unit in a battle takes its stance when ProcessDefenseAttempt resolves the defense
+        if (!Unit->IsBoundToSimulation())
+        {
+            Unit->SetDefenseType(EDefenseType::Guard);
+        }
         OnDefenseSuccess(Unit, EDefenseType::Guard);
     }
 
@@ -93,7 +109,10 @@ FDefenseAttempt ADefenseManager::AttemptDodge(ACombatUnit* Unit, float TimingAcc
 
     if (Unit)
     {
-        Unit->SetDefenseType(EDefenseType::Dodge);
+        if (!Unit->IsBoundToSimulation())
+        {
+            Unit->SetDefenseType(EDefenseType::Dodge);
+        }
         
         if (Attempt.Result == EDefenseResult::Success || Attempt.Result == EDefenseResult::Partial)
         {
@@ -119,7 +138,10 @@ FDefenseAttempt ADefenseManager::AttemptParry(ACombatUnit* Unit, float TimingAcc
 
     if (Unit)
     {
-        Unit->SetDefenseType(EDefenseType::Parry);
+        if (!Unit->IsBoundToSimulation())
+        {
+            Unit->SetDefenseType(EDefenseType::Parry);
+        }
         
         if (Attempt.Result == EDefenseResult::Success || Attempt.Result == EDefenseResult::Counter)
         {
@@ -137,117 +159,27 @@ FDefenseAttempt ADefenseManager::AttemptParry(ACombatUnit* Unit, float TimingAcc
 
 float ADefenseManager::CalculateDamageReduction(const FDefenseAttempt& Attempt) const
 {
-    switch (Attempt.DefenseType)
-    {
-        case EDefenseType::Guard:
-            return GuardDamageReduction;
-            
-        case EDefenseType::Dodge:
-            if (Attempt.Result == EDefenseResult::Success)
-                return DodgeDamageReduction;
-            else if (Attempt.Result == EDefenseResult::Partial)
-                return DodgeDamageReduction * 0.5f; // Partial dodge
-            else
-                return 0.0f; // Failed dodge
-            
-        case EDefenseType::Parry:
-            if (Attempt.Result == EDefenseResult::Success || Attempt.Result == EDefenseResult::Counter)
-                return ParryDamageReduction;
-            else
-                return 0.0f; // Failed parry
-            
-        default:
-            return 0.0f;
-    }
+    return BattleSim::CalculateDamageReduction(MakeDefenseTuning(), Attempt.DefenseType, Attempt.Result);
 }
 
 float ADefenseManager::CalculateEOGain(const FDefenseAttempt& Attempt) const
 {
-    float BaseEOGain = 0.0f;
-    
-    switch (Attempt.DefenseType)
-    {
-        case EDefenseType::Guard:
-            BaseEOGain = GuardEOGain;
-            break;
-        case EDefenseType::Dodge:
-            BaseEOGain = DodgeEOGain;
-            break;
-        case EDefenseType::Parry:
-            BaseEOGain = ParryEOGain;
-            break;
-        default:
-            return 0.0f;
-    }
-
-    // Apply timing accuracy modifier
-    float TimingMultiplier = 1.0f - Attempt.TimingAccuracy; // Better timing = more EO
-    return BaseEOGain * TimingMultiplier;
+    return BattleSim::CalculateEOGain(MakeDefenseTuning(), Attempt.DefenseType, Attempt.TimingAccuracy);
 }
 
 bool ADefenseManager::ShouldTriggerCounter(const FDefenseAttempt& Attempt) const
 {
-    return Attempt.DefenseType == EDefenseType::Parry && 
-           Attempt.Result == EDefenseResult::Counter;
+    return BattleSim::ShouldTriggerCounter(Attempt.DefenseType, Attempt.Result);
 }
 
 float ADefenseManager::GetDefenseDifficulty(EDefenseType DefenseType, EBattlePosition Position) const
 {
-    float BaseDifficulty = 1.0f;
-    
-    switch (DefenseType)
-    {
-        case EDefenseType::Dodge:
-            // Dodge is easier when alone
-            if (PositionManager && PositionManager->GetUnitCountAtPosition(Position) == 1)
-            {
-                BaseDifficulty = 0.5f; // Easier when alone
-            }
-            break;
-            
-        case EDefenseType::Parry:
-            // Parry is always difficult
-            BaseDifficulty = 2.0f;
-            break;
-            
-        case EDefenseType::Guard:
-            // Guard is always easy
-            BaseDifficulty = 0.1f;
-            break;
-            
-        default:
-            break;
-    }
-    
-    return BaseDifficulty;
+    return GetDefenseOptions(Position).GetDifficulty(DefenseType);
 }
 
 EDefenseResult ADefenseManager::EvaluateDefenseResult(EDefenseType DefenseType, float TimingAccuracy) const
 {
-    switch (DefenseType)
-    {
-        case EDefenseType::Dodge:
-            if (TimingAccuracy <= DodgePerfectWindow)
-                return EDefenseResult::Success;
-            else if (TimingAccuracy <= DodgeGoodWindow)
-                return EDefenseResult::Partial;
-            else
-                return EDefenseResult::Failure;
-                
-        case EDefenseType::Parry:
-            if (TimingAccuracy <= ParryPerfectWindow)
-                return EDefenseResult::Counter; // Perfect parry = counter attack
-            else if (TimingAccuracy <= ParryGoodWindow)
-                return EDefenseResult::Success;
-            else
-                return EDefenseResult::Failure;
-                
-        case EDefenseType::Guard:
-            return EDefenseResult::Success; // Guard always works
-            
-        default:
-            return EDefenseResult::Failure;
-    }
+    return BattleSim::EvaluateDefenseResult(MakeDefenseTuning(), DefenseType, TimingAccuracy);
 }
 
 void ADefenseManager::ProcessDefenseAttempt(const FDefenseAttempt& Attempt, ACombatUnit* Attacker, float Damage)
@@ -255,32 +187,31 @@ void ADefenseManager::ProcessDefenseAttempt(const FDefenseAttempt& Attempt, ACom
     if (!Attempt.DefendingUnit) return;
 
     // Calculate damage reduction
-    float DamageReduction = CalculateDamageReduction(Attempt);
-    float FinalDamage = Damage * (1.0f - DamageReduction);
+    const float DamageReduction = CalculateDamageReduction(Attempt);
+    const float FinalDamage = Damage * (1.0f - DamageReduction);
+    const float EOGain = CalculateEOGain(Attempt);
 
-    // Apply damage
-    Attempt.DefendingUnit->TakeDamageCustom(FinalDamage, EElementalType::Physical);
-
-    // Award EO for successful defense
-    float EOGain = CalculateEOGain(Attempt);
-    if (EOGain > 0.0f)
+    if (ShouldTriggerCounter(Attempt) && Attacker)
     {
-        Attempt.DefendingUnit->GainEO(EOGain);
+        OnCounterAttack(Attempt.DefendingUnit, Attacker);
     }
 
-    // Handle counter attack
-    if (ShouldTriggerCounter(Attempt) && Attacker)
+    if (BattleManager && BattleManager->GetSimIndex(Attempt.DefendingUnit) != INDEX_NONE)
     {
-        OnCounterAttack(Attempt.DefendingUnit, Attacker);
-        
-        // Perform counter attack
-        if (BattleManager)
+        // Damage, EO reward and the counter go through the damage queue as one batch
+        BattleManager->ResolveDefense(Attempt.DefendingUnit, Attacker, Attempt.DefenseType, Attempt.TimingAccuracy, Damage, MakeDefenseTuning());
+    }
+    else
+    {
+        // Not in a battle, so there is no one to counter
+        Attempt.DefendingUnit->TakeDamageCustom(FinalDamage, EElementalType::Physical);
+        if (EOGain > 0.0f)
         {
-            BattleManager->AttackUnit(Attempt.DefendingUnit, Attacker, EElementalType::Physical);
+            Attempt.DefendingUnit->GainEO(EOGain);
         }
     }
 
-    UE_LOG(LogTemp, Log, TEXT("%s defended against %s's attack. Damage: %f -> %f, EO gained: %f"), 
+    BATTLE_LOG(LogBattleCombat, Log, TEXT("%s defended against %s's attack. Damage: %f -> %f, EO gained: %f"), 
            *Attempt.DefendingUnit->UnitName, 
            Attacker ? *Attacker->UnitName : TEXT("Unknown"), 
            Damage, FinalDamage, EOGain);
@@ -288,16 +219,21 @@ void ADefenseManager::ProcessDefenseAttempt(const FDefenseAttempt& Attempt, ACom
 
 float ADefenseManager::GetPositionMultiplier(EBattlePosition Position) const
 {
-    // Position can affect defense difficulty
-    switch (Position)
-    {
-        case EBattlePosition::North:
-        case EBattlePosition::South:
-            return 1.0f; // Standard difficulty
-        case EBattlePosition::East:
-        case EBattlePosition::West:
-            return 1.2f; // Slightly harder
-        default:
-            return 1.0f;
-    }
+    return GetDefenseOptions(Position).PositionMultiplier;
+}
+
+FBattleSimDefenseTuning ADefenseManager::MakeDefenseTuning() const
+{
+    FBattleSimDefenseTuning Tuning;
+    Tuning.DodgePerfectWindow = DodgePerfectWindow;
+    Tuning.DodgeGoodWindow = DodgeGoodWindow;
+    Tuning.ParryPerfectWindow = ParryPerfectWindow;
+    Tuning.ParryGoodWindow = ParryGoodWindow;
+    Tuning.GuardDamageReduction = GuardDamageReduction;
+    Tuning.DodgeDamageReduction = DodgeDamageReduction;
+    Tuning.ParryDamageReduction = ParryDamageReduction;
+    Tuning.GuardEOGain = GuardEOGain;
+    Tuning.DodgeEOGain = DodgeEOGain;
+    Tuning.ParryEOGain = ParryEOGain;
+    return Tuning;
 }
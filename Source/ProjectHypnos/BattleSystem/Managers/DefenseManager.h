@@ -4,17 +4,10 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "../Units/CombatUnit.h"
+#include "../Simulation/DefenseTable.h"
+#include "BattleWorldSubsystem.h"
 #include "DefenseManager.generated.h"
 
-UENUM(BlueprintType)
-enum class EDefenseResult : uint8
-{
-    Success,
-    Partial,
-    Failure,
-    Counter
-};
-
 USTRUCT(BlueprintType)
 struct FDefenseAttempt
 {
@@ -49,8 +42,13 @@ class PROJECTHYPNOS_API ADefenseManager : public AActor
 public:
     ADefenseManager();
 
+    virtual void PostInitializeComponents() override;
     virtual void BeginPlay() override;
-    virtual void Tick(float DeltaTime) override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    // Managers and units with the same ID form one battle
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Battle")
+    FName BattleId;
 
     // Defense timing windows
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Defense")
@@ -136,10 +134,17 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Defense")
     void ProcessDefenseAttempt(const FDefenseAttempt& Attempt, ACombatUnit* Attacker, float Damage);
 
+    // Every defense's availability and difficulty at Position in the current formation, from one table lookup
+    const FDefenseOptions& GetDefenseOptions(EBattlePosition Position) const;
+
 protected:
     class APositionManager* PositionManager;
     class ABattleManager* BattleManager;
+    FBattleHandle BattleHandle;
 
     void InitializeManagers();
     float GetPositionMultiplier(EBattlePosition Position) const;
+
+    // Snapshot of the tunables above in the form the simulation rules take
+    FBattleSimDefenseTuning MakeDefenseTuning() const;
 };
@@ -1,11 +1,27 @@
 // PositionManager.cpp
 #include "PositionManager.h"
+#include "BattleManager.h"
+#include "../BattleLog.h"
 
 APositionManager::APositionManager()
 {
     PrimaryActorTick.bCanEverTick = false;
     CenterPosition = FVector(0.0f, 0.0f, 0.0f);
     PositionRadius = 500.0f;
+
+    FMemory::Memset(SlotPositions, NoPosition, sizeof(SlotPositions));
+    FMemory::Memzero(Occupancy, sizeof(Occupancy));
+    FMemory::Memzero(Counts, sizeof(Counts));
+}
+
+void APositionManager::PostInitializeComponents()
+{
+    Super::PostInitializeComponents();
+
+    if (UBattleWorldSubsystem* Battles = UBattleWorldSubsystem::Get(this))
+    {
+        BattleHandle = Battles->Register(this, BattleId);
+    }
 }
 
 void APositionManager::BeginPlay()
@@ -14,85 +30,119 @@ void APositionManager::BeginPlay()
     InitializePositions();
 }
 
-void APositionManager::InitializePositions()
+void APositionManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-    BattlePositions.Empty();
+    if (UBattleWorldSubsystem* Battles = UBattleWorldSubsystem::Get(this))
+    {
+        Battles->Unregister(this, BattleHandle);
+    }
 
-    // Create the four positions around center
-    FBattlePositionInfo NorthPos;
-    NorthPos.Position = EBattlePosition::North;
-    NorthPos.WorldLocation = CenterPosition + FVector(0.0f, PositionRadius, 0.0f);
+    Super::EndPlay(EndPlayReason);
+}
 
-    FBattlePositionInfo EastPos;
-    EastPos.Position = EBattlePosition::East;
-    EastPos.WorldLocation = CenterPosition + FVector(PositionRadius, 0.0f, 0.0f);
+void APositionManager::InitializePositions()
+{
+    // Indexed by EBattlePosition, so lookups never search
+    BattlePositions.SetNum(NumPositions);
+    for (int32 Index = 0; Index < NumPositions; ++Index)
+    {
+        BattlePositions[Index].Position = (EBattlePosition)Index;
+    }
 
-    FBattlePositionInfo SouthPos;
-    SouthPos.Position = EBattlePosition::South;
-    SouthPos.WorldLocation = CenterPosition + FVector(0.0f, -PositionRadius, 0.0f);
+    // The four positions around center, with the enemies in the middle
+    BattlePositions[(int32)EBattlePosition::North].WorldLocation = CenterPosition + FVector(0.0f, PositionRadius, 0.0f);
+    BattlePositions[(int32)EBattlePosition::East].WorldLocation = CenterPosition + FVector(PositionRadius, 0.0f, 0.0f);
+    BattlePositions[(int32)EBattlePosition::South].WorldLocation = CenterPosition + FVector(0.0f, -PositionRadius, 0.0f);
+    BattlePositions[(int32)EBattlePosition::West].WorldLocation = CenterPosition + FVector(-PositionRadius, 0.0f, 0.0f);
+    BattlePositions[(int32)EBattlePosition::Center].WorldLocation = CenterPosition;
 
-    FBattlePositionInfo WestPos;
-    WestPos.Position = EBattlePosition::West;
-    WestPos.WorldLocation = CenterPosition + FVector(-PositionRadius, 0.0f, 0.0f);
+    SlotUnits.Reset();
+    UnitToSlot.Reset();
+    FMemory::Memset(SlotPositions, NoPosition, sizeof(SlotPositions));
+    FMemory::Memzero(Occupancy, sizeof(Occupancy));
+    FMemory::Memzero(Counts, sizeof(Counts));
+    Formation = 0;
 
-    BattlePositions.Add(NorthPos);
-    BattlePositions.Add(EastPos);
-    BattlePositions.Add(SouthPos);
-    BattlePositions.Add(WestPos);
+    BATTLE_LOG(LogBattleUnits, Log, TEXT("Initialized %d battle positions"), BattlePositions.Num());
 
-    UE_LOG(LogTemp, Log, TEXT("Initialized %d battle positions"), BattlePositions.Num());
+    // A battle that bound its units before this ran places them again
+    if (ABattleManager* Battle = GetBattleManager())
+    {
+        Battle->SyncUnitPositions();
+    }
 }
 
 bool APositionManager::MoveUnitToPosition(ACombatUnit* Unit, EBattlePosition NewPosition)
 {
-    if (!Unit) return false;
+    if (!Unit || !IsValidPosition(NewPosition)) return false;
 
-    // Remove unit from current position
-    RemoveUnitFromAllPositions(Unit);
+    // Units in the battle move through it, so the move is logged and the slots follow the simulation
+    ABattleManager* Battle = GetBattleManager();
+    if (Battle && Battle->GetSimIndex(Unit) != INDEX_NONE)
+    {
+        Battle->MoveUnit(Unit, NewPosition);
+        return Unit->CurrentPosition == NewPosition;
+    }
 
-    // Add to new position
-    FBattlePositionInfo* PositionInfo = GetPositionInfo(NewPosition);
-    if (PositionInfo)
+    if (!PlaceUnit(Unit, NewPosition)) return false;
+    Unit->SetPosition(NewPosition);
+    return true;
+}
+
+bool APositionManager::PlaceUnit(ACombatUnit* Unit, EBattlePosition NewPosition)
+{
+    if (!Unit || !IsValidPosition(NewPosition)) return false;
+
+    const int32 Slot = FindOrAddSlot(Unit);
+    if (Slot == INDEX_NONE)
     {
-        PositionInfo->UnitsAtPosition.Add(Unit);
-        Unit->SetPosition(NewPosition);
+        BATTLE_LOG(LogBattleUnits, Warning, TEXT("%s cannot be placed: all %d position slots are taken"), *Unit->UnitName, MaxUnits);
+        return false;
+    }
 
-        UE_LOG(LogTemp, Log, TEXT("%s moved to position %d. Units at this position: %d"),
-            *Unit->UnitName, (int32)NewPosition, PositionInfo->UnitsAtPosition.Num());
+    const uint8 OldPosition = SlotPositions[Slot];
+    if (OldPosition == (uint8)NewPosition) return true;
 
-        return true;
+    // Remove unit from current position
+    const uint64 Bit = 1ull << Slot;
+    if (OldPosition != NoPosition)
+    {
+        Occupancy[OldPosition] &= ~Bit;
+        --Counts[OldPosition];
+        Formation = BattleSim::SetFormationCount(Formation, (EBattlePosition)OldPosition, Counts[OldPosition]);
     }
 
-    return false;
+    // Add to new position
+    const int32 PositionIndex = (int32)NewPosition;
+    Occupancy[PositionIndex] |= Bit;
+    ++Counts[PositionIndex];
+    SlotPositions[Slot] = (uint8)PositionIndex;
+    Formation = BattleSim::SetFormationCount(Formation, NewPosition, Counts[PositionIndex]);
+
+    BATTLE_LOG(LogBattleUnits, Verbose, TEXT("%s moved to position %d. Units at this position: %d"),
+        *Unit->UnitName, PositionIndex, Counts[PositionIndex]);
+
+    return true;
 }
 
 TArray<ACombatUnit*> APositionManager::GetUnitsAtPosition(EBattlePosition Position) const
 {
-    for (const FBattlePositionInfo& PositionInfo : BattlePositions)
+    TArray<ACombatUnit*> Units;
+    for (uint64 Mask = GetOccupancy(Position); Mask != 0; Mask &= Mask - 1)
     {
-        if (PositionInfo.Position == Position)
-        {
-            return PositionInfo.UnitsAtPosition;
-        }
+        Units.Add(SlotUnits[FMath::CountTrailingZeros64(Mask)]);
     }
-    return TArray<ACombatUnit*>();
+    return Units;
 }
 
 int32 APositionManager::GetUnitCountAtPosition(EBattlePosition Position) const
 {
-    return GetUnitsAtPosition(Position).Num();
+    return IsValidPosition(Position) ? Counts[(int32)Position] : 0;
 }
 
 FVector APositionManager::GetPositionWorldLocation(EBattlePosition Position) const
 {
-    for (const FBattlePositionInfo& PositionInfo : BattlePositions)
-    {
-        if (PositionInfo.Position == Position)
-        {
-            return PositionInfo.WorldLocation;
-        }
-    }
-    return FVector::ZeroVector;
+    return BattlePositions.IsValidIndex((int32)Position) ? BattlePositions[(int32)Position].WorldLocation : FVector::ZeroVector;
 }
 
 bool APositionManager::CanUseGuard(EBattlePosition Position) const
@@ -109,20 +159,37 @@ bool APositionManager::CanUseParry(EBattlePosition Position) const
 
 void APositionManager::RemoveUnitFromAllPositions(ACombatUnit* Unit)
 {
-    for (FBattlePositionInfo& PositionInfo : BattlePositions)
-    {
-        PositionInfo.UnitsAtPosition.Remove(Unit);
-    }
+    const int32* Slot = UnitToSlot.Find(Unit);
+    if (!Slot || SlotPositions[*Slot] == NoPosition) return;
+
+    const uint8 OldPosition = SlotPositions[*Slot];
+    Occupancy[OldPosition] &= ~(1ull << *Slot);
+    --Counts[OldPosition];
+    Formation = BattleSim::SetFormationCount(Formation, (EBattlePosition)OldPosition, Counts[OldPosition]);
+    SlotPositions[*Slot] = NoPosition;
+}
+
+ABattleManager* APositionManager::GetBattleManager() const
+{
+    const UBattleWorldSubsystem* Battles = UBattleWorldSubsystem::Get(this);
+    return Battles ? Battles->GetBattleManager(BattleHandle) : nullptr;
 }
 
 FBattlePositionInfo* APositionManager::GetPositionInfo(EBattlePosition Position)
 {
-    for (FBattlePositionInfo& PositionInfo : BattlePositions)
+    return BattlePositions.IsValidIndex((int32)Position) ? &BattlePositions[(int32)Position] : nullptr;
+}
+
+int32 APositionManager::FindOrAddSlot(ACombatUnit* Unit)
+{
+    if (const int32* Slot = UnitToSlot.Find(Unit))
     {
-        if (PositionInfo.Position == Position)
-        {
-            return &PositionInfo;
-        }
+        return *Slot;
     }
-    return nullptr;
-}
\ No newline at end of file
+
+    if (SlotUnits.Num() >= MaxUnits) return INDEX_NONE;
+
+    const int32 Slot = SlotUnits.Add(Unit);
+    UnitToSlot.Add(Unit, Slot);
+    return Slot;
+}
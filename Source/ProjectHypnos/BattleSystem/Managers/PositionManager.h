@@ -4,6 +4,8 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "../Units/CombatUnit.h"
+#include "../Simulation/DefenseTable.h"
+#include "BattleWorldSubsystem.h"
 #include "PositionManager.generated.h"
 
 USTRUCT(BlueprintType)
@@ -17,9 +19,6 @@ struct FBattlePositionInfo
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Position")
     FVector WorldLocation;
 
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Position")
-    TArray<ACombatUnit*> UnitsAtPosition;
-
     FBattlePositionInfo()
     {
         Position = EBattlePosition::West;
@@ -27,6 +26,14 @@ struct FBattlePositionInfo
     }
 };
 
+/**
+ * Tracks which units stand in which quadrant. Units get a slot (up to MaxUnits) the first time they
+ * move; each position keeps a bitmask of the slots standing there and a count, so moves are two
+ * bit flips and count queries are a single load.
+ *
+ * For units in a battle the simulation owns the position: ABattleManager places them here whenever
+ * it syncs, and MoveUnitToPosition hands their moves to it.
+ */
 UCLASS(Blueprintable)
 class PROJECTHYPNOS_API APositionManager : public AActor
 {
@@ -35,9 +42,18 @@ class PROJECTHYPNOS_API APositionManager : public AActor
 public:
     APositionManager();
 
+    virtual void PostInitializeComponents() override;
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    // Managers and units with the same ID form one battle
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Battle")
+    FName BattleId;
+
+    static constexpr int32 NumPositions = (int32)EBattlePosition::Center + 1;
+    static constexpr int32 MaxUnits = 64;
 
-    // Position data
+    // Position data, one entry per EBattlePosition in enum order
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Positions")
     TArray<FBattlePositionInfo> BattlePositions;
 
@@ -54,6 +70,10 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Position")
     bool MoveUnitToPosition(ACombatUnit* Unit, EBattlePosition NewPosition);
 
+    // Moves Unit's slot without touching the unit itself. False once all slots are taken.
+    bool PlaceUnit(ACombatUnit* Unit, EBattlePosition NewPosition);
+
+    // Builds a new array; native code should prefer GetOccupancy and GetUnitInSlot
     UFUNCTION(BlueprintCallable, Category = "Position")
     TArray<ACombatUnit*> GetUnitsAtPosition(EBattlePosition Position) const;
 
@@ -69,7 +89,40 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Position")
     bool CanUseParry(EBattlePosition Position) const;
 
+    // Bit i is set if the unit in slot i stands at Position
+    uint64 GetOccupancy(EBattlePosition Position) const
+    {
+        return IsValidPosition(Position) ? Occupancy[(int32)Position] : 0;
+    }
+
+    ACombatUnit* GetUnitInSlot(int32 Slot) const { return SlotUnits.IsValidIndex(Slot) ? SlotUnits[Slot] : nullptr; }
+
+    // Saturated unit counts of every position (see DefenseTable.h). Changes only when a unit moves.
+    uint16 GetFormation() const { return Formation; }
+
+    static bool IsValidPosition(EBattlePosition Position) { return (uint8)Position < NumPositions; }
+
 protected:
     void RemoveUnitFromAllPositions(ACombatUnit* Unit);
+    class ABattleManager* GetBattleManager() const;
     FBattlePositionInfo* GetPositionInfo(EBattlePosition Position);
-};
\ No newline at end of file
+
+    // Slot of Unit, assigning the next free one on first use. INDEX_NONE once all slots are taken.
+    int32 FindOrAddSlot(ACombatUnit* Unit);
+
+    FBattleHandle BattleHandle;
+
+    // Slot index -> unit
+    UPROPERTY(Transient)
+    TArray<ACombatUnit*> SlotUnits;
+
+    TMap<const ACombatUnit*, int32> UnitToSlot;
+
+    // Per slot: the position index it stands at, or NoPosition
+    static constexpr uint8 NoPosition = 0xFF;
+    uint8 SlotPositions[MaxUnits];
+
+    uint64 Occupancy[NumPositions];
+    uint8 Counts[NumPositions];
+    uint16 Formation = 0;
+};
@@ -0,0 +1,522 @@
+// BattleActionLog.cpp
+#include "BattleActionLog.h"
+#include "BattleSimRules.h"
+
+namespace
+{
+    // Tunings are plain float structs, stored field by field in declaration order
+    static_assert(sizeof(FBattleSimTuning) % sizeof(float) == 0, "FBattleSimTuning must hold only floats");
+    static_assert(sizeof(FBattleSimDefenseTuning) % sizeof(float) == 0, "FBattleSimDefenseTuning must hold only floats");
+
+    void WriteUInt(TArray<uint8>& Bytes, uint64 Value)
+    {
+        // LEB128: seven bits per byte, high bit set while more follow
+        while (Value >= 0x80)
+        {
+            Bytes.Add((uint8)(Value | 0x80));
+            Value >>= 7;
+        }
+        Bytes.Add((uint8)Value);
+    }
+
+    void WriteInt(TArray<uint8>& Bytes, int64 Value)
+    {
+        // Zigzag, so INDEX_NONE and other small negatives stay one byte
+        WriteUInt(Bytes, ((uint64)Value << 1) ^ (uint64)(Value >> 63));
+    }
+
+    void WriteFloat(TArray<uint8>& Bytes, float Value)
+    {
+        uint32 Bits;
+        FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+        for (int32 Shift = 0; Shift < 32; Shift += 8)
+        {
+            Bytes.Add((uint8)(Bits >> Shift));
+        }
+    }
+
+    template <typename T>
+    void WriteFloats(TArray<uint8>& Bytes, const T& Struct)
+    {
+        const float* Floats = reinterpret_cast<const float*>(&Struct);
+        for (int32 Index = 0; Index < (int32)(sizeof(T) / sizeof(float)); ++Index)
+        {
+            WriteFloat(Bytes, Floats[Index]);
+        }
+    }
+
+    struct FLogCursor
+    {
+        TConstArrayView<uint8> Bytes;
+        int32 Offset = 0;
+        bool bValid = true;
+
+        uint8 ReadByte()
+        {
+            if (Offset >= Bytes.Num())
+            {
+                bValid = false;
+                return 0;
+            }
+            return Bytes[Offset++];
+        }
+
+        uint64 ReadUInt()
+        {
+            uint64 Value = 0;
+            for (int32 Shift = 0; Shift < 64; Shift += 7)
+            {
+                const uint8 Byte = ReadByte();
+                Value |= (uint64)(Byte & 0x7F) << Shift;
+                if (!(Byte & 0x80)) return Value;
+            }
+            bValid = false;
+            return 0;
+        }
+
+        int64 ReadInt()
+        {
+            const uint64 Value = ReadUInt();
+            return (int64)(Value >> 1) ^ -(int64)(Value & 1);
+        }
+
+        int32 ReadInt32()
+        {
+            return (int32)ReadInt();
+        }
+
+        float ReadFloat()
+        {
+            uint32 Bits = 0;
+            for (int32 Shift = 0; Shift < 32; Shift += 8)
+            {
+                Bits |= (uint32)ReadByte() << Shift;
+            }
+            float Value;
+            FMemory::Memcpy(&Value, &Bits, sizeof(Value));
+            return Value;
+        }
+
+        template <typename T>
+        void ReadFloats(T& Struct)
+        {
+            float* Floats = reinterpret_cast<float*>(&Struct);
+            for (int32 Index = 0; Index < (int32)(sizeof(T) / sizeof(float)); ++Index)
+            {
+                Floats[Index] = ReadFloat();
+            }
+        }
+    };
+
+    void WriteUnit(TArray<uint8>& Bytes, const FBattleSimUnit& Unit)
+    {
+        Bytes.Add((uint8)Unit.UnitType);
+        Bytes.Add((uint8)Unit.Position);
+        WriteFloat(Bytes, Unit.MaxHP);
+        WriteFloat(Bytes, Unit.CurrentHP);
+        WriteInt(Bytes, Unit.TimerDuration);
+        WriteInt(Bytes, Unit.TimerRemaining);
+        WriteInt(Bytes, Unit.TimerTickRate);
+        WriteInt(Bytes, Unit.StockpiledTime);
+        WriteFloat(Bytes, Unit.MaxEO);
+        WriteFloat(Bytes, Unit.CurrentEO);
+        WriteFloat(Bytes, Unit.EOGainRate);
+        WriteInt(Bytes, Unit.EOSettledTick);
+        WriteFloat(Bytes, Unit.MaxMP);
+        WriteFloat(Bytes, Unit.CurrentMP);
+        Bytes.Add((uint8)(Unit.bIsInEOForm | Unit.bIsStressedOut << 1 | Unit.bIsIncapacitated << 2));
+        Bytes.Add((uint8)Unit.DefenseType);
+        WriteInt(Bytes, Unit.CharacterBit);
+
+        WriteUInt(Bytes, Unit.ElementalResistances.Num());
+        for (const FElementalResistance& Resistance : Unit.ElementalResistances)
+        {
+            Bytes.Add((uint8)Resistance.ElementType);
+            WriteFloat(Bytes, Resistance.ResistanceMultiplier);
+        }
+    }
+
+    void ReadUnit(FLogCursor& Cursor, FBattleSimUnit& Unit)
+    {
+        Unit.UnitType = (EUnitType)Cursor.ReadByte();
+        Unit.Position = (EBattlePosition)Cursor.ReadByte();
+        Unit.MaxHP = Cursor.ReadFloat();
+        Unit.CurrentHP = Cursor.ReadFloat();
+        Unit.TimerDuration = Cursor.ReadInt();
+        Unit.TimerRemaining = Cursor.ReadInt();
+        Unit.TimerTickRate = Cursor.ReadInt32();
+        Unit.StockpiledTime = Cursor.ReadInt();
+        Unit.MaxEO = Cursor.ReadFloat();
+        Unit.CurrentEO = Cursor.ReadFloat();
+        Unit.EOGainRate = Cursor.ReadFloat();
+        Unit.EOSettledTick = Cursor.ReadInt();
+        Unit.MaxMP = Cursor.ReadFloat();
+        Unit.CurrentMP = Cursor.ReadFloat();
+        const uint8 Flags = Cursor.ReadByte();
+        Unit.bIsInEOForm = (Flags & 1) != 0;
+        Unit.bIsStressedOut = (Flags & 2) != 0;
+        Unit.bIsIncapacitated = (Flags & 4) != 0;
+        Unit.DefenseType = (EDefenseType)Cursor.ReadByte();
+        Unit.CharacterBit = Cursor.ReadInt32();
+
+        const uint64 NumResistances = Cursor.ReadUInt();
+        for (uint64 Index = 0; Index < NumResistances && Cursor.bValid; ++Index)
+        {
+            FElementalResistance Resistance;
+            Resistance.ElementType = (EElementalType)Cursor.ReadByte();
+            Resistance.ResistanceMultiplier = Cursor.ReadFloat();
+            Unit.ElementalResistances.Add(Resistance);
+        }
+    }
+}
+
+void FBattleActionLog::Begin(const FBattleSimState& State, uint32 Seed)
+{
+    Reset();
+
+    for (int32 Shift = 0; Shift < 32; Shift += 8)
+    {
+        Bytes.Add((uint8)(Magic >> Shift));
+    }
+    WriteUInt(Bytes, Version);
+    WriteUInt(Bytes, Seed);
+    WriteInt(Bytes, State.ClockTick);
+    WriteFloats(Bytes, State.Tuning);
+    WriteFloats(Bytes, State.DefenseTuning);
+
+    WriteUInt(Bytes, State.Units.Num());
+    for (int32 Unit = 0; Unit < State.Units.Num(); ++Unit)
+    {
+        WriteUnit(Bytes, State.Units.Get(Unit));
+    }
+
+    LastTick = State.ClockTick;
+}
+
+void FBattleActionLog::Reset()
+{
+    Bytes.Reset();
+    LastTick = 0;
+}
+
+void FBattleActionLog::Write(int64 Tick, const FBattleLogEntry& Entry)
+{
+    if (!IsRecording()) return;
+
+    Bytes.Add((uint8)Entry.Type);
+    WriteUInt(Bytes, (uint64)FMath::Max<int64>(0, Tick - LastTick));
+    LastTick = FMath::Max(LastTick, Tick);
+
+    switch (Entry.Type)
+    {
+        case EBattleLogRecord::Action:
+            Bytes.Add((uint8)Entry.Action.ActionType);
+            WriteInt(Bytes, Entry.Action.ActingUnit);
+            WriteInt(Bytes, Entry.Action.TargetUnit);
+            switch (Entry.Action.ActionType)
+            {
+                case EActionType::Move:
+                    Bytes.Add((uint8)Entry.Action.TargetPosition);
+                    break;
+                case EActionType::Attack:
+                    Bytes.Add((uint8)Entry.Action.Element);
+                    break;
+                case EActionType::Skill:
+                    WriteInt(Bytes, Entry.Action.SkillIndex);
+                    break;
+                case EActionType::Ranti:
+                    WriteInt(Bytes, Entry.Action.ComboIndex);
+                    break;
+                default:
+                    break;
+            }
+            break;
+
+        case EBattleLogRecord::AttackBatch:
+            WriteInt(Bytes, Entry.Damage.Attacker);
+            Bytes.Add((uint8)Entry.Damage.Element);
+            WriteUInt(Bytes, Entry.Targets.Num());
+            for (int32 Target : Entry.Targets)
+            {
+                WriteInt(Bytes, Target);
+            }
+            break;
+
+        case EBattleLogRecord::QueueDamage:
+            WriteInt(Bytes, Entry.Damage.Attacker);
+            WriteInt(Bytes, Entry.Damage.Target);
+            Bytes.Add((uint8)Entry.Damage.Element);
+            WriteFloat(Bytes, Entry.Damage.BaseDamage);
+            Bytes.Add((uint8)Entry.Damage.Defense | (uint8)Entry.Damage.bRewardsWeakness << 7);
+            if (Entry.Damage.Defense != EDefenseType::None)
+            {
+                WriteFloat(Bytes, Entry.Damage.TimingAccuracy);
+            }
+            break;
+
+        case EBattleLogRecord::Defense:
+            WriteInt(Bytes, Entry.Damage.Target);
+            WriteInt(Bytes, Entry.Damage.Attacker);
+            Bytes.Add((uint8)Entry.Damage.Defense);
+            WriteFloat(Bytes, Entry.Damage.TimingAccuracy);
+            WriteFloat(Bytes, Entry.Damage.BaseDamage);
+            break;
+
+        case EBattleLogRecord::DefenseTuning:
+            WriteFloats(Bytes, Entry.DefenseTuning);
+            break;
+
+        case EBattleLogRecord::WeaknessHit:
+            WriteInt(Bytes, Entry.Damage.Attacker);
+            WriteInt(Bytes, Entry.Damage.Target);
+            Bytes.Add((uint8)Entry.Damage.Element);
+            break;
+
+        case EBattleLogRecord::TFNToNextUnit:
+            WriteFloat(Bytes, Entry.Value);
+            break;
+
+        case EBattleLogRecord::AddStockpile:
+            WriteInt(Bytes, Entry.Unit);
+            WriteFloat(Bytes, Entry.Value);
+            break;
+
+        case EBattleLogRecord::TimerExpired:
+            WriteInt(Bytes, Entry.Unit);
+            break;
+
+        case EBattleLogRecord::Checkpoint:
+            for (int32 Shift = 0; Shift < 64; Shift += 8)
+            {
+                Bytes.Add((uint8)(Entry.Hash >> Shift));
+            }
+            break;
+
+        case EBattleLogRecord::Rewind:
+        {
+            // Raw snapshot bytes: rewinds are rare, and only the used units are written
+            check(Entry.Snapshot.IsValid());
+            const int32 Size = Entry.Snapshot->GetUsedSize();
+            WriteUInt(Bytes, Size);
+            Bytes.Append(reinterpret_cast<const uint8*>(Entry.Snapshot.Get()), Size);
+            LastTick = Entry.Snapshot->ClockTick;
+            break;
+        }
+
+        default:
+            // Turn flow records carry no payload
+            break;
+    }
+}
+
+void FBattleActionLog::Finish(int64 Tick, uint64 FinalHash, TArray<uint8>& OutBytes) const
+{
+    OutBytes = Bytes;
+    if (OutBytes.Num() == 0) return;
+
+    // Both records sit at Tick, so the End record's delta is always zero
+    OutBytes.Add((uint8)EBattleLogRecord::Checkpoint);
+    WriteUInt(OutBytes, (uint64)FMath::Max<int64>(0, Tick - LastTick));
+    for (int32 Shift = 0; Shift < 64; Shift += 8)
+    {
+        OutBytes.Add((uint8)(FinalHash >> Shift));
+    }
+
+    OutBytes.Add((uint8)EBattleLogRecord::End);
+    WriteUInt(OutBytes, 0);
+}
+
+bool FBattleLogReader::Open(TConstArrayView<uint8> InBytes, FBattleSimState& OutState, uint32& OutSeed, const FSkillTable* Skills, const FRantiRegistry* Ranti)
+{
+    Bytes = InBytes;
+    bAtEnd = true;
+
+    FLogCursor Cursor;
+    Cursor.Bytes = Bytes;
+
+    uint32 FileMagic = 0;
+    for (int32 Shift = 0; Shift < 32; Shift += 8)
+    {
+        FileMagic |= (uint32)Cursor.ReadByte() << Shift;
+    }
+    if (FileMagic != FBattleActionLog::Magic || Cursor.ReadUInt() != FBattleActionLog::Version) return false;
+
+    OutSeed = (uint32)Cursor.ReadUInt();
+
+    OutState = FBattleSimState();
+    OutState.Skills = Skills;
+    OutState.Ranti = Ranti;
+    OutState.ClockTick = Cursor.ReadInt();
+    OutState.TimerSettledTick = OutState.ClockTick;
+    Cursor.ReadFloats(OutState.Tuning);
+    Cursor.ReadFloats(OutState.DefenseTuning);
+    OutState.CurrentTimerRemaining = BattleClock::SecondsToTimerUnits(OutState.Tuning.BaseTimerDuration);
+
+    const uint64 NumUnits = Cursor.ReadUInt();
+    for (uint64 Index = 0; Index < NumUnits && Cursor.bValid; ++Index)
+    {
+        FBattleSimUnit Unit;
+        ReadUnit(Cursor, Unit);
+        BattleSim::AddUnit(OutState, Unit);
+    }
+    if (!Cursor.bValid) return false;
+
+    Offset = Cursor.Offset;
+    LastTick = OutState.ClockTick;
+    bAtEnd = false;
+    return true;
+}
+
+bool FBattleLogReader::Next(FBattleLogEntry& OutEntry)
+{
+    if (bAtEnd) return false;
+
+    FLogCursor Cursor;
+    Cursor.Bytes = Bytes;
+    Cursor.Offset = Offset;
+
+    OutEntry = FBattleLogEntry((EBattleLogRecord)Cursor.ReadByte());
+    LastTick += (int64)Cursor.ReadUInt();
+    OutEntry.Tick = LastTick;
+
+    switch (OutEntry.Type)
+    {
+        case EBattleLogRecord::Action:
+            OutEntry.Action.ActionType = (EActionType)Cursor.ReadByte();
+            OutEntry.Action.ActingUnit = Cursor.ReadInt32();
+            OutEntry.Action.TargetUnit = Cursor.ReadInt32();
+            switch (OutEntry.Action.ActionType)
+            {
+                case EActionType::Move:
+                    OutEntry.Action.TargetPosition = (EBattlePosition)Cursor.ReadByte();
+                    break;
+                case EActionType::Attack:
+                    OutEntry.Action.Element = (EElementalType)Cursor.ReadByte();
+                    break;
+                case EActionType::Skill:
+                    OutEntry.Action.SkillIndex = Cursor.ReadInt32();
+                    break;
+                case EActionType::Ranti:
+                    OutEntry.Action.ComboIndex = Cursor.ReadInt32();
+                    break;
+                default:
+                    break;
+            }
+            break;
+
+        case EBattleLogRecord::AttackBatch:
+        {
+            OutEntry.Damage.Attacker = Cursor.ReadInt32();
+            OutEntry.Damage.Element = (EElementalType)Cursor.ReadByte();
+            const uint64 NumTargets = Cursor.ReadUInt();
+            if (NumTargets > (uint64)BattleSim::MaxDamageBatchTargets)
+            {
+                Cursor.bValid = false;
+                break;
+            }
+            for (uint64 Index = 0; Index < NumTargets && Cursor.bValid; ++Index)
+            {
+                OutEntry.Targets.Add(Cursor.ReadInt32());
+            }
+            break;
+        }
+
+        case EBattleLogRecord::QueueDamage:
+        {
+            OutEntry.Damage.Attacker = Cursor.ReadInt32();
+            OutEntry.Damage.Target = Cursor.ReadInt32();
+            OutEntry.Damage.Element = (EElementalType)Cursor.ReadByte();
+            OutEntry.Damage.BaseDamage = Cursor.ReadFloat();
+            const uint8 DefenseByte = Cursor.ReadByte();
+            OutEntry.Damage.Defense = (EDefenseType)(DefenseByte & 0x7F);
+            OutEntry.Damage.bRewardsWeakness = (DefenseByte & 0x80) != 0;
+            if (OutEntry.Damage.Defense != EDefenseType::None)
+            {
+                OutEntry.Damage.TimingAccuracy = Cursor.ReadFloat();
+            }
+            break;
+        }
+
+        case EBattleLogRecord::Defense:
+            OutEntry.Damage.Target = Cursor.ReadInt32();
+            OutEntry.Damage.Attacker = Cursor.ReadInt32();
+            OutEntry.Damage.Defense = (EDefenseType)Cursor.ReadByte();
+            OutEntry.Damage.TimingAccuracy = Cursor.ReadFloat();
+            OutEntry.Damage.BaseDamage = Cursor.ReadFloat();
+            break;
+
+        case EBattleLogRecord::DefenseTuning:
+            Cursor.ReadFloats(OutEntry.DefenseTuning);
+            break;
+
+        case EBattleLogRecord::WeaknessHit:
+            OutEntry.Damage.Attacker = Cursor.ReadInt32();
+            OutEntry.Damage.Target = Cursor.ReadInt32();
+            OutEntry.Damage.Element = (EElementalType)Cursor.ReadByte();
+            break;
+
+        case EBattleLogRecord::TFNToNextUnit:
+            OutEntry.Value = Cursor.ReadFloat();
+            break;
+
+        case EBattleLogRecord::AddStockpile:
+            OutEntry.Unit = Cursor.ReadInt32();
+            OutEntry.Value = Cursor.ReadFloat();
+            break;
+
+        case EBattleLogRecord::TimerExpired:
+            OutEntry.Unit = Cursor.ReadInt32();
+            break;
+
+        case EBattleLogRecord::Checkpoint:
+            for (int32 Shift = 0; Shift < 64; Shift += 8)
+            {
+                OutEntry.Hash |= (uint64)Cursor.ReadByte() << Shift;
+            }
+            break;
+
+        case EBattleLogRecord::Rewind:
+        {
+            const uint64 Size = Cursor.ReadUInt();
+            const uint64 HeaderSize = STRUCT_OFFSET(FBattleSnapshot, Units);
+            if (Size < HeaderSize || Size > sizeof(FBattleSnapshot) || Cursor.Offset + Size > (uint64)Bytes.Num())
+            {
+                Cursor.bValid = false;
+                break;
+            }
+
+            TSharedPtr<FBattleSnapshot> Snapshot = MakeShared<FBattleSnapshot>();
+            FMemory::Memcpy(Snapshot.Get(), Bytes.GetData() + Cursor.Offset, Size);
+            Cursor.Offset += (int32)Size;
+            if (Snapshot->NumUnits < 0 || Snapshot->NumUnits > FBattleSnapshot::MaxUnits || Snapshot->GetUsedSize() != (int32)Size)
+            {
+                Cursor.bValid = false;
+                break;
+            }
+
+            OutEntry.Snapshot = Snapshot;
+            break;
+        }
+
+        default:
+            if (OutEntry.Type > EBattleLogRecord::Rewind)
+            {
+                Cursor.bValid = false;
+            }
+            break;
+    }
+
+    if (!Cursor.bValid)
+    {
+        bAtEnd = true;
+        return false;
+    }
+
+    Offset = Cursor.Offset;
+    bAtEnd = OutEntry.Type == EBattleLogRecord::End;
+    if (OutEntry.Snapshot.IsValid())
+    {
+        LastTick = OutEntry.Snapshot->ClockTick;
+    }
+    return true;
+}
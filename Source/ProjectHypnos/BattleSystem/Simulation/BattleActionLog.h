@@ -0,0 +1,118 @@
+// BattleActionLog.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BattleSimState.h"
+#include "BattleSnapshot.h"
+
+// Record tags. Stored as one byte, so existing values must never be renumbered.
+enum class EBattleLogRecord : uint8
+{
+    End,
+    StartBattle,
+    RetryBattle,
+    Action,             // Move, attack, skill, Ranti or EO transform through BattleSim::ExecuteAction
+    AttackBatch,        // One attack on several targets
+    QueueDamage,
+    ResolveDamage,
+    Defense,
+    DefenseTuning,
+    WeaknessHit,
+    TFNToNextUnit,
+    AddStockpile,
+    EndTurn,
+    StartNextUnitTurn,
+    CheckSetCompletion,
+    StartEnemyTurn,
+    EndEnemyTurn,
+    StartNewSet,
+    Pause,
+    Resume,
+    AnimationStarted,
+    AnimationFinished,
+    TimerExpired,       // Verification only: replays check the same turn expires at the same point
+    Checkpoint,         // Verification only: BattleSim::HashState at this point
+    Rewind              // Undo or set retry. Carries the snapshot, so replays need no ring of their own.
+};
+
+// One decoded record. Only the fields its Type uses are meaningful.
+struct FBattleLogEntry
+{
+    EBattleLogRecord Type = EBattleLogRecord::End;
+
+    // Clock tick the record applies at
+    int64 Tick = 0;
+
+    FBattleSimAction Action;
+
+    // QueueDamage as is. Defense: Target defends against Attacker with Defense, TimingAccuracy and
+    // BaseDamage. WeaknessHit: Attacker, Target and Element. AttackBatch: Attacker and Element.
+    FDamageRequest Damage;
+
+    TArray<int32, TInlineAllocator<8>> Targets; // AttackBatch
+    int32 Unit = INDEX_NONE;                    // AddStockpile, TimerExpired
+    float Value = 0.0f;                         // TFN multiplier, stockpiled seconds
+    FBattleSimDefenseTuning DefenseTuning;
+    uint64 Hash = 0;                            // Checkpoint
+    TSharedPtr<const FBattleSnapshot> Snapshot; // Rewind
+
+    FBattleLogEntry() = default;
+    explicit FBattleLogEntry(EBattleLogRecord InType)
+        : Type(InType)
+    {
+    }
+};
+
+/**
+ * Compact binary log of every input a battle received, enough to replay it exactly.
+ *
+ * The header holds a seed and the battle's starting state. Each record is a one-byte tag, the
+ * varint tick delta since the previous record and a varint payload; floats are stored as raw bits
+ * so replays reproduce them exactly. Clock steps are not recorded, since the fixed-step rules give
+ * the same result however time was split into frames. A Rewind moves the clock back to its
+ * snapshot's tick, and later deltas count from there.
+ */
+class PROJECTHYPNOS_API FBattleActionLog
+{
+public:
+    static constexpr uint32 Magic = 0x474C4248; // "HBLG"
+    static constexpr uint16 Version = 2; // 2: FBattleSnapshot gained StateBeforePause
+
+    // Starts a new log from State, which should be the state before BattleSim::StartBattle
+    void Begin(const FBattleSimState& State, uint32 Seed);
+
+    bool IsRecording() const { return Bytes.Num() > 0; }
+    void Reset();
+
+    void Write(int64 Tick, const FBattleLogEntry& Entry);
+
+    // The log so far, closed with a checkpoint of FinalHash and an End record at Tick
+    void Finish(int64 Tick, uint64 FinalHash, TArray<uint8>& OutBytes) const;
+
+    int32 NumBytes() const { return Bytes.Num(); }
+
+private:
+    TArray<uint8> Bytes;
+    int64 LastTick = 0;
+};
+
+// Reads a log written by FBattleActionLog. Every read is bounds checked, so a truncated or
+// corrupt log fails instead of reading past the end.
+class PROJECTHYPNOS_API FBattleLogReader
+{
+public:
+    // Builds the starting state from the header. Skills and Ranti are content, not part of the log,
+    // so they are passed in and must be the tables the log was recorded with.
+    bool Open(TConstArrayView<uint8> InBytes, FBattleSimState& OutState, uint32& OutSeed, const FSkillTable* Skills, const FRantiRegistry* Ranti);
+
+    // False at the end of the log or on a corrupt record
+    bool Next(FBattleLogEntry& OutEntry);
+
+    int32 GetOffset() const { return Offset; }
+
+private:
+    TConstArrayView<uint8> Bytes;
+    int32 Offset = 0;
+    int64 LastTick = 0;
+    bool bAtEnd = true;
+};
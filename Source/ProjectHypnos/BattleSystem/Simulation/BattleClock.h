@@ -0,0 +1,72 @@
+// BattleClock.h
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Fixed-step battle time. The simulation only ever advances in whole ticks, and unit timers are
+ * integers, so timer expiry is bit-identical regardless of frame rate or machine.
+ */
+namespace BattleClock
+{
+    // Simulation step rate
+    constexpr int32 TicksPerSecond = 240;
+
+    // Timer speed (TFN) is fixed point: RateOne == 1.0x
+    constexpr int32 RateOne = 256;
+
+    // Timers count in sub-tick units so a TFN-scaled tick always removes a whole number of units
+    constexpr int64 TimerUnitsPerSecond = (int64)TicksPerSecond * RateOne;
+
+    inline int64 SecondsToTimerUnits(float Seconds)
+    {
+        return FMath::RoundToInt64((double)Seconds * TimerUnitsPerSecond);
+    }
+
+    inline float TimerUnitsToSeconds(int64 Units)
+    {
+        return (float)((double)Units / TimerUnitsPerSecond);
+    }
+
+    inline int32 MultiplierToRate(float Multiplier)
+    {
+        return FMath::RoundToInt32(Multiplier * RateOne);
+    }
+
+    inline float RateToMultiplier(int32 Rate)
+    {
+        return (float)Rate / RateOne;
+    }
+
+    inline int32 SecondsToTicks(float Seconds)
+    {
+        return FMath::RoundToInt32(Seconds * TicksPerSecond);
+    }
+
+    inline float TicksToSeconds(int64 Ticks)
+    {
+        return (float)((double)Ticks / TicksPerSecond);
+    }
+}
+
+// Turns variable frame deltas into whole battle ticks, carrying the remainder between frames
+struct FBattleClockAccumulator
+{
+    // Longest stretch a single frame may advance, so a debugger break or hitch doesn't fast-forward the battle
+    static constexpr double MaxFrameSeconds = 0.25;
+
+    double Accumulated = 0.0;
+
+    int32 Advance(float DeltaTime)
+    {
+        Accumulated += FMath::Min((double)DeltaTime, MaxFrameSeconds);
+        const int32 NumTicks = FMath::FloorToInt32(Accumulated * BattleClock::TicksPerSecond);
+        Accumulated -= (double)NumTicks / BattleClock::TicksPerSecond;
+        return NumTicks;
+    }
+
+    void Reset()
+    {
+        Accumulated = 0.0;
+    }
+};
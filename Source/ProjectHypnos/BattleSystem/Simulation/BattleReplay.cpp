@@ -0,0 +1,209 @@
+// BattleReplay.cpp
+#include "BattleReplay.h"
+#include "BattleSimRules.h"
+#include "BattleSimHash.h"
+
+namespace BattleSim
+{
+
+void ApplyLogEntry(FBattleSimState& State, const FBattleLogEntry& Entry)
+{
+    switch (Entry.Type)
+    {
+        case EBattleLogRecord::StartBattle:
+            StartBattle(State);
+            break;
+        case EBattleLogRecord::RetryBattle:
+            RetryBattle(State);
+            break;
+        case EBattleLogRecord::Action:
+            ExecuteAction(State, Entry.Action);
+            break;
+        case EBattleLogRecord::AttackBatch:
+            ApplyDamage(State, Entry.Damage.Attacker, Entry.Targets, Entry.Damage.Element, State.Tuning.BaseAttackDamage);
+            break;
+        case EBattleLogRecord::QueueDamage:
+            QueueDamage(State, Entry.Damage);
+            break;
+        case EBattleLogRecord::ResolveDamage:
+            ResolveDamage(State);
+            break;
+        case EBattleLogRecord::Defense:
+            ResolveDefense(State, Entry.Damage.Target, Entry.Damage.Attacker, Entry.Damage.Defense, Entry.Damage.TimingAccuracy, Entry.Damage.BaseDamage);
+            break;
+        case EBattleLogRecord::DefenseTuning:
+            State.DefenseTuning = Entry.DefenseTuning;
+            break;
+        case EBattleLogRecord::WeaknessHit:
+            HandleWeaknessHit(State, Entry.Damage.Attacker, Entry.Damage.Target, Entry.Damage.Element);
+            break;
+        case EBattleLogRecord::TFNToNextUnit:
+            ApplyTFNToNextUnit(State, Entry.Value);
+            break;
+        case EBattleLogRecord::AddStockpile:
+            AddStockpiledTime(State, Entry.Unit, Entry.Value);
+            break;
+        case EBattleLogRecord::EndTurn:
+            EndCurrentUnitTurn(State);
+            break;
+        case EBattleLogRecord::StartNextUnitTurn:
+            StartNextUnitTurn(State);
+            break;
+        case EBattleLogRecord::CheckSetCompletion:
+            CheckSetCompletion(State);
+            break;
+        case EBattleLogRecord::StartEnemyTurn:
+            StartEnemyTurn(State);
+            break;
+        case EBattleLogRecord::EndEnemyTurn:
+            EndEnemyTurn(State);
+            break;
+        case EBattleLogRecord::StartNewSet:
+            StartNewSet(State);
+            break;
+        case EBattleLogRecord::Pause:
+            PauseBattle(State);
+            break;
+        case EBattleLogRecord::Resume:
+            ResumeBattle(State);
+            break;
+        case EBattleLogRecord::AnimationStarted:
+            SetActionAnimationPlaying(State, true);
+            break;
+        case EBattleLogRecord::AnimationFinished:
+            SetActionAnimationPlaying(State, false);
+            break;
+        case EBattleLogRecord::Rewind:
+            RestoreSnapshot(State, *Entry.Snapshot);
+            break;
+        default:
+            break;
+    }
+}
+
+} // namespace BattleSim
+
+bool FBattleReplay::Open(TArray<uint8> InBytes, FBattleSimState& OutState, const FSkillTable* Skills, const FRantiRegistry* Ranti)
+{
+    Bytes = MoveTemp(InBytes);
+    bHasPending = false;
+    bDiscardEvents = false;
+    ObservedExpiries.Reset();
+    NumDesyncs = 0;
+    FirstDesyncOffset = INDEX_NONE;
+
+    bActive = Reader.Open(Bytes, OutState, Seed, Skills, Ranti);
+    RecordOffset = Reader.GetOffset();
+    return bActive;
+}
+
+void FBattleReplay::Desync()
+{
+    if (NumDesyncs++ == 0)
+    {
+        FirstDesyncOffset = RecordOffset;
+    }
+}
+
+void FBattleReplay::StepTo(FBattleSimState& State, int64 Tick)
+{
+    if (Tick <= State.ClockTick) return;
+
+    const int32 FirstEvent = State.Events.Num();
+    BattleSim::StepTicks(State, (int32)FMath::Min<int64>(Tick - State.ClockTick, MAX_int32));
+
+    for (int32 Index = FirstEvent; Index < State.Events.Num(); ++Index)
+    {
+        if (State.Events[Index].Type == EBattleSimEventType::TimerExpired)
+        {
+            ObservedExpiries.Add(State.Events[Index].Unit);
+        }
+    }
+}
+
+void FBattleReplay::Apply(FBattleSimState& State, const FBattleLogEntry& Entry)
+{
+    switch (Entry.Type)
+    {
+        case EBattleLogRecord::TimerExpired:
+            if (ObservedExpiries.Num() > 0 && ObservedExpiries[0] == Entry.Unit)
+            {
+                ObservedExpiries.RemoveAt(0);
+            }
+            else
+            {
+                Desync();
+            }
+            return;
+
+        case EBattleLogRecord::Checkpoint:
+            if (BattleSim::HashState(State) != Entry.Hash)
+            {
+                Desync();
+            }
+            return;
+
+        default:
+            break;
+    }
+
+    // The replay ran out a turn the recording never did
+    if (ObservedExpiries.Num() > 0)
+    {
+        Desync();
+        ObservedExpiries.Reset();
+    }
+
+    BattleSim::ApplyLogEntry(State, Entry);
+}
+
+bool FBattleReplay::Advance(FBattleSimState& State, int64 MaxTicks)
+{
+    if (!bActive) return false;
+
+    const int64 TargetTick = MaxTicks >= MAX_int64 - State.ClockTick ? MAX_int64 : State.ClockTick + MaxTicks;
+    for (;;)
+    {
+        if (!bHasPending)
+        {
+            RecordOffset = Reader.GetOffset();
+            if (!Reader.Next(Pending))
+            {
+                // Truncated or corrupt: stop where the good records end
+                bActive = false;
+                return false;
+            }
+            bHasPending = true;
+        }
+
+        if (Pending.Tick > TargetTick)
+        {
+            StepTo(State, TargetTick);
+            return true;
+        }
+
+        StepTo(State, Pending.Tick);
+        bHasPending = false;
+
+        if (Pending.Type == EBattleLogRecord::End)
+        {
+            bActive = false;
+            return false;
+        }
+
+        Apply(State, Pending);
+        if (bDiscardEvents)
+        {
+            State.Events.Reset();
+        }
+    }
+}
+
+void FBattleReplay::RunToEnd(FBattleSimState& State)
+{
+    bDiscardEvents = true;
+    while (Advance(State, MAX_int64))
+    {
+    }
+    bDiscardEvents = false;
+}
@@ -0,0 +1,56 @@
+// BattleReplay.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BattleActionLog.h"
+
+/**
+ * Plays an FBattleActionLog back into a state. Advance moves the clock like a frame would, so the
+ * same player runs a replay in the level at real time or headlessly in one call.
+ *
+ * Recorded timer expiries and checkpoints are compared against the replay as it goes; any
+ * difference counts as a desync and points at the record where the two first diverged.
+ */
+class PROJECTHYPNOS_API FBattleReplay
+{
+public:
+    // Takes a copy of the log and builds the starting state into OutState
+    bool Open(TArray<uint8> InBytes, FBattleSimState& OutState, const FSkillTable* Skills, const FRantiRegistry* Ranti);
+
+    // Plays up to MaxTicks of recorded time and every record inside it. Returns false once the log is done.
+    bool Advance(FBattleSimState& State, int64 MaxTicks);
+
+    // Headless: plays the whole log as fast as possible, dropping events as it goes
+    void RunToEnd(FBattleSimState& State);
+
+    bool IsActive() const { return bActive; }
+    uint32 GetSeed() const { return Seed; }
+    int32 GetNumDesyncs() const { return NumDesyncs; }
+    int32 GetFirstDesyncOffset() const { return FirstDesyncOffset; } // Byte offset of the record, or INDEX_NONE
+
+private:
+    void StepTo(FBattleSimState& State, int64 Tick);
+    void Apply(FBattleSimState& State, const FBattleLogEntry& Entry);
+    void Desync();
+
+    TArray<uint8> Bytes;
+    FBattleLogReader Reader;
+    FBattleLogEntry Pending;
+    bool bHasPending = false;
+    bool bActive = false;
+    bool bDiscardEvents = false;
+    uint32 Seed = 0;
+
+    // Expiries seen while stepping, waiting to be matched against TimerExpired records
+    TArray<int32, TInlineAllocator<4>> ObservedExpiries;
+
+    int32 NumDesyncs = 0;
+    int32 FirstDesyncOffset = INDEX_NONE;
+    int32 RecordOffset = 0;
+};
+
+namespace BattleSim
+{
+    // Applies one input record the way the live battle did. Verification records do nothing here.
+    PROJECTHYPNOS_API void ApplyLogEntry(FBattleSimState& State, const FBattleLogEntry& Entry);
+}
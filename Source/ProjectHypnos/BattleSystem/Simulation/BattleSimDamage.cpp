@@ -0,0 +1,222 @@
+// BattleSimDamage.cpp
+#include "BattleSimRules.h"
+#include "DefenseTable.h"
+
+namespace BattleSim
+{
+
+// A counter only answers a defended hit and is never defended itself, so real chains end after
+// two waves. The cap keeps a future rule from turning a chain into a loop.
+static constexpr int32 MaxDamageWaves = 8;
+
+static void EmitDamageEvents(FBattleSimState& State, int32 Target, const FBattleSimDamageResult& Result)
+{
+    State.Events.Emplace(EBattleSimEventType::Damage, Target, INDEX_NONE, Result.FinalDamage);
+    if (Result.bForcedOutOfEO)
+    {
+        State.Events.Emplace(EBattleSimEventType::EOFormExited, Target, INDEX_NONE, 1.0f);
+        State.Events.Emplace(EBattleSimEventType::StressedOut, Target);
+    }
+    if (Result.bDefeated)
+    {
+        State.Events.Emplace(EBattleSimEventType::UnitDefeated, Target);
+    }
+}
+
+// Stage 1: active defenses reduce the incoming hit
+static void ResolveDefenseStage(FBattleSimState& State, int32 Begin, int32 End)
+{
+    for (int32 Index = Begin; Index < End; ++Index)
+    {
+        const FDamageRequest& Request = State.PendingDamage[Index];
+        FResolvedDamage& Resolved = State.ResolvedDamage[Index];
+        Resolved.Damage = Request.BaseDamage;
+
+        if (Request.Defense == EDefenseType::None || !State.Units.IsValidIndex(Request.Target)) continue;
+
+        Resolved.DefenseResult = EvaluateDefenseResult(State.DefenseTuning, Request.Defense, Request.TimingAccuracy);
+        Resolved.Damage *= 1.0f - CalculateDamageReduction(State.DefenseTuning, Request.Defense, Resolved.DefenseResult);
+        State.Units.DefenseType[Request.Target] = Request.Defense;
+    }
+}
+
+// Stage 2: one table load per hit
+static void ResolveElementStage(FBattleSimState& State, int32 Begin, int32 End)
+{
+    for (int32 Index = Begin; Index < End; ++Index)
+    {
+        const FDamageRequest& Request = State.PendingDamage[Index];
+        if (!State.Units.IsValidIndex(Request.Target)) continue;
+
+        State.ResolvedDamage[Index].Multiplier = State.Units.GetElementalMultiplier(Request.Target, Request.Element);
+    }
+}
+
+// Stage 3: damage goes to the EO bar in EO form, otherwise to HP
+static void ResolveApplyStage(FBattleSimState& State, int32 Begin, int32 End)
+{
+    FCombatUnitStore& Units = State.Units;
+    for (int32 Index = Begin; Index < End; ++Index)
+    {
+        const int32 Target = State.PendingDamage[Index].Target;
+        if (!Units.IsValidIndex(Target) || !IsAlive(Units, Target)) continue;
+
+        // Damage can stop passive EO (KO, forced out of EO form), so bank what has accrued so far
+        SettleEO(Units, Target, State.ClockTick, State.Tuning);
+
+        FResolvedDamage& Resolved = State.ResolvedDamage[Index];
+        Resolved.Hit = ApplyHit(Units, Target, Resolved.Multiplier, Resolved.Damage * Resolved.Multiplier, State.Tuning);
+        EmitDamageEvents(State, Target, Resolved.Hit);
+    }
+}
+
+// Stage 4: EO rewards for defending, and counters queued as the next wave
+static void ResolveDefenseRewardStage(FBattleSimState& State, int32 Begin, int32 End)
+{
+    for (int32 Index = Begin; Index < End; ++Index)
+    {
+        // Copied, since queueing a counter can reallocate PendingDamage
+        const FDamageRequest Request = State.PendingDamage[Index];
+        if (Request.Defense == EDefenseType::None || !State.Units.IsValidIndex(Request.Target)) continue;
+
+        const EDefenseResult Result = State.ResolvedDamage[Index].DefenseResult;
+        const float EOGain = CalculateEOGain(State.DefenseTuning, Request.Defense, Request.TimingAccuracy);
+        if (EOGain > 0.0f)
+        {
+            GainEO(State.Units, Request.Target, EOGain);
+        }
+
+        State.Events.Emplace(EBattleSimEventType::DefenseResolved, Request.Target, Request.Attacker, (float)Result);
+
+        if (ShouldTriggerCounter(Request.Defense, Result) && State.Units.IsValidIndex(Request.Attacker))
+        {
+            State.Events.Emplace(EBattleSimEventType::CounterAttack, Request.Target, Request.Attacker);
+
+            FDamageRequest Counter;
+            Counter.Attacker = Request.Target;
+            Counter.Target = Request.Attacker;
+            Counter.Element = EElementalType::Physical;
+            Counter.BaseDamage = State.Tuning.BaseAttackDamage;
+            QueueDamage(State, Counter);
+        }
+    }
+}
+
+// Stage 5: SP and TFN are rewarded once per attacker, however many weak targets it hit
+static void ResolveWeaknessStage(FBattleSimState& State, int32 Begin, int32 End)
+{
+    TArray<int32, TInlineAllocator<8>> RewardedAttackers;
+    for (int32 Index = Begin; Index < End; ++Index)
+    {
+        const FDamageRequest& Request = State.PendingDamage[Index];
+        if (!Request.bRewardsWeakness || !State.ResolvedDamage[Index].Hit.IsWeaknessHit()) continue;
+        if (!State.Units.IsValidIndex(Request.Attacker) || RewardedAttackers.Contains(Request.Attacker)) continue;
+
+        RewardedAttackers.Add(Request.Attacker);
+        HandleWeaknessHit(State, Request.Attacker, Request.Target, Request.Element);
+    }
+}
+
+void QueueDamage(FBattleSimState& State, const FDamageRequest& Request)
+{
+    State.PendingDamage.Add(Request);
+}
+
+void ResolveDamage(FBattleSimState& State)
+{
+    State.ResolvedDamage.Reset();
+
+    // Each wave runs every stage over a contiguous slice of the queue. Counters raised by a wave
+    // are appended behind it and become the next wave.
+    int32 Begin = 0;
+    for (int32 Wave = 0; Wave < MaxDamageWaves && Begin < State.PendingDamage.Num(); ++Wave)
+    {
+        const int32 End = State.PendingDamage.Num();
+        State.ResolvedDamage.AddDefaulted(End - Begin);
+
+        ResolveDefenseStage(State, Begin, End);
+        ResolveElementStage(State, Begin, End);
+        ResolveApplyStage(State, Begin, End);
+        ResolveDefenseRewardStage(State, Begin, End);
+        ResolveWeaknessStage(State, Begin, End);
+
+        Begin = End;
+    }
+
+    State.PendingDamage.Reset();
+}
+
+FBattleSimDamageBatchResult ApplyDamage(FBattleSimState& State, int32 Attacker, TConstArrayView<int32> Targets, EElementalType ElementType, float BaseDamage)
+{
+    // Anything queued earlier resolves with this attack; our results follow it. Targets past the
+    // mask width are dropped rather than asserted on, since a replayed log can ask for any count.
+    const int32 First = State.PendingDamage.Num();
+    const int32 NumTargets = FMath::Min(Targets.Num(), MaxDamageBatchTargets);
+
+    for (int32 Index = 0; Index < NumTargets; ++Index)
+    {
+        FDamageRequest Request;
+        Request.Attacker = Attacker;
+        Request.Target = Targets[Index];
+        Request.Element = ElementType;
+        Request.BaseDamage = BaseDamage;
+        QueueDamage(State, Request);
+    }
+
+    ResolveDamage(State);
+
+    FBattleSimDamageBatchResult Batch;
+    for (int32 Index = 0; Index < NumTargets; ++Index)
+    {
+        const FBattleSimDamageResult& Result = State.ResolvedDamage[First + Index].Hit;
+        Batch.TotalDamage += Result.FinalDamage;
+        Batch.WeaknessMask |= (uint64)Result.IsWeaknessHit() << Index;
+        Batch.DefeatedMask |= (uint64)Result.bDefeated << Index;
+    }
+    return Batch;
+}
+
+FBattleSimDamageResult DamageUnit(FBattleSimState& State, int32 Target, float DamageAmount, EElementalType ElementType)
+{
+    if (!State.Units.IsValidIndex(Target)) return FBattleSimDamageResult();
+
+    const int32 First = State.PendingDamage.Num();
+
+    FDamageRequest Request;
+    Request.Target = Target;
+    Request.Element = ElementType;
+    Request.BaseDamage = DamageAmount;
+    Request.bRewardsWeakness = false;
+    QueueDamage(State, Request);
+
+    ResolveDamage(State);
+    return State.ResolvedDamage[First].Hit;
+}
+
+EDefenseResult ResolveDefense(FBattleSimState& State, int32 Defender, int32 Attacker, EDefenseType DefenseType, float TimingAccuracy, float Damage)
+{
+    if (!State.Units.IsValidIndex(Defender)) return EDefenseResult::Failure;
+
+    // Same formation lookup the defense prompts use. A defense the quadrant does not allow counts as none.
+    if (!GetDefenseOptions(State.Formation, State.Units.Position[Defender]).IsAvailable(DefenseType))
+    {
+        DefenseType = EDefenseType::None;
+    }
+
+    const int32 First = State.PendingDamage.Num();
+
+    FDamageRequest Request;
+    Request.Attacker = Attacker;
+    Request.Target = Defender;
+    Request.Element = EElementalType::Physical;
+    Request.BaseDamage = Damage;
+    Request.Defense = DefenseType;
+    Request.TimingAccuracy = TimingAccuracy;
+    Request.bRewardsWeakness = false;
+    QueueDamage(State, Request);
+
+    ResolveDamage(State);
+    return State.ResolvedDamage[First].DefenseResult;
+}
+
+} // namespace BattleSim
@@ -0,0 +1,50 @@
+// BattleSimHash.cpp
+#include "BattleSimHash.h"
+#include "BattleSimState.h"
+
+namespace BattleSim
+{
+
+// SplitMix64 finalizer
+static uint64 Mix64(uint64 Value)
+{
+    Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+    return Value ^ (Value >> 31);
+}
+
+uint64 ZobristKey(int32 Unit, EBattleSimHashField Field, int64 Value)
+{
+    // Unit and field go through their own round so (Unit, Field) pairs never share a key stream
+    const uint64 Feature = ((uint64)(uint32)Unit << 8) | (uint64)Field;
+    return Mix64(Mix64(Feature + 0x9E3779B97F4A7C15ull) ^ (uint64)Value);
+}
+
+int64 HashBucket(float Value, float BucketSize)
+{
+    return (int64)FMath::FloorToInt(Value / BucketSize);
+}
+
+uint64 HashState(const FBattleSimState& State)
+{
+    // A writer that forgot RehashUnit shows up here in debug builds
+    checkSlow(State.Units.GetHash() == State.Units.ComputeHash());
+
+    // Whose turn it is also covers the phase, so the same unit index on the enemy turn differs.
+    // A paused battle also keys the phase it will resume into.
+    const int64 ResumeState = State.BattleState == EBattleState::Paused ? (int64)State.StateBeforePause << 40 : 0;
+    const int64 Turn = ResumeState | ((int64)State.BattleState << 32) | ((int64)State.bIsSetComplete << 31) | (uint32)State.CurrentUnitIndex;
+
+    return State.Units.GetHash()
+        ^ ZobristKey(INDEX_NONE, EBattleSimHashField::SetNumber, State.CurrentSetNumber)
+        ^ ZobristKey(INDEX_NONE, EBattleSimHashField::Turn, Turn)
+        ^ ZobristKey(INDEX_NONE, EBattleSimHashField::TurnTimer, State.CurrentTimerRemaining / HashTimerBucket)
+        ^ ZobristKey(INDEX_NONE, EBattleSimHashField::TFN, State.bTFNActive ? State.TFNRate : 0);
+}
+
+uint64 HashPlanningState(const FBattleSimState& State)
+{
+    return State.Units.GetStatHash() ^ ZobristKey(INDEX_NONE, EBattleSimHashField::SetNumber, State.CurrentSetNumber);
+}
+
+} // namespace BattleSim
@@ -0,0 +1,53 @@
+// BattleSimHash.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BattleClock.h"
+
+struct FBattleSimState;
+
+// What a Zobrist key describes. Unit fields are keyed per unit, turn fields per battle.
+enum class EBattleSimHashField : uint8
+{
+    HP,
+    EO,
+    MP,
+    Position,
+    Status,
+    Stockpile,
+    Timer,
+    TickRate,
+    SetNumber,
+    Turn,
+    TurnTimer,
+    TFN,
+    EnemyOrdinal // Search only: which enemy acts next within the enemy phase
+};
+
+/**
+ * Zobrist hashing of battle state. A hash is the XOR of one key per (unit, field, value) feature,
+ * so changing a field swaps its old key for the new one in O(1). FCombatUnitStore keeps the unit
+ * part current; turn fields are few and keyed when the hash is read.
+ *
+ * Floats are hashed by bucket, so values that play the same hash the same.
+ */
+namespace BattleSim
+{
+    constexpr float HashHPBucket = 1.0f;
+    constexpr float HashEOBucket = 10.0f;
+    constexpr float HashMPBucket = 5.0f;
+    constexpr int64 HashTimerBucket = BattleClock::TimerUnitsPerSecond;
+
+    // Keys are a fixed mix of the feature rather than a random table, so values need no range and
+    // every build and machine agrees on them (replays compare hashes across runs).
+    PROJECTHYPNOS_API uint64 ZobristKey(int32 Unit, EBattleSimHashField Field, int64 Value);
+    PROJECTHYPNOS_API int64 HashBucket(float Value, float BucketSize);
+
+    // Full state: every unit, timers included, plus set number, whose turn it is, the active timer and TFN
+    PROJECTHYPNOS_API uint64 HashState(const FBattleSimState& State);
+
+    // What an enemy plan depends on: unit stats, positions and status plus the set number. Turn
+    // and timer state is left out, so the hash taken during the player phase matches the one
+    // taken when the enemy turn starts.
+    PROJECTHYPNOS_API uint64 HashPlanningState(const FBattleSimState& State);
+}
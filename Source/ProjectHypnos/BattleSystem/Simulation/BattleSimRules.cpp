@@ -0,0 +1,919 @@
+// BattleSimRules.cpp
+#include "BattleSimRules.h"
+#include "DefenseTable.h"
+
+namespace BattleSim
+{
+
+// The new state travels with the event, since several changes can be queued before a flush
+static void EmitBattleStateChanged(FBattleSimState& State)
+{
+    State.Events.Emplace(EBattleSimEventType::BattleStateChanged, INDEX_NONE, INDEX_NONE, (float)State.BattleState);
+}
+
+static void EmitSetStarted(FBattleSimState& State)
+{
+    State.Events.Emplace(EBattleSimEventType::SetStarted, INDEX_NONE, INDEX_NONE, (float)State.CurrentSetNumber);
+}
+
+// ---------------------------------------------------------------------------
+// Unit rules
+// ---------------------------------------------------------------------------
+
+bool IsAlive(const FCombatUnitStore& Units, int32 Unit)
+{
+    return Units.CurrentHP[Unit] > 0;
+}
+
+bool CanAct(const FCombatUnitStore& Units, int32 Unit)
+{
+    return IsAlive(Units, Unit) && !Units.bIsIncapacitated[Unit];
+}
+
+void ResetTimer(FCombatUnitStore& Units, int32 Unit)
+{
+    Units.TimerRemaining[Unit] = Units.TimerDuration[Unit] + Units.StockpiledTime[Unit];
+    Units.StockpiledTime[Unit] = 0; // Reset stockpiled time after using it
+    Units.TimerTickRate[Unit] = BattleClock::RateOne; // Reset TFN effect
+    Units.RehashUnit(Unit);
+}
+
+void ResetForBattle(FCombatUnitStore& Units, int32 Unit)
+{
+    Units.CurrentHP[Unit] = Units.MaxHP[Unit];
+    Units.CurrentEO[Unit] = 0.0f;
+    Units.CurrentMP[Unit] = 0.0f;
+    Units.bIsInEOForm[Unit] = false;
+    Units.bIsStressedOut[Unit] = false;
+    Units.bIsIncapacitated[Unit] = false;
+    Units.EOGainRate[Unit] = 1.0f;
+    Units.StockpiledTime[Unit] = 0;
+    ResetTimer(Units, Unit);
+}
+
+float ApplyTFN(FCombatUnitStore& Units, int32 Unit, float SpeedMultiplier, const FBattleSimTuning& Tuning)
+{
+    Units.TimerTickRate[Unit] = BattleClock::MultiplierToRate(FMath::Max(Tuning.MinTFNMultiplier, SpeedMultiplier)); // Capped at 0.25x speed
+    Units.RehashUnit(Unit);
+    return BattleClock::RateToMultiplier(Units.TimerTickRate[Unit]);
+}
+
+void AddStockpiledTime(FCombatUnitStore& Units, int32 Unit, float TimeToAdd)
+{
+    Units.StockpiledTime[Unit] += BattleClock::SecondsToTimerUnits(TimeToAdd);
+    Units.RehashUnit(Unit);
+}
+
+bool GainEO(FCombatUnitStore& Units, int32 Unit, float Amount)
+{
+    if (Units.bIsInEOForm[Unit]) return false; // Can't gain EO while in EO form
+
+    float ActualGain = Amount * Units.EOGainRate[Unit];
+    Units.CurrentEO[Unit] = FMath::Clamp(Units.CurrentEO[Unit] + ActualGain, 0.0f, Units.MaxEO[Unit]);
+    Units.RehashUnit(Unit);
+
+    return Units.CurrentEO[Unit] >= Units.MaxEO[Unit];
+}
+
+float GetCurrentEO(const FCombatUnitStore& Units, int32 Unit, int64 NowTick, const FBattleSimTuning& Tuning)
+{
+    // Passive EO gain over time (very small). The rate is constant between settles, so the gain is linear.
+    const int64 Elapsed = NowTick - Units.EOSettledTick[Unit];
+    const bool bAccrues = !Units.bIsInEOForm[Unit] && IsAlive(Units, Unit) && Elapsed > 0;
+    return FCombatUnitStore::ComputeSettledEO(Units.CurrentEO[Unit], Units.MaxEO[Unit], Units.EOGainRate[Unit], Elapsed, bAccrues, Tuning.PassiveEOPerSecond);
+}
+
+void SettleEO(FCombatUnitStore& Units, int32 Unit, int64 NowTick, const FBattleSimTuning& Tuning)
+{
+    Units.CurrentEO[Unit] = GetCurrentEO(Units, Unit, NowTick, Tuning);
+    Units.EOSettledTick[Unit] = NowTick;
+    Units.RehashUnit(Unit);
+}
+
+bool CanTransformToEO(const FCombatUnitStore& Units, int32 Unit)
+{
+    return Units.CurrentEO[Unit] >= Units.MaxEO[Unit] && !Units.bIsInEOForm[Unit] && IsAlive(Units, Unit);
+}
+
+bool TransformToEO(FCombatUnitStore& Units, int32 Unit)
+{
+    if (!CanTransformToEO(Units, Unit)) return false;
+
+    Units.bIsInEOForm[Unit] = true;
+    Units.CurrentMP[Unit] = Units.MaxMP[Unit]; // Gain access to MP
+    Units.RehashUnit(Unit);
+
+    // TODO: Apply stat boosts here
+    return true;
+}
+
+bool ExitEOForm(FCombatUnitStore& Units, int32 Unit, bool bForced, const FBattleSimTuning& Tuning)
+{
+    if (!Units.bIsInEOForm[Unit]) return false;
+
+    Units.bIsInEOForm[Unit] = false;
+    Units.CurrentEO[Unit] = 0.0f;
+    Units.CurrentMP[Unit] = 0.0f;
+    Units.RehashUnit(Unit);
+
+    if (bForced)
+    {
+        ApplyStressedOut(Units, Unit, Tuning);
+    }
+    return true;
+}
+
+void ApplyStressedOut(FCombatUnitStore& Units, int32 Unit, const FBattleSimTuning& Tuning)
+{
+    Units.bIsStressedOut[Unit] = true;
+    Units.EOGainRate[Unit] = Tuning.StressedOutEOGainRate; // Slower EO gain
+
+    // Set HP to 25% if it's higher than that
+    Units.CurrentHP[Unit] = FMath::Min(Units.CurrentHP[Unit], Units.MaxHP[Unit] * Tuning.StressedOutHPFraction);
+    Units.RehashUnit(Unit);
+}
+
+float GetElementalDamageMultiplier(const TArray<FElementalResistance>& Resistances, EElementalType AttackElement)
+{
+    for (const FElementalResistance& Resistance : Resistances)
+    {
+        if (Resistance.ElementType == AttackElement)
+        {
+            return Resistance.ResistanceMultiplier;
+        }
+    }
+    return 1.0f; // No special resistance/weakness
+}
+
+float GetElementalDamageMultiplier(const FCombatUnitStore& Units, int32 Unit, EElementalType AttackElement)
+{
+    return Units.GetElementalMultiplier(Unit, AttackElement);
+}
+
+FBattleSimDamageResult ApplyHit(FCombatUnitStore& Units, int32 Unit, float Multiplier, float FinalDamage, const FBattleSimTuning& Tuning)
+{
+    FBattleSimDamageResult Result;
+    if (!IsAlive(Units, Unit)) return Result;
+
+    Result.Multiplier = Multiplier;
+    Result.FinalDamage = FinalDamage;
+
+    if (Units.bIsInEOForm[Unit])
+    {
+        // In EO form, damage goes to EO bar instead of HP
+        Result.bHitEO = true;
+        Units.CurrentEO[Unit] -= Result.FinalDamage;
+        Units.RehashUnit(Unit);
+        if (Units.CurrentEO[Unit] <= 0.0f)
+        {
+            Result.bForcedOutOfEO = ExitEOForm(Units, Unit, true, Tuning);
+        }
+    }
+    else
+    {
+        Units.CurrentHP[Unit] = FMath::Max(0.0f, Units.CurrentHP[Unit] - Result.FinalDamage);
+        Units.RehashUnit(Unit);
+        Result.bDefeated = Units.CurrentHP[Unit] <= 0.0f;
+    }
+
+    return Result;
+}
+
+FBattleSimDamageResult TakeDamage(FCombatUnitStore& Units, int32 Unit, float DamageAmount, EElementalType ElementType, const FBattleSimTuning& Tuning)
+{
+    const float Multiplier = GetElementalDamageMultiplier(Units, Unit, ElementType);
+    return ApplyHit(Units, Unit, Multiplier, DamageAmount * Multiplier, Tuning);
+}
+
+// ---------------------------------------------------------------------------
+// Defense math
+// ---------------------------------------------------------------------------
+
+bool CanUseGuard(int32 UnitCountAtPosition)
+{
+    // Guard can only be used when multiple units are in the same position
+    return UnitCountAtPosition >= 2;
+}
+
+bool CanUseParry(int32 UnitCountAtPosition)
+{
+    // Parry can only be used when a single unit is alone in a position
+    return UnitCountAtPosition == 1;
+}
+
+bool CanUseDodge(int32 UnitCountAtPosition)
+{
+    // Dodge can be used in any position
+    return true;
+}
+
+EDefenseResult EvaluateDefenseResult(const FBattleSimDefenseTuning& Tuning, EDefenseType DefenseType, float TimingAccuracy)
+{
+    switch (DefenseType)
+    {
+        case EDefenseType::Dodge:
+            if (TimingAccuracy <= Tuning.DodgePerfectWindow)
+                return EDefenseResult::Success;
+            else if (TimingAccuracy <= Tuning.DodgeGoodWindow)
+                return EDefenseResult::Partial;
+            else
+                return EDefenseResult::Failure;
+
+        case EDefenseType::Parry:
+            if (TimingAccuracy <= Tuning.ParryPerfectWindow)
+                return EDefenseResult::Counter; // Perfect parry = counter attack
+            else if (TimingAccuracy <= Tuning.ParryGoodWindow)
+                return EDefenseResult::Success;
+            else
+                return EDefenseResult::Failure;
+
+        case EDefenseType::Guard:
+            return EDefenseResult::Success; // Guard always works
+
+        default:
+            return EDefenseResult::Failure;
+    }
+}
+
+float CalculateDamageReduction(const FBattleSimDefenseTuning& Tuning, EDefenseType DefenseType, EDefenseResult Result)
+{
+    switch (DefenseType)
+    {
+        case EDefenseType::Guard:
+            return Tuning.GuardDamageReduction;
+
+        case EDefenseType::Dodge:
+            if (Result == EDefenseResult::Success)
+                return Tuning.DodgeDamageReduction;
+            else if (Result == EDefenseResult::Partial)
+                return Tuning.DodgeDamageReduction * 0.5f; // Partial dodge
+            else
+                return 0.0f; // Failed dodge
+
+        case EDefenseType::Parry:
+            if (Result == EDefenseResult::Success || Result == EDefenseResult::Counter)
+                return Tuning.ParryDamageReduction;
+            else
+                return 0.0f; // Failed parry
+
+        default:
+            return 0.0f;
+    }
+}
+
+float CalculateEOGain(const FBattleSimDefenseTuning& Tuning, EDefenseType DefenseType, float TimingAccuracy)
+{
+    float BaseEOGain = 0.0f;
+
+    switch (DefenseType)
+    {
+        case EDefenseType::Guard:
+            BaseEOGain = Tuning.GuardEOGain;
+            break;
+        case EDefenseType::Dodge:
+            BaseEOGain = Tuning.DodgeEOGain;
+            break;
+        case EDefenseType::Parry:
+            BaseEOGain = Tuning.ParryEOGain;
+            break;
+        default:
+            return 0.0f;
+    }
+
+    // Apply timing accuracy modifier
+    float TimingMultiplier = 1.0f - TimingAccuracy; // Better timing = more EO
+    return BaseEOGain * TimingMultiplier;
+}
+
+bool ShouldTriggerCounter(EDefenseType DefenseType, EDefenseResult Result)
+{
+    return DefenseType == EDefenseType::Parry && Result == EDefenseResult::Counter;
+}
+
+float GetDefenseDifficulty(EDefenseType DefenseType, int32 UnitCountAtPosition)
+{
+    switch (DefenseType)
+    {
+        case EDefenseType::Dodge:
+            // Dodge is easier when alone
+            return UnitCountAtPosition == 1 ? 0.5f : 1.0f;
+
+        case EDefenseType::Parry:
+            // Parry is always difficult
+            return 2.0f;
+
+        case EDefenseType::Guard:
+            // Guard is always easy
+            return 0.1f;
+
+        default:
+            return 1.0f;
+    }
+}
+
+float GetPositionMultiplier(EBattlePosition Position)
+{
+    // Position can affect defense difficulty
+    switch (Position)
+    {
+        case EBattlePosition::North:
+        case EBattlePosition::South:
+            return 1.0f; // Standard difficulty
+        case EBattlePosition::East:
+        case EBattlePosition::West:
+            return 1.2f; // Slightly harder
+        default:
+            return 1.0f;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// State queries
+// ---------------------------------------------------------------------------
+
+static void AddToPosition(FBattleSimState& State, EBattlePosition Position, int32 Delta)
+{
+    if ((int32)Position >= (int32)UE_ARRAY_COUNT(State.PositionCounts)) return;
+
+    uint8& Count = State.PositionCounts[(int32)Position];
+    Count = (uint8)(Count + Delta);
+    State.Formation = SetFormationCount(State.Formation, Position, Count);
+}
+
+int32 AddUnit(FBattleSimState& State, const FBattleSimUnit& Unit)
+{
+    const int32 Index = State.Units.Add(Unit);
+    AddToPosition(State, Unit.Position, 1);
+    if (Unit.UnitType == EUnitType::Player)
+    {
+        State.PlayerOrder.Add(Index);
+    }
+    else
+    {
+        State.EnemyIndices.Add(Index);
+    }
+    return Index;
+}
+
+int32 GetCurrentUnit(const FBattleSimState& State)
+{
+    return State.PlayerOrder.IsValidIndex(State.CurrentUnitIndex) ? State.PlayerOrder[State.CurrentUnitIndex] : INDEX_NONE;
+}
+
+int32 CountUnitsAtPosition(const FBattleSimState& State, EBattlePosition Position)
+{
+    return (int32)Position < (int32)UE_ARRAY_COUNT(State.PositionCounts) ? State.PositionCounts[(int32)Position] : 0;
+}
+
+void RebuildFormation(FBattleSimState& State)
+{
+    FMemory::Memzero(State.PositionCounts, sizeof(State.PositionCounts));
+    State.Formation = 0;
+    for (int32 Unit = 0; Unit < State.Units.Num(); ++Unit)
+    {
+        AddToPosition(State, State.Units.Position[Unit], 1);
+    }
+}
+
+bool IsBattleOver(const FBattleSimState& State)
+{
+    return State.BattleState == EBattleState::Victory || State.BattleState == EBattleState::Defeat;
+}
+
+int64 GetTimerRemaining(const FBattleSimState& State)
+{
+    if (State.DrainingUnit == INDEX_NONE)
+    {
+        return State.CurrentTimerRemaining;
+    }
+
+    const int64 Elapsed = State.ClockTick - State.TimerSettledTick;
+    return FMath::Max<int64>(0, State.CurrentTimerRemaining - Elapsed * State.TFNRate);
+}
+
+// Writes the drained time back into the active unit and stops the timer. Call before anything that
+// starts, stops or rescales it, and follow up with ScheduleTurnDeadline once the turn state is final.
+static void SettleTurnTimer(FBattleSimState& State)
+{
+    if (State.DrainingUnit != INDEX_NONE)
+    {
+        State.CurrentTimerRemaining = GetTimerRemaining(State);
+        State.Units.TimerRemaining[State.DrainingUnit] = State.CurrentTimerRemaining;
+        State.Units.RehashUnit(State.DrainingUnit);
+        State.DrainingUnit = INDEX_NONE;
+    }
+    State.TimerSettledTick = State.ClockTick;
+    State.TurnDeadlineTick = MAX_int64;
+}
+
+static void ScheduleTurnDeadline(FBattleSimState& State)
+{
+    State.TimerSettledTick = State.ClockTick;
+    State.TurnDeadlineTick = MAX_int64;
+    State.DrainingUnit = INDEX_NONE;
+
+    // The active timer only drains during a player turn, outside action animations
+    if (State.BattleState != EBattleState::PlayerTurn || State.bIsSetComplete || GetCurrentUnit(State) == INDEX_NONE)
+    {
+        return;
+    }
+
+    if (!State.bIsActionAnimationPlaying)
+    {
+        State.DrainingUnit = GetCurrentUnit(State);
+
+        // A turn always lasts at least one tick, even with no time left
+        const int64 TicksLeft = (State.CurrentTimerRemaining + State.TFNRate - 1) / State.TFNRate;
+        State.TurnDeadlineTick = State.ClockTick + FMath::Max<int64>(1, TicksLeft);
+    }
+    else if (State.CurrentTimerRemaining <= 0)
+    {
+        // Animations pause the timer but not a turn that has already run out
+        State.TurnDeadlineTick = State.ClockTick + 1;
+    }
+}
+
+// Restarts the battle clock at tick 0, carrying any EO accrued on the old clock
+static void ResetClock(FBattleSimState& State)
+{
+    State.Units.SettleEO(State.ClockTick, State.Tuning.PassiveEOPerSecond);
+    for (int64& SettledTick : State.Units.EOSettledTick)
+    {
+        SettledTick = 0;
+    }
+
+    State.ClockTick = 0;
+    State.TimerSettledTick = 0;
+    State.TurnDeadlineTick = MAX_int64;
+    State.DrainingUnit = INDEX_NONE;
+}
+
+// ---------------------------------------------------------------------------
+// Turn flow
+// ---------------------------------------------------------------------------
+
+void StartBattle(FBattleSimState& State)
+{
+    State.BattleState = EBattleState::PlayerTurn;
+    State.StateBeforePause = EBattleState::PlayerTurn;
+    State.CurrentUnitIndex = 0;
+    State.CurrentSetNumber = 1;
+    State.bIsSetComplete = false;
+    State.CurrentTimerRemaining = BattleClock::SecondsToTimerUnits(State.Tuning.BaseTimerDuration);
+    ResetClock(State);
+    State.bTFNActive = false;
+    State.TFNRate = BattleClock::RateOne;
+
+    // Reset all player units, start all units in West
+    for (int32 UnitIndex : State.PlayerOrder)
+    {
+        ResetForBattle(State.Units, UnitIndex);
+        State.Units.Position[UnitIndex] = EBattlePosition::West;
+        State.Units.RehashUnit(UnitIndex);
+    }
+    RebuildFormation(State);
+
+    StartNextUnitTurn(State);
+    EmitBattleStateChanged(State);
+    EmitSetStarted(State);
+}
+
+void RetryBattle(FBattleSimState& State)
+{
+    State.BattleState = EBattleState::PlayerTurn;
+    State.StateBeforePause = EBattleState::PlayerTurn;
+    State.CurrentUnitIndex = 0;
+    State.CurrentSetNumber = 1;
+    State.bIsSetComplete = false;
+    ResetClock(State);
+    State.bTFNActive = false;
+    State.TFNRate = BattleClock::RateOne;
+    State.bIsActionAnimationPlaying = false;
+    State.PendingDamage.Reset(); // Hits from the lost attempt never land
+
+    for (int32 UnitIndex : State.PlayerOrder)
+    {
+        ResetForBattle(State.Units, UnitIndex);
+        State.Units.Position[UnitIndex] = EBattlePosition::West;
+        State.Units.RehashUnit(UnitIndex);
+    }
+
+    for (int32 UnitIndex : State.EnemyIndices)
+    {
+        ResetForBattle(State.Units, UnitIndex);
+        State.Units.Position[UnitIndex] = EBattlePosition::Center;
+        State.Units.RehashUnit(UnitIndex);
+    }
+    RebuildFormation(State);
+
+    StartNextUnitTurn(State);
+    EmitBattleStateChanged(State);
+    EmitSetStarted(State);
+}
+
+void StepTicks(FBattleSimState& State, int32 NumTicks)
+{
+    if (NumTicks <= 0 || CheckBattleEndConditions(State)) return;
+
+    // Passive EO and the active timer are settled lazily, so the only thing that can happen
+    // inside a step is the turn deadline. Jump from deadline to deadline instead of stepping every tick.
+    const int64 TargetTick = State.ClockTick + NumTicks;
+    while (State.TurnDeadlineTick <= TargetTick)
+    {
+        State.ClockTick = State.TurnDeadlineTick;
+
+        // Current unit's time is up
+        State.Events.Emplace(EBattleSimEventType::TimerExpired, GetCurrentUnit(State));
+        EndCurrentUnitTurn(State);
+        if (CheckBattleEndConditions(State)) return;
+    }
+
+    State.ClockTick = TargetTick;
+}
+
+void StartNextUnitTurn(FBattleSimState& State)
+{
+    SettleTurnTimer(State);
+
+    const int32 UnitIndex = GetCurrentUnit(State);
+    if (UnitIndex == INDEX_NONE) return;
+
+    // If unit cannot act (KO or incapacitated), immediately skip
+    if (!CanAct(State.Units, UnitIndex))
+    {
+        EndCurrentUnitTurn(State);
+        return;
+    }
+
+    State.CurrentTimerRemaining = State.Units.TimerRemaining[UnitIndex];
+
+    // Apply TFN effect if active
+    if (State.bTFNActive)
+    {
+        const float AppliedMultiplier = ApplyTFN(State.Units, UnitIndex, BattleClock::RateToMultiplier(State.TFNRate), State.Tuning);
+        State.bTFNActive = false; // Reset TFN after applying
+        State.Events.Emplace(EBattleSimEventType::TFNApplied, UnitIndex, INDEX_NONE, AppliedMultiplier);
+    }
+
+    ScheduleTurnDeadline(State);
+    State.Events.Emplace(EBattleSimEventType::UnitTurnStarted, UnitIndex);
+}
+
+void EndCurrentUnitTurn(FBattleSimState& State)
+{
+    // Leftover time stays with the unit for the next cycle of the set
+    SettleTurnTimer(State);
+
+    const int32 CurrentUnit = GetCurrentUnit(State);
+    if (CurrentUnit != INDEX_NONE)
+    {
+        State.Events.Emplace(EBattleSimEventType::UnitTurnEnded, CurrentUnit);
+    }
+
+    // Move to next unit
+    State.CurrentUnitIndex++;
+
+    if (State.CurrentUnitIndex < State.PlayerOrder.Num())
+    {
+        StartNextUnitTurn(State);
+        return;
+    }
+
+    // Completed a full cycle: continue the set only if a unit that can still act has time left.
+    // Units that are KO'd or incapacitated are skipped, otherwise their leftover time would cycle forever.
+    bool bAnyUnitHasTime = false;
+    for (int32 UnitIndex : State.PlayerOrder)
+    {
+        if (CanAct(State.Units, UnitIndex) && State.Units.TimerRemaining[UnitIndex] > 0)
+        {
+            bAnyUnitHasTime = true;
+            break;
+        }
+    }
+
+    if (bAnyUnitHasTime)
+    {
+        // Continue the set with remaining time
+        State.CurrentUnitIndex = 0;
+        StartNextUnitTurn(State);
+    }
+    else
+    {
+        State.bIsSetComplete = true;
+        State.Events.Emplace(EBattleSimEventType::SetComplete);
+        StartEnemyTurn(State);
+    }
+}
+
+void CheckSetCompletion(FBattleSimState& State)
+{
+    SettleTurnTimer(State);
+
+    for (int32 UnitIndex : State.PlayerOrder)
+    {
+        if (State.Units.TimerRemaining[UnitIndex] > 0)
+        {
+            ScheduleTurnDeadline(State);
+            return;
+        }
+    }
+
+    State.bIsSetComplete = true;
+    State.Events.Emplace(EBattleSimEventType::SetComplete);
+    StartEnemyTurn(State);
+}
+
+void StartEnemyTurn(FBattleSimState& State)
+{
+    SettleTurnTimer(State);
+    State.BattleState = EBattleState::EnemyTurn;
+    ScheduleTurnDeadline(State);
+    State.Events.Emplace(EBattleSimEventType::EnemyTurnStarted);
+    EmitBattleStateChanged(State);
+}
+
+void EndEnemyTurn(FBattleSimState& State)
+{
+    SettleTurnTimer(State);
+    State.BattleState = EBattleState::PlayerTurn;
+    State.CurrentUnitIndex = 0;
+    State.CurrentSetNumber++;
+    State.bIsSetComplete = false;
+
+    // Reset all player units for new set
+    State.Units.ResetTimers(EUnitType::Player);
+
+    StartNewSet(State);
+}
+
+void StartNewSet(FBattleSimState& State)
+{
+    SettleTurnTimer(State);
+    State.CurrentTimerRemaining = BattleClock::SecondsToTimerUnits(State.Tuning.BaseTimerDuration);
+    State.bTFNActive = false;
+    State.TFNRate = BattleClock::RateOne;
+
+    StartNextUnitTurn(State);
+    EmitBattleStateChanged(State);
+    EmitSetStarted(State);
+}
+
+void PauseBattle(FBattleSimState& State)
+{
+    if (State.BattleState == EBattleState::Paused) return;
+
+    SettleTurnTimer(State);
+    State.StateBeforePause = State.BattleState;
+    State.BattleState = EBattleState::Paused;
+    ScheduleTurnDeadline(State);
+    EmitBattleStateChanged(State);
+}
+
+void ResumeBattle(FBattleSimState& State)
+{
+    if (State.BattleState != EBattleState::Paused) return;
+
+    // Back to whichever phase was paused, so an enemy phase spanning several frames picks up where it was
+    SettleTurnTimer(State);
+    State.BattleState = State.StateBeforePause;
+    ScheduleTurnDeadline(State);
+    EmitBattleStateChanged(State);
+}
+
+void SetActionAnimationPlaying(FBattleSimState& State, bool bPlaying)
+{
+    if (State.bIsActionAnimationPlaying == bPlaying) return;
+
+    SettleTurnTimer(State);
+    State.bIsActionAnimationPlaying = bPlaying;
+    ScheduleTurnDeadline(State);
+}
+
+bool CheckBattleEndConditions(FBattleSimState& State)
+{
+    if (IsBattleOver(State))
+    {
+        return true;
+    }
+
+    bool bAllPlayersDefeated = true;
+    for (int32 UnitIndex : State.PlayerOrder)
+    {
+        if (IsAlive(State.Units, UnitIndex))
+        {
+            bAllPlayersDefeated = false;
+            break;
+        }
+    }
+
+    if (bAllPlayersDefeated)
+    {
+        SettleTurnTimer(State);
+        State.BattleState = EBattleState::Defeat;
+        State.TurnDeadlineTick = MAX_int64;
+        EmitBattleStateChanged(State);
+        return true;
+    }
+
+    bool bAllEnemiesDefeated = true;
+    for (int32 UnitIndex : State.EnemyIndices)
+    {
+        if (IsAlive(State.Units, UnitIndex))
+        {
+            bAllEnemiesDefeated = false;
+            break;
+        }
+    }
+
+    if (bAllEnemiesDefeated)
+    {
+        SettleTurnTimer(State);
+        State.BattleState = EBattleState::Victory;
+        State.TurnDeadlineTick = MAX_int64;
+        EmitBattleStateChanged(State);
+        return true;
+    }
+
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// Actions
+// ---------------------------------------------------------------------------
+
+void ExecuteAction(FBattleSimState& State, const FBattleSimAction& Action)
+{
+    if (!State.Units.IsValidIndex(Action.ActingUnit)) return;
+
+    switch (Action.ActionType)
+    {
+        case EActionType::Move:
+            MoveUnit(State, Action.ActingUnit, Action.TargetPosition);
+            break;
+        case EActionType::Attack:
+            if (State.Units.IsValidIndex(Action.TargetUnit))
+            {
+                AttackUnit(State, Action.ActingUnit, Action.TargetUnit, Action.Element);
+            }
+            break;
+        case EActionType::Skill:
+            UseSkill(State, Action.ActingUnit, Action.SkillIndex, Action.TargetUnit);
+            break;
+        case EActionType::Item:
+            // TODO: Implement item system
+            break;
+        case EActionType::Pass:
+            // Just pass turn
+            break;
+        case EActionType::Ranti:
+            UseRanti(State, Action.ComboIndex, Action.ActingUnit, Action.TargetUnit);
+            break;
+        case EActionType::Transform:
+            TransformToEO(State, Action.ActingUnit);
+            break;
+    }
+}
+
+void MoveUnit(FBattleSimState& State, int32 Unit, EBattlePosition NewPosition)
+{
+    if (!State.Units.IsValidIndex(Unit)) return;
+
+    AddToPosition(State, State.Units.Position[Unit], -1);
+    AddToPosition(State, NewPosition, 1);
+    State.Units.Position[Unit] = NewPosition;
+    State.Units.RehashUnit(Unit);
+    State.Events.Emplace(EBattleSimEventType::UnitMoved, Unit, INDEX_NONE, (float)NewPosition);
+}
+
+void AttackUnit(FBattleSimState& State, int32 Attacker, int32 Target, EElementalType ElementType)
+{
+    if (!State.Units.IsValidIndex(Attacker) || !State.Units.IsValidIndex(Target)) return;
+
+    ApplyDamage(State, Attacker, MakeArrayView(&Target, 1), ElementType, State.Tuning.BaseAttackDamage);
+}
+
+// Queues every hit of Skill and resolves them as one batch, so weakness rewards come once per cast
+static void PerformSkill(FBattleSimState& State, const FSkillEntry& Skill, int32 Caster, int32 Target)
+{
+    // Skills without a damage coefficient have no effect beyond their cost for now
+    if (Skill.DamageCoefficient <= 0.0f) return;
+
+    FCombatUnitStore& Units = State.Units;
+    const EUnitType CasterSide = Units.UnitType[Caster];
+    auto QueueHits = [&State, &Skill, Caster](int32 HitTarget)
+    {
+        FDamageRequest Request;
+        Request.Attacker = Caster;
+        Request.Target = HitTarget;
+        Request.Element = Skill.Element;
+        Request.BaseDamage = State.Tuning.BaseAttackDamage * Skill.DamageCoefficient;
+        for (int32 Hit = 0; Hit < Skill.HitCount; ++Hit)
+        {
+            QueueDamage(State, Request);
+        }
+    };
+
+    switch (Skill.Targeting)
+    {
+        case ESkillTargeting::SingleEnemy:
+            if (Units.IsValidIndex(Target) && Units.UnitType[Target] != CasterSide) QueueHits(Target);
+            break;
+        case ESkillTargeting::SingleAlly:
+            if (Units.IsValidIndex(Target) && Units.UnitType[Target] == CasterSide) QueueHits(Target);
+            break;
+        case ESkillTargeting::Self:
+            QueueHits(Caster);
+            break;
+        case ESkillTargeting::AllEnemies:
+        case ESkillTargeting::AllAllies:
+        {
+            const bool bEnemies = Skill.Targeting == ESkillTargeting::AllEnemies;
+            for (int32 Unit = 0; Unit < Units.Num(); ++Unit)
+            {
+                if (IsAlive(Units, Unit) && (Units.UnitType[Unit] != CasterSide) == bEnemies) QueueHits(Unit);
+            }
+            break;
+        }
+    }
+
+    ResolveDamage(State);
+}
+
+bool UseSkill(FBattleSimState& State, int32 Caster, int32 SkillIndex, int32 Target)
+{
+    if (!State.Skills || !State.Skills->IsValidIndex(SkillIndex)) return false;
+    if (!State.Units.IsValidIndex(Caster) || !CanAct(State.Units, Caster)) return false;
+
+    const FSkillEntry& Skill = (*State.Skills)[SkillIndex];
+    FCombatUnitStore& Units = State.Units;
+
+    if ((Skill.Flags & ESkillFlags::RequiresEOForm) && !Units.bIsInEOForm[Caster]) return false;
+    if (Units.CurrentMP[Caster] < Skill.MPCost) return false;
+
+    Units.CurrentMP[Caster] -= Skill.MPCost;
+    Units.RehashUnit(Caster);
+    State.Events.Emplace(EBattleSimEventType::SkillUsed, Caster, Target, (float)SkillIndex);
+
+    PerformSkill(State, Skill, Caster, Target);
+    return true;
+}
+
+bool UseRanti(FBattleSimState& State, int32 Combo, int32 Initiator, int32 Target)
+{
+    if (!State.Ranti || !State.Ranti->IsValidIndex(Combo) || !State.Units.IsValidIndex(Initiator)) return false;
+
+    const FRantiRegistry& Ranti = *State.Ranti;
+    const int32 InitiatorBit = State.Units.CharacterBit[Initiator];
+    if (InitiatorBit == INDEX_NONE || !(Ranti.GetMemberMask(Combo) & (1ull << InitiatorBit))) return false;
+    if (!Ranti.IsAvailable(Combo, FRantiRegistry::MakePartyState(State))) return false;
+
+    State.Events.Emplace(EBattleSimEventType::RantiUsed, Initiator, Target, (float)Combo);
+
+    const int32 SkillIndex = Ranti.GetSkillIndex(Combo);
+    if (State.Skills && State.Skills->IsValidIndex(SkillIndex))
+    {
+        PerformSkill(State, (*State.Skills)[SkillIndex], Initiator, Target);
+    }
+    return true;
+}
+
+void HandleWeaknessHit(FBattleSimState& State, int32 Attacker, int32 Target, EElementalType ElementType)
+{
+    // Add SP time to attacker
+    AddStockpiledTime(State, Attacker, State.Tuning.WeaknessSPGain);
+
+    // Apply TFN to next unit in turn order
+    ApplyTFNToNextUnit(State, State.Tuning.WeaknessTFNMultiplier);
+
+    State.Events.Emplace(EBattleSimEventType::WeaknessHit, Target, Attacker, (float)ElementType);
+}
+
+void ApplyTFNToNextUnit(FBattleSimState& State, float SpeedMultiplier)
+{
+    // The queued rate also drives the active timer, so drain at the old rate up to now first
+    SettleTurnTimer(State);
+    State.bTFNActive = true;
+    State.TFNRate = BattleClock::MultiplierToRate(FMath::Max(State.Tuning.MinTFNMultiplier, SpeedMultiplier)); // Capped at 0.25x
+    ScheduleTurnDeadline(State);
+}
+
+void AddStockpiledTime(FBattleSimState& State, int32 Unit, float TimeToAdd)
+{
+    if (!State.Units.IsValidIndex(Unit)) return;
+
+    AddStockpiledTime(State.Units, Unit, TimeToAdd);
+    State.Events.Emplace(EBattleSimEventType::StockpileGained, Unit, INDEX_NONE, TimeToAdd);
+}
+
+bool TransformToEO(FBattleSimState& State, int32 Unit)
+{
+    if (!State.Units.IsValidIndex(Unit)) return false;
+
+    SettleEO(State.Units, Unit, State.ClockTick, State.Tuning);
+    if (!TransformToEO(State.Units, Unit)) return false;
+
+    State.Events.Emplace(EBattleSimEventType::EOTransformed, Unit);
+    return true;
+}
+
+} // namespace BattleSim
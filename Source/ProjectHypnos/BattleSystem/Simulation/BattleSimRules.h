@@ -0,0 +1,112 @@
+// BattleSimRules.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BattleSimState.h"
+
+// Result of one attack landing on several targets. Bit i of each mask refers to the i-th target passed in.
+struct FBattleSimDamageBatchResult
+{
+    uint64 WeaknessMask = 0;
+    uint64 DefeatedMask = 0;
+    float TotalDamage = 0.0f;
+};
+
+/**
+ * Pure battle rules. Every function here operates only on the plain-data state passed in,
+ * so the same code drives ABattleManager in a level and the headless simulation.
+ */
+namespace BattleSim
+{
+    // Unit rules. Units are handles into the store.
+    PROJECTHYPNOS_API bool IsAlive(const FCombatUnitStore& Units, int32 Unit);
+    PROJECTHYPNOS_API bool CanAct(const FCombatUnitStore& Units, int32 Unit);
+    PROJECTHYPNOS_API void ResetTimer(FCombatUnitStore& Units, int32 Unit);
+    PROJECTHYPNOS_API void ResetForBattle(FCombatUnitStore& Units, int32 Unit);
+    PROJECTHYPNOS_API float ApplyTFN(FCombatUnitStore& Units, int32 Unit, float SpeedMultiplier, const FBattleSimTuning& Tuning);
+    PROJECTHYPNOS_API void AddStockpiledTime(FCombatUnitStore& Units, int32 Unit, float TimeToAdd);
+    PROJECTHYPNOS_API bool GainEO(FCombatUnitStore& Units, int32 Unit, float Amount); // Returns true if the EO bar is full afterwards
+
+    // Passive EO accrues from EOSettledTick without being stepped. Settle before changing anything that affects the rate.
+    PROJECTHYPNOS_API float GetCurrentEO(const FCombatUnitStore& Units, int32 Unit, int64 NowTick, const FBattleSimTuning& Tuning);
+    PROJECTHYPNOS_API void SettleEO(FCombatUnitStore& Units, int32 Unit, int64 NowTick, const FBattleSimTuning& Tuning);
+
+    PROJECTHYPNOS_API bool CanTransformToEO(const FCombatUnitStore& Units, int32 Unit);
+    PROJECTHYPNOS_API bool TransformToEO(FCombatUnitStore& Units, int32 Unit);
+    PROJECTHYPNOS_API bool ExitEOForm(FCombatUnitStore& Units, int32 Unit, bool bForced, const FBattleSimTuning& Tuning);
+    PROJECTHYPNOS_API void ApplyStressedOut(FCombatUnitStore& Units, int32 Unit, const FBattleSimTuning& Tuning);
+    PROJECTHYPNOS_API float GetElementalDamageMultiplier(const TArray<FElementalResistance>& Resistances, EElementalType AttackElement);
+    PROJECTHYPNOS_API float GetElementalDamageMultiplier(const FCombatUnitStore& Units, int32 Unit, EElementalType AttackElement);
+    PROJECTHYPNOS_API FBattleSimDamageResult TakeDamage(FCombatUnitStore& Units, int32 Unit, float DamageAmount, EElementalType ElementType, const FBattleSimTuning& Tuning);
+
+    // Defense math
+    PROJECTHYPNOS_API bool CanUseGuard(int32 UnitCountAtPosition);
+    PROJECTHYPNOS_API bool CanUseParry(int32 UnitCountAtPosition);
+    PROJECTHYPNOS_API bool CanUseDodge(int32 UnitCountAtPosition);
+    PROJECTHYPNOS_API EDefenseResult EvaluateDefenseResult(const FBattleSimDefenseTuning& Tuning, EDefenseType DefenseType, float TimingAccuracy);
+    PROJECTHYPNOS_API float CalculateDamageReduction(const FBattleSimDefenseTuning& Tuning, EDefenseType DefenseType, EDefenseResult Result);
+    PROJECTHYPNOS_API float CalculateEOGain(const FBattleSimDefenseTuning& Tuning, EDefenseType DefenseType, float TimingAccuracy);
+    PROJECTHYPNOS_API bool ShouldTriggerCounter(EDefenseType DefenseType, EDefenseResult Result);
+    PROJECTHYPNOS_API float GetDefenseDifficulty(EDefenseType DefenseType, int32 UnitCountAtPosition);
+    PROJECTHYPNOS_API float GetPositionMultiplier(EBattlePosition Position);
+
+    // State queries
+    PROJECTHYPNOS_API int32 AddUnit(FBattleSimState& State, const FBattleSimUnit& Unit);
+    PROJECTHYPNOS_API int32 GetCurrentUnit(const FBattleSimState& State);
+    PROJECTHYPNOS_API int32 CountUnitsAtPosition(const FBattleSimState& State, EBattlePosition Position);
+    PROJECTHYPNOS_API void RebuildFormation(FBattleSimState& State); // After positions were set directly
+    PROJECTHYPNOS_API bool IsBattleOver(const FBattleSimState& State);
+    PROJECTHYPNOS_API int64 GetTimerRemaining(const FBattleSimState& State); // Active unit's timer as of ClockTick
+
+    // Turn flow
+    PROJECTHYPNOS_API void StartBattle(FBattleSimState& State);
+    PROJECTHYPNOS_API void RetryBattle(FBattleSimState& State);
+    PROJECTHYPNOS_API void StepTicks(FBattleSimState& State, int32 NumTicks);
+    PROJECTHYPNOS_API void StartNextUnitTurn(FBattleSimState& State);
+    PROJECTHYPNOS_API void EndCurrentUnitTurn(FBattleSimState& State);
+    PROJECTHYPNOS_API void CheckSetCompletion(FBattleSimState& State);
+    PROJECTHYPNOS_API void StartEnemyTurn(FBattleSimState& State);
+    PROJECTHYPNOS_API void EndEnemyTurn(FBattleSimState& State);
+    PROJECTHYPNOS_API void StartNewSet(FBattleSimState& State);
+    PROJECTHYPNOS_API void PauseBattle(FBattleSimState& State);
+    PROJECTHYPNOS_API void ResumeBattle(FBattleSimState& State);
+    PROJECTHYPNOS_API void SetActionAnimationPlaying(FBattleSimState& State, bool bPlaying);
+    PROJECTHYPNOS_API bool CheckBattleEndConditions(FBattleSimState& State);
+
+    // Actions
+    PROJECTHYPNOS_API void ExecuteAction(FBattleSimState& State, const FBattleSimAction& Action);
+    PROJECTHYPNOS_API void MoveUnit(FBattleSimState& State, int32 Unit, EBattlePosition NewPosition);
+    PROJECTHYPNOS_API void AttackUnit(FBattleSimState& State, int32 Attacker, int32 Target, EElementalType ElementType = EElementalType::Physical);
+
+    // Pays the skill's MP and sends its hits through the damage queue. Target is ignored by
+    // skills that pick their own targets. Returns false if the caster cannot use the skill.
+    PROJECTHYPNOS_API bool UseSkill(FBattleSimState& State, int32 Caster, int32 SkillIndex, int32 Target);
+
+    // Performs the combo's skill from Initiator, who must be one of its members. The party
+    // requirements are the cost, so no MP is spent.
+    PROJECTHYPNOS_API bool UseRanti(FBattleSimState& State, int32 Combo, int32 Initiator, int32 Target);
+
+    PROJECTHYPNOS_API void HandleWeaknessHit(FBattleSimState& State, int32 Attacker, int32 Target, EElementalType ElementType);
+    PROJECTHYPNOS_API void ApplyTFNToNextUnit(FBattleSimState& State, float SpeedMultiplier);
+    PROJECTHYPNOS_API void AddStockpiledTime(FBattleSimState& State, int32 Unit, float TimeToAdd);
+    PROJECTHYPNOS_API bool TransformToEO(FBattleSimState& State, int32 Unit);
+
+    // Damage pipeline (BattleSimDamage.cpp). Hits are queued and resolved together in stages:
+    // defense reduction, elemental multiplier, EO redirect / HP, then defense rewards, KO and
+    // weakness events. Counters are queued as the next wave instead of recursing.
+    PROJECTHYPNOS_API void QueueDamage(FBattleSimState& State, const FDamageRequest& Request);
+    PROJECTHYPNOS_API void ResolveDamage(FBattleSimState& State);
+
+    // Lands damage that already has its elemental multiplier applied
+    PROJECTHYPNOS_API FBattleSimDamageResult ApplyHit(FCombatUnitStore& Units, int32 Unit, float Multiplier, float FinalDamage, const FBattleSimTuning& Tuning);
+
+    // One attack hitting every unit in Targets, up to MaxDamageBatchTargets. Weakness rewards are
+    // granted once per attacker per wave, not once per weak target.
+    constexpr int32 MaxDamageBatchTargets = 64;
+    PROJECTHYPNOS_API FBattleSimDamageBatchResult ApplyDamage(FBattleSimState& State, int32 Attacker, TConstArrayView<int32> Targets, EElementalType ElementType, float BaseDamage);
+
+    PROJECTHYPNOS_API FBattleSimDamageResult DamageUnit(FBattleSimState& State, int32 Target, float DamageAmount, EElementalType ElementType);
+
+    // Resolves a full defense attempt (damage, EO reward, counter) against an incoming hit
+    PROJECTHYPNOS_API EDefenseResult ResolveDefense(FBattleSimState& State, int32 Defender, int32 Attacker, EDefenseType DefenseType, float TimingAccuracy, float Damage);
+}
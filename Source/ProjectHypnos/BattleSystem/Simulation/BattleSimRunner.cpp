@@ -0,0 +1,162 @@
+// BattleSimRunner.cpp
+#include "BattleSimRunner.h"
+#include "BattleSimRules.h"
+#include "DefenseTable.h"
+
+namespace BattleSim
+{
+
+static int32 PickLivingUnit(const FBattleSimState& State, const TArray<int32>& Candidates, FRandomStream& Stream)
+{
+    int32 Picked = INDEX_NONE;
+    int32 Seen = 0;
+    for (int32 UnitIndex : Candidates)
+    {
+        if (IsAlive(State.Units, UnitIndex) && Stream.RandRange(0, Seen++) == 0)
+        {
+            Picked = UnitIndex;
+        }
+    }
+    return Picked;
+}
+
+// Folds the queued events into the outcome and clears them
+static void ConsumeEvents(FBattleSimState& State, FBattleSimOutcome& Outcome)
+{
+    for (const FBattleSimEvent& Event : State.Events)
+    {
+        switch (Event.Type)
+        {
+            case EBattleSimEventType::WeaknessHit:
+                ++Outcome.WeaknessHits;
+                break;
+            case EBattleSimEventType::StockpileGained:
+                Outcome.SPGained += Event.Value;
+                break;
+            case EBattleSimEventType::EOTransformed:
+                ++Outcome.EOTransforms;
+                break;
+            case EBattleSimEventType::EOFormExited:
+                if (Event.Value != 0.0f)
+                {
+                    ++Outcome.ForcedEOExits;
+                }
+                break;
+            case EBattleSimEventType::DefenseResolved:
+                ++Outcome.DefenseAttempts;
+                break;
+            case EBattleSimEventType::CounterAttack:
+                ++Outcome.Counters;
+                break;
+            default:
+                break;
+        }
+    }
+    State.Events.Reset();
+}
+
+static void RunPlayerAction(FBattleSimState& State, int32 UnitIndex, FRandomStream& Stream, const FBattleSimRunSettings& Settings)
+{
+    if (TransformToEO(State, UnitIndex))
+    {
+        // Transforming does not end the turn
+        return;
+    }
+
+    if (Stream.FRand() < Settings.MoveChance)
+    {
+        const EBattlePosition NewPosition = (EBattlePosition)Stream.RandRange((int32)EBattlePosition::North, (int32)EBattlePosition::West);
+        MoveUnit(State, UnitIndex, NewPosition);
+        return;
+    }
+
+    const int32 Target = PickLivingUnit(State, State.EnemyIndices, Stream);
+    if (Target != INDEX_NONE)
+    {
+        const EElementalType Element = (EElementalType)Stream.RandRange((int32)EElementalType::Fire, (int32)EElementalType::Physical);
+        AttackUnit(State, UnitIndex, Target, Element);
+    }
+
+    // Attacking ends the turn; leftover time carries into the next cycle of the set
+    EndCurrentUnitTurn(State);
+}
+
+EDefenseType PickScriptedDefense(const FBattleSimState& State, int32 Target, FRandomStream& Stream)
+{
+    const FDefenseOptions& Available = GetDefenseOptions(State.Formation, State.Units.Position[Target]);
+    EDefenseType Options[3];
+    int32 NumOptions = 0;
+    Options[NumOptions++] = EDefenseType::Dodge;
+    if (Available.IsAvailable(EDefenseType::Guard)) Options[NumOptions++] = EDefenseType::Guard;
+    if (Available.IsAvailable(EDefenseType::Parry)) Options[NumOptions++] = EDefenseType::Parry;
+
+    return Options[Stream.RandRange(0, NumOptions - 1)];
+}
+
+void RunScriptedEnemyPhase(FBattleSimState& State, FRandomStream& Stream, int32 FirstEnemy)
+{
+    for (int32 Index = FirstEnemy; Index < State.EnemyIndices.Num(); ++Index)
+    {
+        const int32 EnemyIndex = State.EnemyIndices[Index];
+        if (!CanAct(State.Units, EnemyIndex)) continue;
+
+        const int32 Target = PickLivingUnit(State, State.PlayerOrder, Stream);
+        if (Target == INDEX_NONE) break;
+
+        // Pick a defense the target's quadrant allows
+        const EDefenseType Defense = PickScriptedDefense(State, Target, Stream);
+        ResolveDefense(State, Target, EnemyIndex, Defense, Stream.FRand(), State.Tuning.BaseAttackDamage);
+    }
+}
+
+void RunUntilSet(FBattleSimState& State, FRandomStream& Stream, const FBattleSimRunSettings& Settings, int32 LastSet, FBattleSimOutcome& Outcome)
+{
+    while (!CheckBattleEndConditions(State) && State.CurrentSetNumber <= LastSet)
+    {
+        if (State.BattleState == EBattleState::EnemyTurn)
+        {
+            RunScriptedEnemyPhase(State, Stream);
+            if (!CheckBattleEndConditions(State))
+            {
+                EndEnemyTurn(State);
+            }
+        }
+        else
+        {
+            const int32 UnitIndex = GetCurrentUnit(State);
+            if (UnitIndex == INDEX_NONE)
+            {
+                // No one left to take a turn this set
+                EndCurrentUnitTurn(State);
+            }
+            else
+            {
+                // Spend some time on the clock; the turn may expire while thinking
+                StepTicks(State, BattleClock::SecondsToTicks(Stream.FRandRange(Settings.MinThinkTime, Settings.MaxThinkTime)));
+
+                if (State.BattleState == EBattleState::PlayerTurn && GetCurrentUnit(State) == UnitIndex)
+                {
+                    RunPlayerAction(State, UnitIndex, Stream, Settings);
+                    ++Outcome.PlayerActions;
+                }
+            }
+        }
+
+        ConsumeEvents(State, Outcome);
+    }
+}
+
+FBattleSimOutcome RunBattle(FBattleSimState& State, FRandomStream& Stream, const FBattleSimRunSettings& Settings)
+{
+    FBattleSimOutcome Outcome;
+
+    StartBattle(State);
+    RunUntilSet(State, Stream, Settings, Settings.MaxSets, Outcome);
+
+    ConsumeEvents(State, Outcome);
+    Outcome.FinalState = State.BattleState;
+    Outcome.Sets = FMath::Min(State.CurrentSetNumber, Settings.MaxSets);
+    return Outcome;
+}
+
+} // namespace BattleSim
@@ -0,0 +1,53 @@
+// BattleSimRunner.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BattleSimState.h"
+
+// Knobs for the scripted players and enemies used when a battle is played out headlessly
+struct FBattleSimRunSettings
+{
+    // Battles still running after this many sets are counted as timeouts
+    int32 MaxSets = 50;
+
+    // Seconds a player spends on the clock before committing an action
+    float MinThinkTime = 0.5f;
+    float MaxThinkTime = 3.0f;
+
+    // Chance a player repositions instead of attacking
+    float MoveChance = 0.2f;
+};
+
+// What happened in one headless battle
+struct FBattleSimOutcome
+{
+    EBattleState FinalState = EBattleState::PlayerTurn;
+    int32 Sets = 0;
+    int32 PlayerActions = 0;
+    int32 WeaknessHits = 0;
+    float SPGained = 0.0f;
+    int32 EOTransforms = 0;
+    int32 ForcedEOExits = 0;
+    int32 DefenseAttempts = 0;
+    int32 Counters = 0;
+
+    bool IsVictory() const { return FinalState == EBattleState::Victory; }
+    bool IsDefeat() const { return FinalState == EBattleState::Defeat; }
+};
+
+namespace BattleSim
+{
+    // Plays State out to victory, defeat or MaxSets using randomized player and enemy choices from Stream.
+    // State should be freshly built; StartBattle is called here.
+    PROJECTHYPNOS_API FBattleSimOutcome RunBattle(FBattleSimState& State, FRandomStream& Stream, const FBattleSimRunSettings& Settings);
+
+    // Continues an already started battle until it ends or set LastSet is over
+    PROJECTHYPNOS_API void RunUntilSet(FBattleSimState& State, FRandomStream& Stream, const FBattleSimRunSettings& Settings, int32 LastSet, FBattleSimOutcome& Outcome);
+
+    // Every living enemy from EnemyIndices[FirstEnemy] on attacks a random living player, who
+    // answers with a random legal defense
+    PROJECTHYPNOS_API void RunScriptedEnemyPhase(FBattleSimState& State, FRandomStream& Stream, int32 FirstEnemy = 0);
+
+    // A random defense the target's quadrant allows
+    PROJECTHYPNOS_API EDefenseType PickScriptedDefense(const FBattleSimState& State, int32 Target, FRandomStream& Stream);
+}
@@ -0,0 +1,63 @@
+// BattleSimState.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BattleSimTypes.h"
+#include "CombatUnitStore.h"
+#include "SkillTable.h"
+#include "RantiRegistry.h"
+
+// Complete battle state. Everything the rules read or write lives here, so a battle can be
+// copied, stepped and thrown away without a UWorld.
+struct FBattleSimState
+{
+    FCombatUnitStore Units;
+
+    // Player turn order and the enemy roster, as indices into Units
+    TArray<int32> PlayerOrder;
+    TArray<int32> EnemyIndices;
+
+    // Units standing at each EBattlePosition, and the same counts as a formation word (see
+    // DefenseTable.h) for defense lookups. Every rule that moves a unit keeps both current.
+    uint8 PositionCounts[(int32)EBattlePosition::Center + 1] = {};
+    uint16 Formation = 0;
+
+    EBattleState BattleState = EBattleState::PlayerTurn;
+    EBattleState StateBeforePause = EBattleState::PlayerTurn; // What ResumeBattle returns to
+    int32 CurrentUnitIndex = 0; // Index into PlayerOrder
+    int32 CurrentSetNumber = 1;
+    bool bIsSetComplete = false;
+    int64 CurrentTimerRemaining = 12 * BattleClock::TimerUnitsPerSecond;
+
+    // Fixed-step ticks simulated since the battle started
+    int64 ClockTick = 0;
+
+    // The active timer is not stepped per tick. CurrentTimerRemaining is exact as of TimerSettledTick and
+    // drains from there at TFNRate while DrainingUnit is set. TurnDeadlineTick is the absolute tick the
+    // active turn runs out (MAX_int64 while stopped).
+    int64 TimerSettledTick = 0;
+    int64 TurnDeadlineTick = MAX_int64;
+    int32 DrainingUnit = INDEX_NONE;
+
+    // TFN queued for the next unit to start its turn. Also scales how fast the active timer runs.
+    bool bTFNActive = false;
+    int32 TFNRate = BattleClock::RateOne;
+
+    // If true, the current unit's timer should not tick (e.g., during attack/skill animations)
+    bool bIsActionAnimationPlaying = false;
+
+    FBattleSimTuning Tuning;
+    FBattleSimDefenseTuning DefenseTuning;
+
+    // Compiled skills and Ranti combos, owned by whoever drives the simulation. Null if the battle has none.
+    const FSkillTable* Skills = nullptr;
+    const FRantiRegistry* Ranti = nullptr;
+
+    // Filled by the rules, drained by whoever drives the simulation
+    TArray<FBattleSimEvent> Events;
+
+    // Hits queued by BattleSim::QueueDamage. ResolveDamage empties the queue and leaves one
+    // ResolvedDamage entry per request, in queue order, counters included.
+    TArray<FDamageRequest> PendingDamage;
+    TArray<FResolvedDamage> ResolvedDamage;
+};
@@ -0,0 +1,277 @@
+// BattleSimTypes.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BattleClock.h"
+#include "BattleSimTypes.generated.h"
+
+// Shared battle enums live here so the headless simulation does not need to pull in any actor headers.
+
+UENUM(BlueprintType)
+enum class EUnitType : uint8
+{
+    Player,
+    Enemy
+};
+
+UENUM(BlueprintType)
+enum class EBattlePosition : uint8
+{
+    North,
+    East,
+    South,
+    West,
+    Center  // For enemies
+};
+
+UENUM(BlueprintType)
+enum class EElementalType : uint8
+{
+    None,
+    Fire,
+    Water,
+    Earth,
+    Air,
+    Light,
+    Dark,
+    Physical
+};
+
+UENUM(BlueprintType)
+enum class EDefenseType : uint8
+{
+    None,
+    Guard,
+    Dodge,
+    Parry
+};
+
+UENUM(BlueprintType)
+enum class EDefenseResult : uint8
+{
+    Success,
+    Partial,
+    Failure,
+    Counter
+};
+
+UENUM(BlueprintType)
+enum class EBattleState : uint8
+{
+    PlayerTurn,
+    EnemyTurn,
+    Victory,
+    Defeat,
+    Paused
+};
+
+UENUM(BlueprintType)
+enum class EActionType : uint8
+{
+    Move,
+    Attack,
+    Skill,
+    Item,
+    Pass,
+    Ranti,
+    Transform   // Into EO form
+};
+
+UENUM(BlueprintType)
+enum class ESkillTargeting : uint8
+{
+    SingleEnemy,
+    AllEnemies,
+    Self,
+    SingleAlly,
+    AllAllies
+};
+
+UENUM(BlueprintType)
+enum class EEnemyAIDifficulty : uint8
+{
+    Easy,
+    Normal,
+    Hard
+};
+
+USTRUCT(BlueprintType)
+struct PROJECTHYPNOS_API FElementalResistance
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Resistance")
+    EElementalType ElementType;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Resistance")
+    float ResistanceMultiplier;
+
+    FElementalResistance()
+    {
+        ElementType = EElementalType::None;
+        ResistanceMultiplier = 1.0f;
+    }
+};
+
+// Balance numbers used by the battle rules. Defaults match the values the actors shipped with.
+struct FBattleSimTuning
+{
+    float BaseTimerDuration = 12.0f;
+    float BaseAttackDamage = 20.0f;
+
+    // Weakness hits: SP for the attacker, TFN for the next unit
+    float WeaknessSPGain = 2.0f;
+    float WeaknessTFNMultiplier = 0.75f;
+    float MinTFNMultiplier = 0.25f;
+
+    // EO
+    float PassiveEOPerSecond = 5.0f;
+    float StressedOutEOGainRate = 0.5f;
+    float StressedOutHPFraction = 0.25f;
+};
+
+// Mirrors the tunables exposed on ADefenseManager
+struct FBattleSimDefenseTuning
+{
+    float DodgePerfectWindow = 0.1f;
+    float DodgeGoodWindow = 0.3f;
+    float ParryPerfectWindow = 0.05f;
+    float ParryGoodWindow = 0.15f;
+
+    float GuardDamageReduction = 0.5f;
+    float DodgeDamageReduction = 1.0f;
+    float ParryDamageReduction = 0.0f;
+
+    float GuardEOGain = 5.0f;
+    float DodgeEOGain = 10.0f;
+    float ParryEOGain = 25.0f;
+};
+
+// Plain-data record of everything the rules need to know about a combat unit. Battles keep units in
+// FCombatUnitStore; this is the form units are added with and read back as.
+struct FBattleSimUnit
+{
+    EUnitType UnitType = EUnitType::Player;
+    EBattlePosition Position = EBattlePosition::West;
+
+    // Health
+    float MaxHP = 100.0f;
+    float CurrentHP = 100.0f;
+
+    // Timer / TFN / SP, in BattleClock timer units and rates
+    int64 TimerDuration = 12 * BattleClock::TimerUnitsPerSecond;
+    int64 TimerRemaining = 12 * BattleClock::TimerUnitsPerSecond;
+    int32 TimerTickRate = BattleClock::RateOne;
+    int64 StockpiledTime = 0;
+
+    // EO
+    float MaxEO = 100.0f;
+    float CurrentEO = 0.0f;
+    float EOGainRate = 1.0f;
+    bool bIsInEOForm = false;
+
+    // Passive EO is settled lazily: CurrentEO is exact as of this clock tick
+    int64 EOSettledTick = 0;
+
+    // MP (only available in EO form)
+    float MaxMP = 50.0f;
+    float CurrentMP = 0.0f;
+
+    // Status
+    bool bIsStressedOut = false;
+    bool bIsIncapacitated = false;
+    EDefenseType DefenseType = EDefenseType::None;
+
+    TArray<FElementalResistance> ElementalResistances;
+
+    // This character's bit in the Ranti registry, or INDEX_NONE if no combo can use it
+    int32 CharacterBit = INDEX_NONE;
+};
+
+enum class EBattleSimEventType : uint8
+{
+    BattleStateChanged,
+    UnitTurnStarted,
+    UnitTurnEnded,
+    SetComplete,
+    EnemyTurnStarted,
+    UnitMoved,
+    Damage,
+    WeaknessHit,
+    UnitDefeated,
+    TFNApplied,
+    StockpileGained,
+    EOTransformed,
+    EOFormExited,   // Value is 1 if the unit was forced out and is now Stressed Out, 0 for a normal exit
+    StressedOut,
+    DefenseResolved,
+    CounterAttack,
+    SkillUsed,      // Value is the skill's index in the skill table
+    RantiUsed,      // Value is the combo's index in the Ranti registry
+    TimerExpired,   // Unit ran out of time; its UnitTurnEnded follows
+    SetStarted      // Value is the set number. Follows StartBattle and RetryBattle as well as each new set.
+};
+
+// Something the rules want the presentation layer to know about. Unit indices refer to FBattleSimState::Units.
+struct FBattleSimEvent
+{
+    EBattleSimEventType Type = EBattleSimEventType::BattleStateChanged;
+    int32 Unit = INDEX_NONE;
+    int32 OtherUnit = INDEX_NONE;
+    float Value = 0.0f;
+
+    FBattleSimEvent() = default;
+    FBattleSimEvent(EBattleSimEventType InType, int32 InUnit = INDEX_NONE, int32 InOtherUnit = INDEX_NONE, float InValue = 0.0f)
+        : Type(InType), Unit(InUnit), OtherUnit(InOtherUnit), Value(InValue)
+    {
+    }
+};
+
+// Result of a single hit landing on a unit
+struct FBattleSimDamageResult
+{
+    float Multiplier = 1.0f;
+    float FinalDamage = 0.0f;
+    bool bHitEO = false;          // Damage went to the EO bar instead of HP
+    bool bForcedOutOfEO = false;
+    bool bDefeated = false;
+
+    bool IsWeaknessHit() const { return Multiplier > 1.0f; }
+};
+
+// One hit waiting in FBattleSimState::PendingDamage. Units are indices into FBattleSimState::Units.
+struct FDamageRequest
+{
+    int32 Attacker = INDEX_NONE;
+    int32 Target = INDEX_NONE;
+    EElementalType Element = EElementalType::Physical;
+    float BaseDamage = 0.0f;
+
+    // Active defense by the target. None means the hit lands undefended.
+    EDefenseType Defense = EDefenseType::None;
+    float TimingAccuracy = 1.0f;
+
+    // Weakness hits grant the attacker SP and TFN. Defended hits never do.
+    bool bRewardsWeakness = true;
+};
+
+// What happened to one FDamageRequest, in FBattleSimState::ResolvedDamage
+struct FResolvedDamage
+{
+    EDefenseResult DefenseResult = EDefenseResult::Failure;
+    float Damage = 0.0f;          // After defense, before the elemental multiplier
+    float Multiplier = 1.0f;
+    FBattleSimDamageResult Hit;
+};
+
+// Actor-free action description. Units are indices into FBattleSimState::Units.
+struct FBattleSimAction
+{
+    int32 ActingUnit = INDEX_NONE;
+    EActionType ActionType = EActionType::Pass;
+    EBattlePosition TargetPosition = EBattlePosition::West;
+    int32 TargetUnit = INDEX_NONE;
+    EElementalType Element = EElementalType::Physical;
+    int32 SkillIndex = INDEX_NONE;  // Into FBattleSimState::Skills
+    int32 ComboIndex = INDEX_NONE;  // Into FBattleSimState::Ranti
+};
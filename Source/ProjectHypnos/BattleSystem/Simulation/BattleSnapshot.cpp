@@ -0,0 +1,152 @@
+// BattleSnapshot.cpp
+#include "BattleSnapshot.h"
+#include "BattleSimRules.h"
+
+namespace BattleSim
+{
+
+bool CaptureSnapshot(const FBattleSimState& State, EBattleSnapshotKind Kind, FBattleSnapshot& OutSnapshot)
+{
+    const FCombatUnitStore& Units = State.Units;
+    if (Units.Num() > FBattleSnapshot::MaxUnits) return false;
+
+    OutSnapshot.Kind = Kind;
+    OutSnapshot.BattleState = State.BattleState;
+    OutSnapshot.StateBeforePause = State.StateBeforePause;
+    OutSnapshot.bIsSetComplete = State.bIsSetComplete;
+    OutSnapshot.bTFNActive = State.bTFNActive;
+    OutSnapshot.bIsActionAnimationPlaying = State.bIsActionAnimationPlaying;
+    OutSnapshot.NumUnits = Units.Num();
+    OutSnapshot.CurrentUnitIndex = State.CurrentUnitIndex;
+    OutSnapshot.CurrentSetNumber = State.CurrentSetNumber;
+    OutSnapshot.DrainingUnit = State.DrainingUnit;
+    OutSnapshot.TFNRate = State.TFNRate;
+    OutSnapshot.CurrentTimerRemaining = State.CurrentTimerRemaining;
+    OutSnapshot.ClockTick = State.ClockTick;
+    OutSnapshot.TimerSettledTick = State.TimerSettledTick;
+    OutSnapshot.TurnDeadlineTick = State.TurnDeadlineTick;
+    OutSnapshot.DefenseTuning = State.DefenseTuning;
+
+    for (int32 Unit = 0; Unit < Units.Num(); ++Unit)
+    {
+        FBattleUnitSnapshot& Out = OutSnapshot.Units[Unit];
+        Out.TimerDuration = Units.TimerDuration[Unit];
+        Out.TimerRemaining = Units.TimerRemaining[Unit];
+        Out.StockpiledTime = Units.StockpiledTime[Unit];
+        Out.EOSettledTick = Units.EOSettledTick[Unit];
+        Out.CurrentHP = Units.CurrentHP[Unit];
+        Out.CurrentEO = Units.CurrentEO[Unit];
+        Out.EOGainRate = Units.EOGainRate[Unit];
+        Out.CurrentMP = Units.CurrentMP[Unit];
+        Out.TimerTickRate = Units.TimerTickRate[Unit];
+        Out.Position = Units.Position[Unit];
+        Out.DefenseType = Units.DefenseType[Unit];
+        Out.bIsInEOForm = Units.bIsInEOForm[Unit];
+        Out.bIsStressedOut = Units.bIsStressedOut[Unit];
+        Out.bIsIncapacitated = Units.bIsIncapacitated[Unit];
+    }
+    return true;
+}
+
+bool RestoreSnapshot(FBattleSimState& State, const FBattleSnapshot& Snapshot)
+{
+    FCombatUnitStore& Units = State.Units;
+    if (Snapshot.NumUnits != Units.Num()) return false;
+
+    State.BattleState = Snapshot.BattleState;
+    State.StateBeforePause = Snapshot.StateBeforePause;
+    State.bIsSetComplete = Snapshot.bIsSetComplete;
+    State.bTFNActive = Snapshot.bTFNActive;
+    State.bIsActionAnimationPlaying = Snapshot.bIsActionAnimationPlaying;
+    State.CurrentUnitIndex = Snapshot.CurrentUnitIndex;
+    State.CurrentSetNumber = Snapshot.CurrentSetNumber;
+    State.DrainingUnit = Snapshot.DrainingUnit;
+    State.TFNRate = Snapshot.TFNRate;
+    State.CurrentTimerRemaining = Snapshot.CurrentTimerRemaining;
+    State.ClockTick = Snapshot.ClockTick;
+    State.TimerSettledTick = Snapshot.TimerSettledTick;
+    State.TurnDeadlineTick = Snapshot.TurnDeadlineTick;
+    State.DefenseTuning = Snapshot.DefenseTuning;
+
+    for (int32 Unit = 0; Unit < Units.Num(); ++Unit)
+    {
+        const FBattleUnitSnapshot& In = Snapshot.Units[Unit];
+        Units.TimerDuration[Unit] = In.TimerDuration;
+        Units.TimerRemaining[Unit] = In.TimerRemaining;
+        Units.StockpiledTime[Unit] = In.StockpiledTime;
+        Units.EOSettledTick[Unit] = In.EOSettledTick;
+        Units.CurrentHP[Unit] = In.CurrentHP;
+        Units.CurrentEO[Unit] = In.CurrentEO;
+        Units.EOGainRate[Unit] = In.EOGainRate;
+        Units.CurrentMP[Unit] = In.CurrentMP;
+        Units.TimerTickRate[Unit] = In.TimerTickRate;
+        Units.Position[Unit] = In.Position;
+        Units.DefenseType[Unit] = In.DefenseType;
+        Units.bIsInEOForm[Unit] = In.bIsInEOForm;
+        Units.bIsStressedOut[Unit] = In.bIsStressedOut;
+        Units.bIsIncapacitated[Unit] = In.bIsIncapacitated;
+        Units.RehashUnit(Unit);
+    }
+    RebuildFormation(State);
+
+    // Hits from the undone timeline never land
+    State.PendingDamage.Reset();
+    State.ResolvedDamage.Reset();
+
+    State.Events.Emplace(EBattleSimEventType::BattleStateChanged, INDEX_NONE, INDEX_NONE, (float)State.BattleState);
+    return true;
+}
+
+} // namespace BattleSim
+
+void FBattleSnapshotRing::Reset()
+{
+    Head = 0;
+    Count = 0;
+}
+
+void FBattleSnapshotRing::Capture(const FBattleSimState& State, EBattleSnapshotKind Kind)
+{
+    if (Slots.Num() == 0)
+    {
+        Slots.SetNumUninitialized(Capacity);
+    }
+
+    // Oversized rosters are not snapshotted; rewinding then simply finds nothing
+    if (!BattleSim::CaptureSnapshot(State, Kind, Slots[Head])) return;
+
+    Head = (Head + 1) % Capacity;
+    Count = FMath::Min(Count + 1, Capacity);
+}
+
+const FBattleSnapshot* FBattleSnapshotRing::FindLastAction() const
+{
+    for (int32 I = 0; I < Count; ++I)
+    {
+        const FBattleSnapshot& Snapshot = GetFromNewest(I);
+        if (Snapshot.Kind == EBattleSnapshotKind::SetStart) return nullptr;
+        if (Snapshot.BattleState == EBattleState::PlayerTurn) return &Snapshot;
+    }
+    return nullptr;
+}
+
+const FBattleSnapshot* FBattleSnapshotRing::FindSetStart(int32 SetNumber) const
+{
+    for (int32 I = 0; I < Count; ++I)
+    {
+        const FBattleSnapshot& Snapshot = GetFromNewest(I);
+        if (Snapshot.Kind == EBattleSnapshotKind::SetStart && Snapshot.CurrentSetNumber == SetNumber) return &Snapshot;
+    }
+    return nullptr;
+}
+
+void FBattleSnapshotRing::DiscardAfter(const FBattleSnapshot* Snapshot, bool bInclusive)
+{
+    const int32 Slot = (int32)(Snapshot - Slots.GetData());
+    check(Slot >= 0 && Slot < Slots.Num());
+
+    const int32 NewerCount = (Head - 1 - Slot + Capacity) % Capacity;
+    const int32 Dropped = NewerCount + (bInclusive ? 1 : 0);
+    Head = (Head - Dropped + Capacity) % Capacity;
+    Count -= Dropped;
+}
@@ -0,0 +1,110 @@
+// BattleSnapshot.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BattleSimState.h"
+#include <type_traits>
+
+enum class EBattleSnapshotKind : uint8
+{
+    SetStart,   // Taken once a set has started, before any of its inputs
+    Action      // Taken just before a unit acts
+};
+
+// The fields of one unit the rules can change. Content fixed for the battle (max stats,
+// resistances, Ranti membership) stays in the store and is never snapshotted.
+struct FBattleUnitSnapshot
+{
+    int64 TimerDuration;
+    int64 TimerRemaining;
+    int64 StockpiledTime;
+    int64 EOSettledTick;
+    float CurrentHP;
+    float CurrentEO;
+    float EOGainRate;
+    float CurrentMP;
+    int32 TimerTickRate;
+    EBattlePosition Position;
+    EDefenseType DefenseType;
+    uint8 bIsInEOForm;
+    uint8 bIsStressedOut;
+    uint8 bIsIncapacitated;
+};
+
+/**
+ * Flat copy of everything in an FBattleSimState that changes while a battle runs. Plain data with
+ * no pointers, so a snapshot is copied, stored and written to a log as raw bytes.
+ *
+ * Only Units[0, NumUnits) are meaningful. Queued damage and undelivered events are not kept:
+ * snapshots are taken between inputs, when both are empty.
+ */
+struct FBattleSnapshot
+{
+    static constexpr int32 MaxUnits = 16;
+
+    EBattleSnapshotKind Kind;
+    EBattleState BattleState;
+    EBattleState StateBeforePause;
+    bool bIsSetComplete;
+    bool bTFNActive;
+    bool bIsActionAnimationPlaying;
+    int32 NumUnits;
+    int32 CurrentUnitIndex;
+    int32 CurrentSetNumber;
+    int32 DrainingUnit;
+    int32 TFNRate;
+    int64 CurrentTimerRemaining;
+    int64 ClockTick;
+    int64 TimerSettledTick;
+    int64 TurnDeadlineTick;
+    FBattleSimDefenseTuning DefenseTuning;
+    FBattleUnitSnapshot Units[MaxUnits];
+
+    // Bytes up to and including the last used unit; the rest of Units is never read
+    int32 GetUsedSize() const { return (int32)(STRUCT_OFFSET(FBattleSnapshot, Units) + NumUnits * sizeof(FBattleUnitSnapshot)); }
+};
+
+static_assert(std::is_trivially_copyable<FBattleSnapshot>::value, "FBattleSnapshot must stay plain data");
+
+namespace BattleSim
+{
+    // False if State has more than FBattleSnapshot::MaxUnits units
+    PROJECTHYPNOS_API bool CaptureSnapshot(const FBattleSimState& State, EBattleSnapshotKind Kind, FBattleSnapshot& OutSnapshot);
+
+    // Puts State back to Snapshot, which must have been taken from the same roster. Queued damage is
+    // dropped and a state change event is queued so views catch up.
+    PROJECTHYPNOS_API bool RestoreSnapshot(FBattleSimState& State, const FBattleSnapshot& Snapshot);
+}
+
+/**
+ * The most recent Capacity snapshots of a battle, oldest overwritten first. Storage is allocated once,
+ * so taking a snapshot never allocates and rewinding is a copy back into the state.
+ */
+class PROJECTHYPNOS_API FBattleSnapshotRing
+{
+public:
+    static constexpr int32 Capacity = 64;
+
+    void Reset();
+    void Capture(const FBattleSimState& State, EBattleSnapshotKind Kind);
+
+    // Newest Action snapshot of the current set, or null. Undo restores it and then Pops it.
+    const FBattleSnapshot* FindLastAction() const;
+
+    // Start of SetNumber, or null once it has been overwritten
+    const FBattleSnapshot* FindSetStart(int32 SetNumber) const;
+
+    // Drops every snapshot newer than Snapshot, which must be one returned by a Find. Pass
+    // bInclusive to drop Snapshot as well.
+    void DiscardAfter(const FBattleSnapshot* Snapshot, bool bInclusive);
+
+    int32 Num() const { return Count; }
+
+private:
+    // I = 0 is the newest snapshot
+    const FBattleSnapshot& GetFromNewest(int32 I) const { return Slots[(Head - 1 - I + Capacity) % Capacity]; }
+
+    TArray<FBattleSnapshot> Slots;
+    int32 Head = 0;  // Slot the next capture writes
+    int32 Count = 0;
+};
@@ -0,0 +1,233 @@
+// CombatUnitStore.cpp
+#include "CombatUnitStore.h"
+#include "BattleSimHash.h"
+
+int32 FCombatUnitStore::Add(const FBattleSimUnit& Unit)
+{
+    if (NumUnits == NumLanes())
+    {
+        AddLanes();
+    }
+
+    const int32 Handle = NumUnits++;
+    Set(Handle, Unit);
+    return Handle;
+}
+
+FBattleSimUnit FCombatUnitStore::Get(int32 Unit) const
+{
+    check(IsValidIndex(Unit));
+
+    FBattleSimUnit Record;
+    Record.UnitType = UnitType[Unit];
+    Record.Position = Position[Unit];
+    Record.MaxHP = MaxHP[Unit];
+    Record.CurrentHP = CurrentHP[Unit];
+    Record.TimerDuration = TimerDuration[Unit];
+    Record.TimerRemaining = TimerRemaining[Unit];
+    Record.TimerTickRate = TimerTickRate[Unit];
+    Record.StockpiledTime = StockpiledTime[Unit];
+    Record.MaxEO = MaxEO[Unit];
+    Record.CurrentEO = CurrentEO[Unit];
+    Record.EOGainRate = EOGainRate[Unit];
+    Record.bIsInEOForm = bIsInEOForm[Unit] != 0;
+    Record.EOSettledTick = EOSettledTick[Unit];
+    Record.MaxMP = MaxMP[Unit];
+    Record.CurrentMP = CurrentMP[Unit];
+    Record.bIsStressedOut = bIsStressedOut[Unit] != 0;
+    Record.bIsIncapacitated = bIsIncapacitated[Unit] != 0;
+    Record.DefenseType = DefenseType[Unit];
+    Record.CharacterBit = CharacterBit[Unit];
+    Record.ElementalResistances = ElementalResistances[Unit];
+    return Record;
+}
+
+void FCombatUnitStore::Set(int32 Unit, const FBattleSimUnit& Record)
+{
+    check(IsValidIndex(Unit));
+
+    UnitType[Unit] = Record.UnitType;
+    Position[Unit] = Record.Position;
+    MaxHP[Unit] = Record.MaxHP;
+    CurrentHP[Unit] = Record.CurrentHP;
+    TimerDuration[Unit] = Record.TimerDuration;
+    TimerRemaining[Unit] = Record.TimerRemaining;
+    TimerTickRate[Unit] = Record.TimerTickRate;
+    StockpiledTime[Unit] = Record.StockpiledTime;
+    MaxEO[Unit] = Record.MaxEO;
+    CurrentEO[Unit] = Record.CurrentEO;
+    EOGainRate[Unit] = Record.EOGainRate;
+    bIsInEOForm[Unit] = Record.bIsInEOForm;
+    EOSettledTick[Unit] = Record.EOSettledTick;
+    MaxMP[Unit] = Record.MaxMP;
+    CurrentMP[Unit] = Record.CurrentMP;
+    bIsStressedOut[Unit] = Record.bIsStressedOut;
+    bIsIncapacitated[Unit] = Record.bIsIncapacitated;
+    DefenseType[Unit] = Record.DefenseType;
+    CharacterBit[Unit] = (int8)Record.CharacterBit;
+    SetElementalResistances(Unit, Record.ElementalResistances);
+    RehashUnit(Unit);
+}
+
+void FCombatUnitStore::ComputeUnitHash(int32 Unit, uint64& OutStatHash, uint64& OutTimerHash) const
+{
+    using namespace BattleSim;
+
+    const int64 Status = (int64)bIsInEOForm[Unit] | (int64)bIsStressedOut[Unit] << 1 | (int64)bIsIncapacitated[Unit] << 2;
+
+    OutStatHash = ZobristKey(Unit, EBattleSimHashField::HP, HashBucket(CurrentHP[Unit], HashHPBucket))
+        ^ ZobristKey(Unit, EBattleSimHashField::EO, HashBucket(CurrentEO[Unit], HashEOBucket))
+        ^ ZobristKey(Unit, EBattleSimHashField::MP, HashBucket(CurrentMP[Unit], HashMPBucket))
+        ^ ZobristKey(Unit, EBattleSimHashField::Position, (int64)Position[Unit])
+        ^ ZobristKey(Unit, EBattleSimHashField::Status, Status)
+        ^ ZobristKey(Unit, EBattleSimHashField::Stockpile, StockpiledTime[Unit] / HashTimerBucket);
+
+    OutTimerHash = ZobristKey(Unit, EBattleSimHashField::Timer, TimerRemaining[Unit] / HashTimerBucket)
+        ^ ZobristKey(Unit, EBattleSimHashField::TickRate, TimerTickRate[Unit]);
+}
+
+void FCombatUnitStore::RehashUnit(int32 Unit)
+{
+    check(IsValidIndex(Unit));
+
+    uint64 NewStatHash, NewTimerHash;
+    ComputeUnitHash(Unit, NewStatHash, NewTimerHash);
+
+    StatHash ^= UnitStatHash[Unit] ^ NewStatHash;
+    TimerHash ^= UnitTimerHash[Unit] ^ NewTimerHash;
+    UnitStatHash[Unit] = NewStatHash;
+    UnitTimerHash[Unit] = NewTimerHash;
+}
+
+void FCombatUnitStore::RehashAll()
+{
+    for (int32 Unit = 0; Unit < NumUnits; ++Unit)
+    {
+        RehashUnit(Unit);
+    }
+}
+
+uint64 FCombatUnitStore::ComputeHash() const
+{
+    uint64 Hash = 0;
+    for (int32 Unit = 0; Unit < NumUnits; ++Unit)
+    {
+        uint64 UnitStat, UnitTimer;
+        ComputeUnitHash(Unit, UnitStat, UnitTimer);
+        Hash ^= UnitStat ^ UnitTimer;
+    }
+    return Hash;
+}
+
+void FCombatUnitStore::SetElementalResistances(int32 Unit, const TArray<FElementalResistance>& Resistances)
+{
+    check(IsValidIndex(Unit));
+
+    for (int32 Element = 0; Element < ElementCount; ++Element)
+    {
+        ElementalMultiplier[Element][Unit] = 1.0f; // No special resistance/weakness
+    }
+
+    // Walk backwards so the first entry for an element wins, as it did with a linear scan
+    for (int32 Index = Resistances.Num() - 1; Index >= 0; --Index)
+    {
+        const int32 Element = (int32)Resistances[Index].ElementType;
+        if (Element >= 0 && Element < ElementCount)
+        {
+            ElementalMultiplier[Element][Unit] = Resistances[Index].ResistanceMultiplier;
+        }
+    }
+
+    ElementalResistances[Unit] = Resistances;
+}
+
+void FCombatUnitStore::Reset()
+{
+    *this = FCombatUnitStore();
+}
+
+void FCombatUnitStore::AddLanes()
+{
+    for (int32 Lane = 0; Lane < LaneWidth; ++Lane)
+    {
+        // Inert lane: dead with zero maximums, so every kernel leaves it at zero
+        UnitType.Add(EUnitType::Enemy);
+        Position.Add(EBattlePosition::Center);
+        MaxHP.Add(0.0f);
+        CurrentHP.Add(0.0f);
+        TimerDuration.Add(0);
+        TimerRemaining.Add(0);
+        StockpiledTime.Add(0);
+        TimerTickRate.Add(BattleClock::RateOne);
+        MaxEO.Add(0.0f);
+        CurrentEO.Add(0.0f);
+        EOGainRate.Add(0.0f);
+        EOSettledTick.Add(0);
+        bIsInEOForm.Add(0);
+        MaxMP.Add(0.0f);
+        CurrentMP.Add(0.0f);
+        bIsStressedOut.Add(0);
+        bIsIncapacitated.Add(0);
+        DefenseType.Add(EDefenseType::None);
+        CharacterBit.Add(INDEX_NONE);
+        for (TLaneArray<float>& Multipliers : ElementalMultiplier)
+        {
+            Multipliers.Add(1.0f);
+        }
+        ElementalResistances.AddDefaulted();
+        UnitStatHash.Add(0); // Padding lanes are never hashed
+        UnitTimerHash.Add(0);
+    }
+}
+
+float FCombatUnitStore::ComputeSettledEO(float CurrentEO, float MaxEO, float EOGainRate, int64 ElapsedTicks, bool bAccrues, float PassiveEOPerSecond)
+{
+    // Elapsed time is narrowed to 32 bits (over 100 days of ticks) so the conversion vectorizes
+    const int32 Ticks = (int32)FMath::Clamp<int64>(ElapsedTicks, 0, MAX_int32);
+
+    // EOGainRate scales the passive amount and is applied again by GainEO
+    const float Gain = PassiveEOPerSecond * (float)((double)Ticks / BattleClock::TicksPerSecond) * EOGainRate * EOGainRate;
+    const float Settled = FMath::Clamp(CurrentEO + Gain, 0.0f, MaxEO);
+    return bAccrues ? Settled : CurrentEO;
+}
+
+void FCombatUnitStore::SettleEO(int64 NowTick, float PassiveEOPerSecond)
+{
+    const int32 Count = NumLanes();
+    float* RESTRICT EO = CurrentEO.GetData();
+    int64* RESTRICT Settled = EOSettledTick.GetData();
+    const float* RESTRICT HP = CurrentHP.GetData();
+    const float* RESTRICT Max = MaxEO.GetData();
+    const float* RESTRICT Rate = EOGainRate.GetData();
+    const uint8* RESTRICT InEOForm = bIsInEOForm.GetData();
+
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        const int64 Elapsed = NowTick - Settled[Index];
+        const bool bAccrues = (InEOForm[Index] == 0) & (HP[Index] > 0.0f) & (Elapsed > 0);
+        EO[Index] = ComputeSettledEO(EO[Index], Max[Index], Rate[Index], Elapsed, bAccrues, PassiveEOPerSecond);
+        Settled[Index] = NowTick;
+    }
+
+    RehashAll();
+}
+
+void FCombatUnitStore::ResetTimers(EUnitType Side)
+{
+    const int32 Count = NumLanes();
+    int64* RESTRICT Remaining = TimerRemaining.GetData();
+    int64* RESTRICT Stockpile = StockpiledTime.GetData();
+    int32* RESTRICT TickRate = TimerTickRate.GetData();
+    const int64* RESTRICT Duration = TimerDuration.GetData();
+    const EUnitType* RESTRICT Type = UnitType.GetData();
+
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        const bool bOnSide = Type[Index] == Side;
+        Remaining[Index] = bOnSide ? Duration[Index] + Stockpile[Index] : Remaining[Index];
+        Stockpile[Index] = bOnSide ? 0 : Stockpile[Index]; // Reset stockpiled time after using it
+        TickRate[Index] = bOnSide ? BattleClock::RateOne : TickRate[Index]; // Reset TFN effect
+    }
+
+    RehashAll();
+}
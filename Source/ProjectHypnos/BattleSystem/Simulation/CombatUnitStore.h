@@ -0,0 +1,111 @@
+// CombatUnitStore.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BattleSimTypes.h"
+
+/**
+ * Battle unit stats in structure-of-arrays form. A unit handle is an index shared by every array.
+ *
+ * Arrays are 16-byte aligned and padded to a multiple of LaneWidth with inert (dead, zero-max)
+ * lanes, so the batch kernels below run whole vector lanes with no remainder loop. The kernels are
+ * branch-free over contiguous arrays and vectorize on every platform we build for.
+ */
+struct PROJECTHYPNOS_API FCombatUnitStore
+{
+    static constexpr int32 LaneWidth = 4;
+
+    // One damage multiplier per EElementalType value
+    static constexpr int32 ElementCount = (int32)EElementalType::Physical + 1;
+
+    template <typename T>
+    using TLaneArray = TArray<T, TAlignedHeapAllocator<16>>;
+
+    // Placement
+    TLaneArray<EUnitType> UnitType;
+    TLaneArray<EBattlePosition> Position;
+
+    // Health
+    TLaneArray<float> MaxHP;
+    TLaneArray<float> CurrentHP;
+
+    // Timer / TFN / SP, in BattleClock timer units and rates
+    TLaneArray<int64> TimerDuration;
+    TLaneArray<int64> TimerRemaining;
+    TLaneArray<int64> StockpiledTime;
+    TLaneArray<int32> TimerTickRate;
+
+    // EO
+    TLaneArray<float> MaxEO;
+    TLaneArray<float> CurrentEO;
+    TLaneArray<float> EOGainRate;
+    TLaneArray<int64> EOSettledTick;
+    TLaneArray<uint8> bIsInEOForm;
+
+    // MP (only available in EO form)
+    TLaneArray<float> MaxMP;
+    TLaneArray<float> CurrentMP;
+
+    // Status
+    TLaneArray<uint8> bIsStressedOut;
+    TLaneArray<uint8> bIsIncapacitated;
+    TLaneArray<EDefenseType> DefenseType;
+
+    // Ranti party membership. Padding lanes have no character.
+    TLaneArray<int8> CharacterBit;
+
+    // Resistances compiled to a multiplier per element, indexed [Element][Unit]. Rebuilt by
+    // SetElementalResistances, so a hit is a single load instead of a scan.
+    TLaneArray<float> ElementalMultiplier[ElementCount];
+
+    // Authored resistances, kept so Get returns what was Set
+    TArray<TArray<FElementalResistance>> ElementalResistances;
+
+    int32 Num() const { return NumUnits; }
+    int32 NumLanes() const { return CurrentHP.Num(); }
+    bool IsValidIndex(int32 Unit) const { return Unit >= 0 && Unit < NumUnits; }
+
+    // Returns the new unit's handle
+    int32 Add(const FBattleSimUnit& Unit);
+    FBattleSimUnit Get(int32 Unit) const;
+    void Set(int32 Unit, const FBattleSimUnit& Record);
+    void Reset();
+
+    void SetElementalResistances(int32 Unit, const TArray<FElementalResistance>& Resistances);
+    float GetElementalMultiplier(int32 Unit, EElementalType Element) const { return ElementalMultiplier[(int32)Element][Unit]; }
+
+    // Batch kernels. Padding lanes are dead, so they never gain EO or change HP.
+
+    // Banks passive EO accrued up to NowTick on every unit
+    void SettleEO(int64 NowTick, float PassiveEOPerSecond);
+
+    // Start-of-set timer reset for every unit on Side: stockpiled time is added and TFN cleared
+    void ResetTimers(EUnitType Side);
+
+    // Zobrist hash of every unit (see BattleSimHash.h). Stats, positions and status are kept apart
+    // from timers so enemy planning can ignore the clock. GetHash covers both.
+    uint64 GetStatHash() const { return StatHash; }
+    uint64 GetHash() const { return StatHash ^ TimerHash; }
+
+    // Call after writing any hashed field of Unit. Swaps the unit's old keys for new ones in O(1).
+    void RehashUnit(int32 Unit);
+
+    // Recomputes both hashes from scratch, for checking that every writer rehashed
+    uint64 ComputeHash() const;
+
+    // Per-unit form of the SettleEO kernel, so single-unit rules produce bit-identical results
+    static float ComputeSettledEO(float CurrentEO, float MaxEO, float EOGainRate, int64 ElapsedTicks, bool bAccrues, float PassiveEOPerSecond);
+
+private:
+    void AddLanes();
+    void RehashAll();
+    void ComputeUnitHash(int32 Unit, uint64& OutStatHash, uint64& OutTimerHash) const;
+
+    int32 NumUnits = 0;
+
+    // Each unit's current keys, XORed together into StatHash and TimerHash
+    TArray<uint64> UnitStatHash;
+    TArray<uint64> UnitTimerHash;
+    uint64 StatHash = 0;
+    uint64 TimerHash = 0;
+};
@@ -0,0 +1,54 @@
+// DefenseTable.cpp
+#include "DefenseTable.h"
+#include "BattleSimRules.h"
+
+namespace
+{
+    constexpr int32 NumPositions = (int32)EBattlePosition::Center + 1;
+    constexpr int32 NumFields = 1 << BattleSim::FormationBitsPerPosition;
+
+    struct FDefenseTable
+    {
+        FDefenseOptions Options[NumPositions][NumFields];
+
+        FDefenseTable()
+        {
+            for (int32 Position = 0; Position < NumPositions; ++Position)
+            {
+                for (int32 Field = 0; Field < NumFields; ++Field)
+                {
+                    // Fields past the saturation count play like it
+                    const int32 Count = FMath::Min(Field, BattleSim::FormationMaxCount);
+                    FDefenseOptions& Entry = Options[Position][Field];
+                    Entry.PositionMultiplier = BattleSim::GetPositionMultiplier((EBattlePosition)Position);
+
+                    for (int32 Type = 0; Type < FDefenseOptions::NumDefenseTypes; ++Type)
+                    {
+                        Entry.Difficulty[Type] = BattleSim::GetDefenseDifficulty((EDefenseType)Type, Count);
+                    }
+
+                    Entry.AvailableMask =
+                        (BattleSim::CanUseGuard(Count) ? 1 << (uint8)EDefenseType::Guard : 0) |
+                        (BattleSim::CanUseDodge(Count) ? 1 << (uint8)EDefenseType::Dodge : 0) |
+                        (BattleSim::CanUseParry(Count) ? 1 << (uint8)EDefenseType::Parry : 0);
+                }
+            }
+        }
+    };
+
+    static_assert(NumPositions * BattleSim::FormationBitsPerPosition <= 16, "Formation words are 16 bits");
+}
+
+namespace BattleSim
+{
+
+const FDefenseOptions& GetDefenseOptions(uint16 Formation, EBattlePosition Position)
+{
+    static const FDefenseTable Table;
+    static const FDefenseOptions None;
+
+    if ((int32)Position >= NumPositions) return None;
+    return Table.Options[(int32)Position][GetFormationCount(Formation, Position)];
+}
+
+} // namespace BattleSim
@@ -0,0 +1,47 @@
+// DefenseTable.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BattleSimTypes.h"
+
+// What each defense looks like at one position. Bits and difficulties are indexed by EDefenseType.
+struct FDefenseOptions
+{
+    static constexpr int32 NumDefenseTypes = (int32)EDefenseType::Parry + 1;
+
+    uint8 AvailableMask = 0;
+    float Difficulty[NumDefenseTypes] = {};
+    float PositionMultiplier = 1.0f;
+
+    bool IsAvailable(EDefenseType Type) const { return (AvailableMask >> (uint8)Type) & 1; }
+    float GetDifficulty(EDefenseType Type) const { return Difficulty[(uint8)Type]; }
+};
+
+/**
+ * Defense availability and difficulty for every formation, precomputed from the defense rules.
+ *
+ * A formation is a word with FormationBitsPerPosition bits per EBattlePosition holding how many units
+ * stand there, saturated at 2: the rules only tell alone, together and empty apart. Each position's
+ * options depend only on its own field, so the table is [position][field] rather than one row per
+ * word, and a lookup is a shift, a mask and a load.
+ */
+namespace BattleSim
+{
+    constexpr int32 FormationBitsPerPosition = 2;
+    constexpr int32 FormationMaxCount = 2;
+
+    // Word with Position's field set to Count
+    inline uint16 SetFormationCount(uint16 Formation, EBattlePosition Position, int32 Count)
+    {
+        const int32 Shift = (int32)Position * FormationBitsPerPosition;
+        const uint16 Field = (uint16)FMath::Min(Count, FormationMaxCount);
+        return (uint16)((Formation & ~(((1u << FormationBitsPerPosition) - 1) << Shift)) | (Field << Shift));
+    }
+
+    inline int32 GetFormationCount(uint16 Formation, EBattlePosition Position)
+    {
+        return (Formation >> ((int32)Position * FormationBitsPerPosition)) & ((1 << FormationBitsPerPosition) - 1);
+    }
+
+    PROJECTHYPNOS_API const FDefenseOptions& GetDefenseOptions(uint16 Formation, EBattlePosition Position);
+}
@@ -0,0 +1,195 @@
+// EnemyPlanner.cpp
+#include "EnemyPlanner.h"
+#include "BattleSimRules.h"
+#include "BattleSimRunner.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTime.h"
+
+FEnemyPlannerSettings FEnemyPlannerSettings::ForDifficulty(EEnemyAIDifficulty Difficulty)
+{
+    FEnemyPlannerSettings Settings;
+    switch (Difficulty)
+    {
+        case EEnemyAIDifficulty::Easy:
+            // Scores only what the enemy phase itself does
+            Settings.TimeBudgetSeconds = 0.02;
+            Settings.RolloutSets = 0;
+            Settings.MaxRolloutsPerCandidate = 16;
+            break;
+        case EEnemyAIDifficulty::Normal:
+            Settings.TimeBudgetSeconds = 0.1;
+            Settings.RolloutSets = 1;
+            Settings.MaxRolloutsPerCandidate = 128;
+            break;
+        case EEnemyAIDifficulty::Hard:
+            Settings.TimeBudgetSeconds = 0.25;
+            Settings.RolloutSets = 3;
+            Settings.MaxRolloutsPerCandidate = 512;
+            break;
+    }
+    return Settings;
+}
+
+namespace BattleSim
+{
+
+static bool IsOutOfTime(double Deadline, const std::atomic<bool>* bCancel)
+{
+    return FPlatformTime::Seconds() >= Deadline || (bCancel && bCancel->load(std::memory_order_relaxed));
+}
+
+void GetEnemyCandidates(const FBattleSimState& State, int32 Enemy, TArray<FBattleSimAction>& OutActions)
+{
+    OutActions.Reset();
+    if (!CanAct(State.Units, Enemy)) return;
+
+    // Enemies have no skill lists yet, so the choice is who to attack
+    for (int32 Target : State.PlayerOrder)
+    {
+        if (!IsAlive(State.Units, Target)) continue;
+
+        FBattleSimAction Attack;
+        Attack.ActingUnit = Enemy;
+        Attack.ActionType = EActionType::Attack;
+        Attack.TargetUnit = Target;
+        Attack.Element = EElementalType::Physical;
+        OutActions.Add(Attack);
+    }
+}
+
+void ApplyPlannedEnemyAction(FBattleSimState& State, const FBattleSimAction& Action, FRandomStream& Stream)
+{
+    if (Action.ActionType == EActionType::Attack && State.Units.IsValidIndex(Action.TargetUnit))
+    {
+        const EDefenseType Defense = PickScriptedDefense(State, Action.TargetUnit, Stream);
+        ResolveDefense(State, Action.TargetUnit, Action.ActingUnit, Defense, Stream.FRand(), State.Tuning.BaseAttackDamage);
+    }
+    else
+    {
+        ExecuteAction(State, Action);
+    }
+}
+
+float EvaluateForEnemies(const FBattleSimState& State)
+{
+    if (State.BattleState == EBattleState::Defeat) return 10.0f;
+    if (State.BattleState == EBattleState::Victory) return -10.0f;
+
+    // Fraction of health lost on each side, with a knocked out unit counting double
+    auto SideDamage = [&State](const TArray<int32>& Side)
+    {
+        float Damage = 0.0f;
+        for (int32 Unit : Side)
+        {
+            const float MaxHP = State.Units.MaxHP[Unit];
+            Damage += MaxHP > 0.0f ? 1.0f - State.Units.CurrentHP[Unit] / MaxHP : 0.0f;
+            Damage += IsAlive(State.Units, Unit) ? 0.0f : 1.0f;
+        }
+        return Damage;
+    };
+
+    return SideDamage(State.PlayerOrder) - SideDamage(State.EnemyIndices);
+}
+
+// Plays Candidate for the enemy at EnemyIndices[Ordinal], the rest of the phase and Settings.RolloutSets more sets
+static float RunRollout(const FBattleSimState& State, int32 Ordinal, const FBattleSimAction& Candidate, const FEnemyPlannerSettings& Settings, FRandomStream& Stream)
+{
+    FBattleSimState Rollout = State;
+    ApplyPlannedEnemyAction(Rollout, Candidate, Stream);
+    RunScriptedEnemyPhase(Rollout, Stream, Ordinal + 1);
+
+    if (Settings.RolloutSets > 0 && !CheckBattleEndConditions(Rollout))
+    {
+        EndEnemyTurn(Rollout);
+
+        FBattleSimOutcome Ignored;
+        RunUntilSet(Rollout, Stream, FBattleSimRunSettings(), Rollout.CurrentSetNumber + Settings.RolloutSets - 1, Ignored);
+    }
+
+    CheckBattleEndConditions(Rollout);
+    return EvaluateForEnemies(Rollout);
+}
+
+FEnemyPlan PlanEnemyPhase(const FBattleSimState& State, const FEnemyPlannerSettings& Settings, int32 Seed, const std::atomic<bool>* bCancel)
+{
+    FEnemyPlan Plan;
+    const double StartTime = FPlatformTime::Seconds();
+    const int32 NumWorkers = FMath::Max(1, Settings.NumWorkers);
+    const int32 RoundsPerWorker = FMath::DivideAndRoundUp(FMath::Max(1, Settings.MaxRolloutsPerCandidate), NumWorkers);
+
+    FBattleSimState Working = State;
+    Working.Events.Reset();
+    FRandomStream CommitStream(Seed);
+
+    TArray<FBattleSimAction> Candidates;
+    TArray<double> ScoreSums;
+    TArray<int32> RolloutCounts;
+
+    const int32 NumEnemies = State.EnemyIndices.Num();
+    for (int32 Ordinal = 0; Ordinal < NumEnemies; ++Ordinal)
+    {
+        if (CheckBattleEndConditions(Working)) break;
+
+        GetEnemyCandidates(Working, Working.EnemyIndices[Ordinal], Candidates);
+        const int32 NumCandidates = Candidates.Num();
+        if (NumCandidates == 0) continue;
+
+        // Budget left unused by earlier enemies carries over to later ones
+        const double Deadline = StartTime + Settings.TimeBudgetSeconds * (Ordinal + 1) / NumEnemies;
+
+        // Per worker, per candidate, so workers never share a slot
+        ScoreSums.Reset();
+        ScoreSums.SetNumZeroed(NumWorkers * NumCandidates);
+        RolloutCounts.Reset();
+        RolloutCounts.SetNumZeroed(NumWorkers * NumCandidates);
+
+        if (NumCandidates > 1)
+        {
+            ParallelFor(NumWorkers, [&](int32 Worker)
+            {
+                FRandomStream Stream((int32)HashCombine(Seed, HashCombine(Ordinal, Worker)));
+                for (int32 Round = 0; Round < RoundsPerWorker; ++Round)
+                {
+                    for (int32 Candidate = 0; Candidate < NumCandidates; ++Candidate)
+                    {
+                        if (IsOutOfTime(Deadline, bCancel)) return;
+
+                        const int32 Slot = Worker * NumCandidates + Candidate;
+                        ScoreSums[Slot] += RunRollout(Working, Ordinal, Candidates[Candidate], Settings, Stream);
+                        ++RolloutCounts[Slot];
+                    }
+                }
+            });
+        }
+
+        // Best mean score; candidates never tried lose to any that were, and the first one is the fallback
+        int32 Best = 0;
+        double BestScore = -MAX_dbl;
+        for (int32 Candidate = 0; Candidate < NumCandidates; ++Candidate)
+        {
+            double Sum = 0.0;
+            int32 Count = 0;
+            for (int32 Worker = 0; Worker < NumWorkers; ++Worker)
+            {
+                Sum += ScoreSums[Worker * NumCandidates + Candidate];
+                Count += RolloutCounts[Worker * NumCandidates + Candidate];
+            }
+
+            Plan.Rollouts += Count;
+            if (Count > 0 && Sum / Count > BestScore)
+            {
+                BestScore = Sum / Count;
+                Best = Candidate;
+            }
+        }
+
+        Plan.Actions.Add(Candidates[Best]);
+        ApplyPlannedEnemyAction(Working, Candidates[Best], CommitStream);
+        Working.Events.Reset();
+    }
+
+    Plan.bHitBudget = FPlatformTime::Seconds() >= StartTime + Settings.TimeBudgetSeconds;
+    return Plan;
+}
+
+} // namespace BattleSim
@@ -0,0 +1,56 @@
+// EnemyPlanner.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BattleSimState.h"
+#include <atomic>
+
+struct FEnemyPlannerSettings
+{
+    // Hard wall-clock limit for planning a whole enemy phase
+    double TimeBudgetSeconds = 0.1;
+
+    // Sets each rollout plays past the enemy phase being planned. Zero scores the phase alone.
+    int32 RolloutSets = 1;
+
+    // Stop early once every candidate has this many rollouts
+    int32 MaxRolloutsPerCandidate = 256;
+
+    int32 NumWorkers = 4;
+
+    static FEnemyPlannerSettings ForDifficulty(EEnemyAIDifficulty Difficulty);
+};
+
+struct FEnemyPlan
+{
+    // One action per enemy that could act, in EnemyIndices order
+    TArray<FBattleSimAction> Actions;
+
+    // Monte Carlo planner
+    int32 Rollouts = 0;
+
+    // Boss search (EnemySearch.h): shallowest finished iteration over the phase's enemies, and nodes visited
+    int32 SearchDepth = 0;
+    int64 SearchNodes = 0;
+
+    bool bHitBudget = false;
+};
+
+/**
+ * Monte Carlo enemy planner. Works on its own copy of the state, so it can run on any thread.
+ * Enemies are planned in turn order; each candidate action is scored by playing the battle forward
+ * with the scripted policies from BattleSimRunner, and the best mean score wins.
+ */
+namespace BattleSim
+{
+    PROJECTHYPNOS_API FEnemyPlan PlanEnemyPhase(const FBattleSimState& State, const FEnemyPlannerSettings& Settings, int32 Seed, const std::atomic<bool>* bCancel = nullptr);
+
+    // Everything Enemy could do right now
+    PROJECTHYPNOS_API void GetEnemyCandidates(const FBattleSimState& State, int32 Enemy, TArray<FBattleSimAction>& OutActions);
+
+    // Performs an enemy action in a planning copy. Attacks are answered with a scripted player defense.
+    PROJECTHYPNOS_API void ApplyPlannedEnemyAction(FBattleSimState& State, const FBattleSimAction& Action, FRandomStream& Stream);
+
+    // Higher is better for the enemies
+    PROJECTHYPNOS_API float EvaluateForEnemies(const FBattleSimState& State);
+}
@@ -0,0 +1,451 @@
+// EnemySearch.cpp
+#include "EnemySearch.h"
+#include "BattleSimRules.h"
+#include "DefenseTable.h"
+#include "BattleSimHash.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTime.h"
+
+namespace BattleSim
+{
+
+// Candidates per node are stored as uint8 in the table
+static constexpr int32 MaxSearchMoves = 255;
+
+// How often a worker looks at the clock, in nodes
+static constexpr int64 DeadlineCheckInterval = 256;
+
+struct FSearchNode
+{
+    FBattleSimState State;
+    int32 EnemyOrdinal = 0; // Next entry of EnemyIndices to act during the enemy phase
+};
+
+enum class ESearchNodeKind : uint8
+{
+    Terminal,
+    Enemy,
+    Player
+};
+
+struct FDefenseOutcome
+{
+    float Probability = 0.0f;
+    float TimingAccuracy = 0.0f;
+};
+
+struct FSearchWorker
+{
+    FTranspositionTable& Table;
+    double Deadline = 0.0;
+    const std::atomic<bool>* bCancel = nullptr;
+    int32 Worker = 0;
+    float ScoreBound = 0.0f; // Every score lies in [-ScoreBound, ScoreBound]
+    int64 Nodes = 0;
+    bool bAborted = false;
+
+    FSearchWorker(FTranspositionTable& InTable)
+        : Table(InTable)
+    {
+    }
+
+    bool CheckAbort()
+    {
+        if (!bAborted && ++Nodes % DeadlineCheckInterval == 0)
+        {
+            bAborted = FPlatformTime::Seconds() >= Deadline || (bCancel && bCancel->load(std::memory_order_relaxed));
+        }
+        return bAborted;
+    }
+};
+
+// Plays out anything nobody decides (skipped enemies, phase changes) and says who decides next
+static ESearchNodeKind SettleNode(FSearchNode& Node)
+{
+    FBattleSimState& State = Node.State;
+
+    // Every pass moves the turn on, so this only guards against a rules change that stalls it
+    for (int32 Pass = 0; Pass < 64; ++Pass)
+    {
+        if (CheckBattleEndConditions(State)) return ESearchNodeKind::Terminal;
+
+        if (State.BattleState == EBattleState::EnemyTurn)
+        {
+            while (Node.EnemyOrdinal < State.EnemyIndices.Num() && !CanAct(State.Units, State.EnemyIndices[Node.EnemyOrdinal]))
+            {
+                ++Node.EnemyOrdinal;
+            }
+            if (Node.EnemyOrdinal < State.EnemyIndices.Num()) return ESearchNodeKind::Enemy;
+
+            EndEnemyTurn(State);
+            Node.EnemyOrdinal = 0;
+        }
+        else if (State.BattleState == EBattleState::PlayerTurn)
+        {
+            if (GetCurrentUnit(State) != INDEX_NONE) return ESearchNodeKind::Player;
+
+            EndCurrentUnitTurn(State);
+        }
+        else
+        {
+            return ESearchNodeKind::Terminal;
+        }
+    }
+    return ESearchNodeKind::Terminal;
+}
+
+static uint64 GetNodeKey(const FSearchNode& Node)
+{
+    return HashState(Node.State) ^ ZobristKey(INDEX_NONE, EBattleSimHashField::EnemyOrdinal, Node.EnemyOrdinal);
+}
+
+// The timing window is treated as uniform over [0, 1], as the scripted defenders play it. Each band
+// becomes one outcome, played at its midpoint.
+static int32 GetDefenseOutcomes(const FBattleSimDefenseTuning& Tuning, EDefenseType Defense, FDefenseOutcome (&OutOutcomes)[3])
+{
+    float Edges[4] = { 0.0f, 1.0f, 1.0f, 1.0f };
+    int32 NumBands = 1;
+    switch (Defense)
+    {
+        case EDefenseType::Dodge:
+            Edges[1] = Tuning.DodgePerfectWindow;
+            Edges[2] = Tuning.DodgeGoodWindow;
+            NumBands = 3;
+            break;
+        case EDefenseType::Parry:
+            Edges[1] = Tuning.ParryPerfectWindow;
+            Edges[2] = Tuning.ParryGoodWindow;
+            NumBands = 3;
+            break;
+        default:
+            break;
+    }
+
+    int32 NumOutcomes = 0;
+    for (int32 Band = 0; Band < NumBands; ++Band)
+    {
+        const float Low = FMath::Clamp(Edges[Band], 0.0f, 1.0f);
+        const float High = FMath::Clamp(Edges[Band + 1], Low, 1.0f);
+        if (High <= Low) continue;
+
+        OutOutcomes[NumOutcomes].Probability = High - Low;
+        OutOutcomes[NumOutcomes].TimingAccuracy = (Low + High) * 0.5f;
+        ++NumOutcomes;
+    }
+    return NumOutcomes;
+}
+
+static void GetPlayerCandidates(const FBattleSimState& State, int32 Player, TArray<FBattleSimAction>& OutActions)
+{
+    OutActions.Reset();
+
+    for (int32 Enemy : State.EnemyIndices)
+    {
+        if (!IsAlive(State.Units, Enemy)) continue;
+
+        // Strongest element against this enemy, Physical unless something beats it
+        EElementalType BestElement = EElementalType::Physical;
+        for (int32 Element = 0; Element < FCombatUnitStore::ElementCount; ++Element)
+        {
+            if (State.Units.GetElementalMultiplier(Enemy, (EElementalType)Element) > State.Units.GetElementalMultiplier(Enemy, BestElement))
+            {
+                BestElement = (EElementalType)Element;
+            }
+        }
+
+        FBattleSimAction Attack;
+        Attack.ActingUnit = Player;
+        Attack.ActionType = EActionType::Attack;
+        Attack.TargetUnit = Enemy;
+        Attack.Element = BestElement;
+        OutActions.Add(Attack);
+    }
+}
+
+static void ApplyPlayerCandidate(FBattleSimState& State, const FBattleSimAction& Action)
+{
+    // Transforming is free and does not end the turn, so players always take it first
+    TransformToEO(State, Action.ActingUnit);
+    ExecuteAction(State, Action);
+
+    // Run out the clock on this unit's turn
+    if (State.BattleState == EBattleState::PlayerTurn && State.TurnDeadlineTick != MAX_int64)
+    {
+        StepTicks(State, (int32)FMath::Min<int64>(State.TurnDeadlineTick - State.ClockTick, MAX_int32));
+    }
+    else if (State.BattleState == EBattleState::PlayerTurn)
+    {
+        EndCurrentUnitTurn(State);
+    }
+}
+
+// Puts the table's move first; other workers also rotate the rest so they explore different lines
+static void OrderMoves(TArray<int32, TInlineAllocator<16>>& OutOrder, int32 NumMoves, int32 TableMove, int32 Worker)
+{
+    OutOrder.Reset();
+    if (TableMove >= 0 && TableMove < NumMoves)
+    {
+        OutOrder.Add(TableMove);
+    }
+    for (int32 Offset = 0; Offset < NumMoves; ++Offset)
+    {
+        const int32 Move = (Offset + Worker) % NumMoves;
+        if (Move != TableMove)
+        {
+            OutOrder.Add(Move);
+        }
+    }
+}
+
+static float SearchNode(FSearchWorker& Search, FSearchNode& Node, int32 Depth, float Alpha, float Beta, int32* OutBestMove = nullptr);
+
+// Chance node over one defense's outcomes, with Star1 cutoffs
+static float SearchDefenseOutcomes(FSearchWorker& Search, const FSearchNode& Node, int32 Enemy, int32 Target, EDefenseType Defense, int32 Depth, float Alpha, float Beta)
+{
+    FDefenseOutcome Outcomes[3];
+    const int32 NumOutcomes = GetDefenseOutcomes(Node.State.DefenseTuning, Defense, Outcomes);
+
+    const float Lower = -Search.ScoreBound;
+    const float Upper = Search.ScoreBound;
+    float Sum = 0.0f;
+    float Remaining = 1.0f;
+
+    for (int32 Index = 0; Index < NumOutcomes; ++Index)
+    {
+        const float Probability = Outcomes[Index].Probability;
+        Remaining -= Probability;
+
+        // The window this outcome must land in for the node to still matter, assuming the
+        // outcomes not yet searched come in at the bounds
+        const float CutAlpha = (Alpha - Sum - Remaining * Upper) / Probability;
+        const float CutBeta = (Beta - Sum - Remaining * Lower) / Probability;
+
+        FSearchNode Child = Node;
+        ResolveDefense(Child.State, Target, Enemy, Defense, Outcomes[Index].TimingAccuracy, Child.State.Tuning.BaseAttackDamage);
+        Child.State.Events.Reset();
+        ++Child.EnemyOrdinal;
+
+        const float Score = SearchNode(Search, Child, Depth, FMath::Max(Lower, CutAlpha), FMath::Min(Upper, CutBeta));
+        if (Search.bAborted) return 0.0f;
+
+        // Whatever the rest score, the node cannot end up inside (Alpha, Beta)
+        if (Score <= CutAlpha) return Sum + Probability * Score + Remaining * Upper;
+        if (Score >= CutBeta) return Sum + Probability * Score + Remaining * Lower;
+
+        Sum += Probability * Score;
+    }
+    return Sum;
+}
+
+// The defender picks whichever defense the quadrant allows that hurts the enemies most
+static float SearchDefense(FSearchWorker& Search, const FSearchNode& Node, int32 Enemy, int32 Target, int32 Depth, float Alpha, float Beta)
+{
+    const FDefenseOptions& Available = GetDefenseOptions(Node.State.Formation, Node.State.Units.Position[Target]);
+    EDefenseType Options[3];
+    int32 NumOptions = 0;
+    if (Available.IsAvailable(EDefenseType::Parry)) Options[NumOptions++] = EDefenseType::Parry;
+    if (Available.IsAvailable(EDefenseType::Guard)) Options[NumOptions++] = EDefenseType::Guard;
+    Options[NumOptions++] = EDefenseType::Dodge;
+
+    float Best = MAX_flt;
+    for (int32 Index = 0; Index < NumOptions; ++Index)
+    {
+        const float Score = SearchDefenseOutcomes(Search, Node, Enemy, Target, Options[Index], Depth, Alpha, FMath::Min(Beta, Best));
+        if (Search.bAborted) return 0.0f;
+
+        Best = FMath::Min(Best, Score);
+        if (Best <= Alpha) break;
+    }
+    return Best;
+}
+
+static float SearchNode(FSearchWorker& Search, FSearchNode& Node, int32 Depth, float Alpha, float Beta, int32* OutBestMove)
+{
+    if (Search.CheckAbort()) return 0.0f;
+
+    const ESearchNodeKind Kind = SettleNode(Node);
+    Node.State.Events.Reset();
+    if (Kind == ESearchNodeKind::Terminal || Depth <= 0)
+    {
+        return EvaluateForEnemies(Node.State);
+    }
+
+    const uint64 Key = GetNodeKey(Node);
+    int32 TableMove = INDEX_NONE;
+    FTranspositionEntry Entry;
+    if (Search.Table.Probe(Key, Entry))
+    {
+        TableMove = Entry.BestMove;
+        if (Entry.Depth >= Depth && !OutBestMove)
+        {
+            if (Entry.Bound == ETranspositionBound::Exact) return Entry.Score;
+            if (Entry.Bound == ETranspositionBound::Lower && Entry.Score >= Beta) return Entry.Score;
+            if (Entry.Bound == ETranspositionBound::Upper && Entry.Score <= Alpha) return Entry.Score;
+        }
+    }
+
+    const bool bEnemyMoves = Kind == ESearchNodeKind::Enemy;
+    const int32 Actor = bEnemyMoves ? Node.State.EnemyIndices[Node.EnemyOrdinal] : GetCurrentUnit(Node.State);
+
+    TArray<FBattleSimAction> Candidates;
+    if (bEnemyMoves)
+    {
+        GetEnemyCandidates(Node.State, Actor, Candidates);
+    }
+    else
+    {
+        GetPlayerCandidates(Node.State, Actor, Candidates);
+    }
+    const int32 NumMoves = FMath::Min(Candidates.Num(), MaxSearchMoves);
+    if (NumMoves == 0) return EvaluateForEnemies(Node.State);
+
+    TArray<int32, TInlineAllocator<16>> Order;
+    OrderMoves(Order, NumMoves, TableMove, Search.Worker);
+
+    const float OriginalAlpha = Alpha;
+    const float OriginalBeta = Beta;
+    float Best = bEnemyMoves ? -MAX_flt : MAX_flt;
+    int32 BestMove = Order[0];
+
+    for (int32 Move : Order)
+    {
+        float Score;
+        if (bEnemyMoves)
+        {
+            // Candidates are attacks; what they do depends on the defense
+            Score = SearchDefense(Search, Node, Actor, Candidates[Move].TargetUnit, Depth - 1, Alpha, Beta);
+        }
+        else
+        {
+            FSearchNode Child = Node;
+            ApplyPlayerCandidate(Child.State, Candidates[Move]);
+            Score = SearchNode(Search, Child, Depth - 1, Alpha, Beta);
+        }
+        if (Search.bAborted) return 0.0f;
+
+        if (bEnemyMoves ? Score > Best : Score < Best)
+        {
+            Best = Score;
+            BestMove = Move;
+        }
+
+        if (bEnemyMoves)
+        {
+            Alpha = FMath::Max(Alpha, Best);
+        }
+        else
+        {
+            Beta = FMath::Min(Beta, Best);
+        }
+        if (Alpha >= Beta) break;
+    }
+
+    FTranspositionEntry NewEntry;
+    NewEntry.Score = Best;
+    NewEntry.Depth = (uint8)FMath::Min(Depth, 255);
+    NewEntry.BestMove = (uint8)BestMove;
+    NewEntry.Bound = Best <= OriginalAlpha ? ETranspositionBound::Upper
+        : Best >= OriginalBeta ? ETranspositionBound::Lower
+        : ETranspositionBound::Exact;
+    Search.Table.Store(Key, NewEntry);
+
+    if (OutBestMove)
+    {
+        *OutBestMove = BestMove;
+    }
+    return Best;
+}
+
+// Result of one worker's iterative deepening
+struct FSearchWorkerResult
+{
+    int32 Depth = 0;
+    int32 BestMove = INDEX_NONE;
+    int64 Nodes = 0;
+};
+
+FEnemyPlan SearchEnemyPhase(const FBattleSimState& State, FTranspositionTable& Table, const FEnemySearchSettings& Settings, int32 Seed, const std::atomic<bool>* bCancel)
+{
+    FEnemyPlan Plan;
+    const double StartTime = FPlatformTime::Seconds();
+    const int32 NumWorkers = FMath::Max(1, Settings.NumWorkers);
+    const int32 MaxDepth = FMath::Clamp(Settings.MaxDepth, 1, 255);
+
+    // EvaluateForEnemies is within +-10 for a finished battle and +-2 per unit otherwise
+    const float ScoreBound = 10.0f + 2.0f * State.Units.Num();
+
+    FSearchNode Working;
+    Working.State = State;
+    Working.State.Events.Reset();
+    FRandomStream CommitStream(Seed);
+
+    TArray<FBattleSimAction> Candidates;
+    TArray<FSearchWorkerResult> Results;
+
+    const int32 NumEnemies = State.EnemyIndices.Num();
+    for (int32 Ordinal = 0; Ordinal < NumEnemies; ++Ordinal)
+    {
+        if (CheckBattleEndConditions(Working.State)) break;
+
+        const int32 Enemy = Working.State.EnemyIndices[Ordinal];
+        GetEnemyCandidates(Working.State, Enemy, Candidates);
+        if (Candidates.Num() == 0) continue;
+
+        Working.EnemyOrdinal = Ordinal;
+
+        // Budget left unused by earlier enemies carries over to later ones
+        const double Deadline = StartTime + Settings.TimeBudgetSeconds * (Ordinal + 1) / NumEnemies;
+
+        Results.Reset();
+        Results.SetNumZeroed(NumWorkers);
+
+        if (Candidates.Num() > 1)
+        {
+            // Lazy SMP: every worker deepens the same root and they help each other through the table
+            ParallelFor(NumWorkers, [&](int32 Worker)
+            {
+                FSearchWorker Search(Table);
+                Search.Deadline = Deadline;
+                Search.bCancel = bCancel;
+                Search.Worker = Worker;
+                Search.ScoreBound = ScoreBound;
+
+                FSearchWorkerResult& Result = Results[Worker];
+                for (int32 Depth = 1; Depth <= MaxDepth; ++Depth)
+                {
+                    FSearchNode Root = Working;
+                    int32 BestMove = INDEX_NONE;
+                    SearchNode(Search, Root, Depth, -ScoreBound, ScoreBound, &BestMove);
+                    if (Search.bAborted) break;
+
+                    Result.Depth = Depth;
+                    Result.BestMove = BestMove;
+                }
+                Result.Nodes = Search.Nodes;
+            });
+        }
+
+        // Deepest finished iteration across workers; the first candidate is the fallback
+        int32 Best = 0;
+        int32 BestDepth = 0;
+        for (const FSearchWorkerResult& Result : Results)
+        {
+            Plan.SearchNodes += Result.Nodes;
+            if (Result.Depth > BestDepth && Candidates.IsValidIndex(Result.BestMove))
+            {
+                BestDepth = Result.Depth;
+                Best = Result.BestMove;
+            }
+        }
+        Plan.SearchDepth = Plan.Actions.Num() == 0 ? BestDepth : FMath::Min(Plan.SearchDepth, BestDepth);
+
+        Plan.Actions.Add(Candidates[Best]);
+        ApplyPlannedEnemyAction(Working.State, Candidates[Best], CommitStream);
+        Working.State.Events.Reset();
+    }
+
+    Plan.bHitBudget = FPlatformTime::Seconds() >= StartTime + Settings.TimeBudgetSeconds;
+    return Plan;
+}
+
+} // namespace BattleSim
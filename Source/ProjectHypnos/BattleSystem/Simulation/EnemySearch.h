@@ -0,0 +1,35 @@
+// EnemySearch.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EnemyPlanner.h"
+#include "TranspositionTable.h"
+
+struct FEnemySearchSettings
+{
+    // Hard wall-clock limit for the whole enemy phase
+    double TimeBudgetSeconds = 0.05;
+
+    // Deepest iteration tried. A ply is one unit's decision; defense outcomes do not count.
+    int32 MaxDepth = 24;
+
+    // Workers share the transposition table and search the same position with different move orders
+    int32 NumWorkers = 4;
+};
+
+/**
+ * Expectiminimax search for boss enemy phases.
+ *
+ * Enemies maximize EvaluateForEnemies and players minimize it. Every enemy attack is followed by
+ * the defender choosing a defense the quadrant allows, then a chance node over its outcomes
+ * (success, partial, failure, counter), weighted by the share of the timing window each covers.
+ * Players search one attack per set, with their best element on each enemy, transforming first
+ * when they can, and then run out their clock, which keeps sets finite.
+ *
+ * Max and min nodes use alpha-beta with the shared table; chance nodes use Star1 bounds.
+ * Iterative deepening runs until the budget is spent and the deepest finished iteration wins.
+ */
+namespace BattleSim
+{
+    PROJECTHYPNOS_API FEnemyPlan SearchEnemyPhase(const FBattleSimState& State, FTranspositionTable& Table, const FEnemySearchSettings& Settings, int32 Seed, const std::atomic<bool>* bCancel = nullptr);
+}
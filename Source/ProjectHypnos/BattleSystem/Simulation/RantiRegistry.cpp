@@ -0,0 +1,135 @@
+// RantiRegistry.cpp
+#include "RantiRegistry.h"
+#include "BattleSimRules.h"
+
+int32 FRantiRegistry::FindOrAddCharacter(FName CharacterId)
+{
+    if (CharacterId.IsNone()) return INDEX_NONE;
+
+    if (const int32* Bit = CharacterBits.Find(CharacterId))
+    {
+        return *Bit;
+    }
+
+    if (CharacterBits.Num() >= MaxCharacters) return INDEX_NONE;
+
+    const int32 Bit = CharacterBits.Num();
+    CharacterBits.Add(CharacterId, Bit);
+    return Bit;
+}
+
+int32 FRantiRegistry::FindCharacter(FName CharacterId) const
+{
+    const int32* Bit = CharacterBits.Find(CharacterId);
+    return Bit ? *Bit : INDEX_NONE;
+}
+
+bool FRantiRegistry::AddCombo(const FRantiComboDesc& Desc)
+{
+    bool bRegistered = true;
+
+    uint64 Members = 0;
+    for (const FName& Member : Desc.Members)
+    {
+        const int32 Bit = FindOrAddCharacter(Member);
+        bRegistered &= Bit != INDEX_NONE;
+        Members |= Bit != INDEX_NONE ? 1ull << Bit : 0;
+    }
+
+    uint64 EOForm = 0;
+    for (const FName& Member : Desc.MembersInEOForm)
+    {
+        const int32 Bit = FindOrAddCharacter(Member);
+        bRegistered &= Bit != INDEX_NONE;
+        EOForm |= Bit != INDEX_NONE ? 1ull << Bit : 0;
+    }
+
+    uint8 Quadrants = 0;
+    for (EBattlePosition Position : Desc.AllowedPositions)
+    {
+        if ((int32)Position < NumQuadrants)
+        {
+            Quadrants |= 1 << (int32)Position;
+        }
+    }
+
+    SkillIndices.Add(Desc.SkillIndex);
+    if (!bRegistered)
+    {
+        // Every member required, in no quadrant at all
+        MemberMasks.Add(~0ull);
+        EOFormMasks.Add(0);
+        QuadrantMasks.Add(0);
+        return false;
+    }
+
+    MemberMasks.Add(Members | EOForm);
+    EOFormMasks.Add(EOForm);
+    QuadrantMasks.Add(Quadrants != 0 ? Quadrants : (1 << NumQuadrants) - 1);
+    return true;
+}
+
+FRantiPartyState FRantiRegistry::MakePartyState(const FBattleSimState& State)
+{
+    FRantiPartyState Party;
+    uint64 AtQuadrant[NumQuadrants] = {};
+
+    const FCombatUnitStore& Units = State.Units;
+    for (int32 Unit : State.PlayerOrder)
+    {
+        const int32 Bit = Units.CharacterBit[Unit];
+        if (Bit == INDEX_NONE) continue;
+
+        const uint64 Mask = 1ull << Bit;
+        Party.ReadyMask |= BattleSim::CanAct(Units, Unit) ? Mask : 0;
+        Party.EOFormMask |= Units.bIsInEOForm[Unit] ? Mask : 0;
+
+        const int32 Quadrant = (int32)Units.Position[Unit];
+        if (Quadrant < NumQuadrants)
+        {
+            AtQuadrant[Quadrant] |= Mask;
+        }
+    }
+
+    // Every combination of quadrants, so a combo's position check is one lookup
+    for (int32 Quadrants = 1; Quadrants < 16; ++Quadrants)
+    {
+        const int32 Lowest = FMath::CountTrailingZeros(Quadrants);
+        Party.InQuadrants[Quadrants] = Party.InQuadrants[Quadrants & (Quadrants - 1)] | AtQuadrant[Lowest];
+    }
+    return Party;
+}
+
+int32 FRantiRegistry::GetAvailable(const FRantiPartyState& Party, uint64 RequiredMask, TArray<int32>& OutCombos) const
+{
+    OutCombos.Reset();
+    for (int32 Combo = 0; Combo < MemberMasks.Num(); ++Combo)
+    {
+        if ((MemberMasks[Combo] & RequiredMask) == RequiredMask && IsAvailable(Combo, Party))
+        {
+            OutCombos.Add(Combo);
+        }
+    }
+    return OutCombos.Num();
+}
+
+bool FRantiRegistry::IsAnyAvailable(const FRantiPartyState& Party, uint64 RequiredMask) const
+{
+    for (int32 Combo = 0; Combo < MemberMasks.Num(); ++Combo)
+    {
+        if ((MemberMasks[Combo] & RequiredMask) == RequiredMask && IsAvailable(Combo, Party))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FRantiRegistry::Reset()
+{
+    MemberMasks.Reset();
+    EOFormMasks.Reset();
+    QuadrantMasks.Reset();
+    SkillIndices.Reset();
+    CharacterBits.Reset();
+}
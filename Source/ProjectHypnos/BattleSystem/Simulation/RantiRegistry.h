@@ -0,0 +1,75 @@
+// RantiRegistry.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BattleSimTypes.h"
+
+struct FBattleSimState;
+
+// Party as the Ranti registry sees it. Bit N of each mask is the character registered with bit N.
+struct FRantiPartyState
+{
+    uint64 ReadyMask = 0;     // Alive and able to act
+    uint64 EOFormMask = 0;
+
+    // Characters standing in any of the quadrants in the index (bit 0 North .. bit 3 West)
+    uint64 InQuadrants[16] = {};
+};
+
+// One combo as authored, before it is compiled into masks
+struct FRantiComboDesc
+{
+    TArray<FName> Members;
+    TArray<FName> MembersInEOForm;          // Must also be listed in Members
+    TArray<EBattlePosition> AllowedPositions; // Empty means anywhere
+    int32 SkillIndex = INDEX_NONE;          // Skill the combo performs, in the skill table
+};
+
+/**
+ * Every Ranti combo, with its party requirements compiled to bitmasks. Checking a combo is a few
+ * ANDs against an FRantiPartyState built once per query, so hundreds of combos cost nothing.
+ */
+struct PROJECTHYPNOS_API FRantiRegistry
+{
+    static constexpr int32 MaxCharacters = 64;
+    static constexpr int32 NumQuadrants = 4;
+
+    // Bit for CharacterId, assigning the next free one. INDEX_NONE once every bit is taken.
+    int32 FindOrAddCharacter(FName CharacterId);
+    int32 FindCharacter(FName CharacterId) const;
+
+    // Combos are indexed in the order they are added. Returns false, and adds a combo that is never
+    // available, if one of its members could not be registered.
+    bool AddCombo(const FRantiComboDesc& Desc);
+
+    int32 Num() const { return MemberMasks.Num(); }
+    bool IsValidIndex(int32 Combo) const { return MemberMasks.IsValidIndex(Combo); }
+    int32 GetSkillIndex(int32 Combo) const { return SkillIndices[Combo]; }
+    uint64 GetMemberMask(int32 Combo) const { return MemberMasks[Combo]; }
+
+    static FRantiPartyState MakePartyState(const FBattleSimState& State);
+
+    bool IsAvailable(int32 Combo, const FRantiPartyState& Party) const
+    {
+        const uint64 Members = MemberMasks[Combo];
+        const uint64 Missing = (Members & ~Party.ReadyMask)
+            | (EOFormMasks[Combo] & ~Party.EOFormMask)
+            | (Members & ~Party.InQuadrants[QuadrantMasks[Combo]]);
+        return Missing == 0;
+    }
+
+    // Available combos that include every character in RequiredMask. Returns how many were found.
+    int32 GetAvailable(const FRantiPartyState& Party, uint64 RequiredMask, TArray<int32>& OutCombos) const;
+    bool IsAnyAvailable(const FRantiPartyState& Party, uint64 RequiredMask) const;
+
+    void Reset();
+
+private:
+    // Combo requirements, one array per field so availability scans stay in cache
+    TArray<uint64> MemberMasks;
+    TArray<uint64> EOFormMasks;
+    TArray<uint8> QuadrantMasks;
+    TArray<int32> SkillIndices;
+
+    TMap<FName, int32> CharacterBits;
+};
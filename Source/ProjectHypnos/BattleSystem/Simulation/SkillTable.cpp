@@ -0,0 +1,43 @@
+// SkillTable.cpp
+#include "SkillTable.h"
+
+namespace
+{
+    struct FSkillTableHeader
+    {
+        uint32 Magic;
+        uint16 Version;
+        uint16 EntrySize;
+        int32 NumEntries;
+    };
+}
+
+void FSkillTable::Save(TArray<uint8>& OutBytes) const
+{
+    FSkillTableHeader Header;
+    Header.Magic = Magic;
+    Header.Version = Version;
+    Header.EntrySize = sizeof(FSkillEntry);
+    Header.NumEntries = Entries.Num();
+
+    const int32 EntryBytes = Entries.Num() * sizeof(FSkillEntry);
+    OutBytes.SetNumUninitialized(sizeof(Header) + EntryBytes);
+    FMemory::Memcpy(OutBytes.GetData(), &Header, sizeof(Header));
+    FMemory::Memcpy(OutBytes.GetData() + sizeof(Header), Entries.GetData(), EntryBytes);
+}
+
+bool FSkillTable::Load(TConstArrayView<uint8> Bytes)
+{
+    Entries.Reset();
+
+    FSkillTableHeader Header;
+    if (Bytes.Num() < (int32)sizeof(Header)) return false;
+    FMemory::Memcpy(&Header, Bytes.GetData(), sizeof(Header));
+
+    if (Header.Magic != Magic || Header.Version != Version || Header.EntrySize != sizeof(FSkillEntry)) return false;
+    if (Header.NumEntries < 0 || Bytes.Num() != (int32)sizeof(Header) + Header.NumEntries * (int32)sizeof(FSkillEntry)) return false;
+
+    Entries.SetNumUninitialized(Header.NumEntries);
+    FMemory::Memcpy(Entries.GetData(), Bytes.GetData() + sizeof(Header), Header.NumEntries * sizeof(FSkillEntry));
+    return true;
+}
@@ -0,0 +1,48 @@
+// SkillTable.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BattleSimTypes.h"
+
+namespace ESkillFlags
+{
+    enum : uint8
+    {
+        None = 0,
+        RequiresEOForm = 1 << 0
+    };
+}
+
+// One compiled skill. Fixed layout with no pointers, so a whole table is a single block copy.
+struct FSkillEntry
+{
+    float MPCost = 0.0f;
+    float DamageCoefficient = 0.0f;   // Per hit, times FBattleSimTuning::BaseAttackDamage
+    EElementalType Element = EElementalType::Physical;
+    ESkillTargeting Targeting = ESkillTargeting::SingleEnemy;
+    uint8 HitCount = 1;
+    uint8 Flags = ESkillFlags::None;
+};
+static_assert(sizeof(FSkillEntry) == 12, "FSkillEntry is stored as raw bytes; bump FSkillTable::Version when it changes");
+
+/**
+ * Every skill in the game, compiled from DataAssets by USkillDatabase. A skill's ID at runtime is
+ * its index here. Names are only used to find that index when an action is built, never while it runs.
+ */
+struct PROJECTHYPNOS_API FSkillTable
+{
+    static constexpr uint32 Magic = 0x424B5453; // "STKB"
+    static constexpr uint16 Version = 1;
+
+    TArray<FSkillEntry> Entries;
+
+    int32 Num() const { return Entries.Num(); }
+    bool IsValidIndex(int32 SkillIndex) const { return Entries.IsValidIndex(SkillIndex); }
+    const FSkillEntry& operator[](int32 SkillIndex) const { return Entries[SkillIndex]; }
+
+    // Binary form: a small header followed by Entries as one block
+    void Save(TArray<uint8>& OutBytes) const;
+
+    // Returns false, leaving the table empty, if Bytes were written by a different version
+    bool Load(TConstArrayView<uint8> Bytes);
+};
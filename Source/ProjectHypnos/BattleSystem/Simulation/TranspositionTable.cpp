@@ -0,0 +1,61 @@
+// TranspositionTable.cpp
+#include "TranspositionTable.h"
+
+FTranspositionTable::FTranspositionTable(int32 SizeLog2)
+{
+    const int32 Bits = FMath::Clamp(SizeLog2, 4, 28);
+    Mask = (1ull << Bits) - 1;
+    Slots = MakeUnique<FSlot[]>(Mask + 1);
+}
+
+uint64 FTranspositionTable::Pack(const FTranspositionEntry& Entry)
+{
+    uint32 ScoreBits;
+    FMemory::Memcpy(&ScoreBits, &Entry.Score, sizeof(ScoreBits));
+    return (uint64)ScoreBits | (uint64)Entry.Depth << 32 | (uint64)Entry.Bound << 40 | (uint64)Entry.BestMove << 48;
+}
+
+FTranspositionEntry FTranspositionTable::Unpack(uint64 Data)
+{
+    FTranspositionEntry Entry;
+    const uint32 ScoreBits = (uint32)Data;
+    FMemory::Memcpy(&Entry.Score, &ScoreBits, sizeof(ScoreBits));
+    Entry.Depth = (uint8)(Data >> 32);
+    Entry.Bound = (ETranspositionBound)(uint8)(Data >> 40);
+    Entry.BestMove = (uint8)(Data >> 48);
+    return Entry;
+}
+
+bool FTranspositionTable::Probe(uint64 Key, FTranspositionEntry& OutEntry) const
+{
+    const FSlot& Slot = Slots[Key & Mask];
+    const uint64 Data = Slot.Data.load(std::memory_order_relaxed);
+    const uint64 KeyXorData = Slot.KeyXorData.load(std::memory_order_relaxed);
+
+    // Empty slots unpack to Bound::None, so they miss too
+    if ((KeyXorData ^ Data) != Key) return false;
+
+    OutEntry = Unpack(Data);
+    return OutEntry.Bound != ETranspositionBound::None;
+}
+
+void FTranspositionTable::Store(uint64 Key, const FTranspositionEntry& Entry)
+{
+    FSlot& Slot = Slots[Key & Mask];
+    const uint64 OldData = Slot.Data.load(std::memory_order_relaxed);
+    const uint64 OldKey = Slot.KeyXorData.load(std::memory_order_relaxed) ^ OldData;
+    if (OldKey == Key && Unpack(OldData).Depth > Entry.Depth) return;
+
+    const uint64 Data = Pack(Entry);
+    Slot.KeyXorData.store(Key ^ Data, std::memory_order_relaxed);
+    Slot.Data.store(Data, std::memory_order_relaxed);
+}
+
+void FTranspositionTable::Clear()
+{
+    for (uint64 Index = 0; Index <= Mask; ++Index)
+    {
+        Slots[Index].KeyXorData.store(0, std::memory_order_relaxed);
+        Slots[Index].Data.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,58 @@
+// TranspositionTable.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+enum class ETranspositionBound : uint8
+{
+    None,
+    Exact,
+    Lower, // Score is at least this (search failed high)
+    Upper  // Score is at most this (search failed low)
+};
+
+struct FTranspositionEntry
+{
+    float Score = 0.0f;
+    uint8 Depth = 0;
+    ETranspositionBound Bound = ETranspositionBound::None;
+    uint8 BestMove = 0; // Index into the node's candidate list
+};
+
+/**
+ * Fixed-size hash table of searched positions, keyed by a Zobrist hash (BattleSimHash.h).
+ *
+ * Any number of threads may probe and store at once without locks. Each slot holds the entry and
+ * the key XORed with the entry; a slot torn by two racing stores no longer XORs back to its key,
+ * so the probe misses instead of returning a mixed entry.
+ */
+class PROJECTHYPNOS_API FTranspositionTable
+{
+public:
+    // 2^SizeLog2 slots of 16 bytes each
+    explicit FTranspositionTable(int32 SizeLog2 = 16);
+
+    bool Probe(uint64 Key, FTranspositionEntry& OutEntry) const;
+
+    // Replaces another position's entry, or a shallower entry for the same position
+    void Store(uint64 Key, const FTranspositionEntry& Entry);
+
+    // Not safe while a search is running
+    void Clear();
+
+    int32 Num() const { return (int32)(Mask + 1); }
+
+private:
+    struct FSlot
+    {
+        std::atomic<uint64> KeyXorData{0};
+        std::atomic<uint64> Data{0};
+    };
+
+    static uint64 Pack(const FTranspositionEntry& Entry);
+    static FTranspositionEntry Unpack(uint64 Data);
+
+    TUniquePtr<FSlot[]> Slots;
+    uint64 Mask = 0;
+};
@@ -0,0 +1,164 @@
+// TurnTimeline.cpp
+#include "TurnTimeline.h"
+#include "BattleSimRules.h"
+
+namespace
+{
+    // Same rounding as the turn deadline: a turn lasts at least one tick
+    int64 TimerToTicks(int64 TimerUnits, int32 Rate)
+    {
+        return FMath::Max<int64>(1, (TimerUnits + Rate - 1) / Rate);
+    }
+
+    // Player turns run, or will run once the battle is resumed
+    bool IsPlayerPhase(const FBattleSimState& State)
+    {
+        const EBattleState Phase = State.BattleState == EBattleState::Paused ? State.StateBeforePause : State.BattleState;
+        return Phase == EBattleState::PlayerTurn
+            && !State.bIsSetComplete && BattleSim::GetCurrentUnit(State) != INDEX_NONE;
+    }
+}
+
+void FTurnTimeline::Reset()
+{
+    Slots.Reset();
+    NumEntries = 0;
+    bHasCurrentTurn = false;
+    CurrentUnitIndex = INDEX_NONE;
+    TFNRate = 0;
+    ++Version;
+}
+
+int64 FTurnTimeline::GetCurrentTurnTicksLeft(const FBattleSimState& State)
+{
+    if (!IsPlayerPhase(State)) return 0;
+    return TimerToTicks(BattleSim::GetTimerRemaining(State), State.TFNRate);
+}
+
+int64 FTurnTimeline::GetTicksUntil(const FBattleSimState& State, int32 Index) const
+{
+    if (Index < 0 || Index >= NumEntries || Entries[Index].bNextSet) return INDEX_NONE;
+    if (Index == 0 && bHasCurrentTurn) return 0;
+    return GetCurrentTurnTicksLeft(State) + Entries[Index].StartTicks;
+}
+
+bool FTurnTimeline::UpdateSlot(FSlot& Slot, const FBattleSimState& State, int32 Position, bool bRateChanged)
+{
+    const FCombatUnitStore& Units = State.Units;
+    const int32 Unit = State.PlayerOrder[Position];
+
+    // The running turn spends all of its unit's time, so the draining value never matters
+    const bool bRunning = Position == State.CurrentUnitIndex && IsPlayerPhase(State);
+    const int64 TimerRemaining = bRunning ? 0 : Units.TimerRemaining[Unit];
+    const bool bCanAct = BattleSim::CanAct(Units, Unit);
+
+    if (!bRateChanged && Slot.Unit == Unit && Slot.TimerRemaining == TimerRemaining && Slot.bCanAct == bCanAct
+        && Slot.TimerDuration == Units.TimerDuration[Unit] && Slot.StockpiledTime == Units.StockpiledTime[Unit])
+    {
+        return false;
+    }
+
+    Slot.Unit = Unit;
+    Slot.TimerRemaining = TimerRemaining;
+    Slot.TimerDuration = Units.TimerDuration[Unit];
+    Slot.StockpiledTime = Units.StockpiledTime[Unit];
+    Slot.bCanAct = bCanAct;
+    Slot.ThisSetTicks = TimerToTicks(TimerRemaining, State.TFNRate);
+    Slot.NextSetTicks = TimerToTicks(Slot.TimerDuration + Slot.StockpiledTime, BattleClock::RateOne);
+    return true;
+}
+
+void FTurnTimeline::AddEntry(int32 Unit, bool bNextSet, int64 StartTicks, int64 DurationTicks)
+{
+    if (NumEntries == MaxEntries) return;
+
+    FTurnTimelineEntry& Entry = Entries[NumEntries++];
+    Entry.Unit = Unit;
+    Entry.bNextSet = bNextSet;
+    Entry.StartTicks = StartTicks;
+    Entry.DurationTicks = DurationTicks;
+}
+
+bool FTurnTimeline::Update(const FBattleSimState& State)
+{
+    const int32 NumSlots = State.PlayerOrder.Num();
+    bool bChanged = Slots.Num() != NumSlots;
+    if (bChanged)
+    {
+        Slots.SetNum(NumSlots);
+    }
+
+    // A different running unit changes which slot's timer is ignored
+    const bool bRateChanged = TFNRate != State.TFNRate;
+    const bool bTurnChanged = CurrentUnitIndex != State.CurrentUnitIndex || BattleState != State.BattleState
+        || bIsSetComplete != State.bIsSetComplete;
+    bChanged |= bRateChanged || bTurnChanged;
+
+    TFNRate = State.TFNRate;
+    CurrentUnitIndex = State.CurrentUnitIndex;
+    BattleState = State.BattleState;
+    bIsSetComplete = State.bIsSetComplete;
+
+    for (int32 Position = 0; Position < NumSlots; ++Position)
+    {
+        bChanged |= UpdateSlot(Slots[Position], State, Position, bRateChanged || bTurnChanged);
+    }
+
+    if (!bChanged) return false;
+
+    NumEntries = 0;
+    bHasCurrentTurn = false;
+    ++Version;
+
+    if (BattleSim::IsBattleOver(State)) return true;
+
+    if (IsPlayerPhase(State))
+    {
+        const int32 Current = State.CurrentUnitIndex;
+        AddEntry(Slots[Current].Unit, false, 0, GetCurrentTurnTicksLeft(State));
+        bHasCurrentTurn = true;
+
+        // Rest of this cycle
+        int64 Offset = 0;
+        for (int32 Position = Current + 1; Position < NumSlots; ++Position)
+        {
+            const FSlot& Slot = Slots[Position];
+            if (!Slot.bCanAct) continue;
+
+            AddEntry(Slot.Unit, false, Offset, Slot.ThisSetTicks);
+            Offset += Slot.ThisSetTicks;
+        }
+
+        // Everyone from here on has run out, so only units that ended earlier turns early can restart the cycle
+        bool bAnyUnitHasTime = false;
+        for (int32 Position = 0; Position < Current; ++Position)
+        {
+            bAnyUnitHasTime |= Slots[Position].bCanAct && Slots[Position].TimerRemaining > 0;
+        }
+
+        if (bAnyUnitHasTime)
+        {
+            for (int32 Position = 0; Position < NumSlots; ++Position)
+            {
+                const FSlot& Slot = Slots[Position];
+                if (!Slot.bCanAct) continue;
+
+                const int64 Ticks = Position < Current ? Slot.ThisSetTicks : 1;
+                AddEntry(Slot.Unit, false, Offset, Ticks);
+                Offset += Ticks;
+            }
+        }
+    }
+
+    // Next set, once the enemy phase is over
+    int64 Offset = 0;
+    for (const FSlot& Slot : Slots)
+    {
+        if (!Slot.bCanAct) continue;
+
+        AddEntry(Slot.Unit, true, Offset, Slot.NextSetTicks);
+        Offset += Slot.NextSetTicks;
+    }
+
+    return true;
+}
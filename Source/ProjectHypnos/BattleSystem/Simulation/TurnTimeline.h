@@ -0,0 +1,86 @@
+// TurnTimeline.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BattleSimState.h"
+
+// One predicted player turn
+struct FTurnTimelineEntry
+{
+    int32 Unit = INDEX_NONE;    // Index into FBattleSimState::Units
+    bool bNextSet = false;      // Comes after the enemy phase
+
+    // From the end of the running turn, or from the start of the next set if bNextSet
+    int64 StartTicks = 0;
+    int64 DurationTicks = 0;
+};
+
+/**
+ * Predicted order of the coming player turns over the rest of the current set and the next one,
+ * assuming every turn runs its timer out, which is also the latest each turn can start. Follows
+ * EndCurrentUnitTurn: units that cannot act are skipped, a unit with no time left still gets its
+ * one-tick turn, and the set cycles again while anyone has time. The rest of the set drains at its
+ * TFN rate; the next set starts from full timers plus stockpiles at normal speed.
+ *
+ * Update only recomputes the units whose timer, stockpile or ability to act changed since the last
+ * call (every unit if the TFN rate or the running turn did). The running turn's draining timer is
+ * not an input, so a frame in which only the clock moved costs one compare per unit. Entries live
+ * in fixed storage.
+ */
+class PROJECTHYPNOS_API FTurnTimeline
+{
+public:
+    static constexpr int32 MaxEntries = 16;
+
+    void Reset();
+
+    // Returns true if the prediction changed
+    bool Update(const FBattleSimState& State);
+
+    int32 Num() const { return NumEntries; }
+    const FTurnTimelineEntry& operator[](int32 Index) const { return Entries[Index]; }
+
+    // True if entry 0 is the turn running now. Its DurationTicks is not kept up to date; use GetCurrentTurnTicksLeft.
+    bool HasCurrentTurn() const { return bHasCurrentTurn; }
+
+    // Ticks from State's clock until entry Index starts, or INDEX_NONE if it comes after the enemy phase
+    int64 GetTicksUntil(const FBattleSimState& State, int32 Index) const;
+
+    // Bumped each time Update changes the prediction
+    uint32 GetVersion() const { return Version; }
+
+    static int64 GetCurrentTurnTicksLeft(const FBattleSimState& State);
+
+private:
+    // What the prediction for one PlayerOrder slot depends on
+    struct FSlot
+    {
+        int32 Unit = INDEX_NONE;
+        int64 TimerRemaining = -1;
+        int64 TimerDuration = -1;
+        int64 StockpiledTime = -1;
+        bool bCanAct = false;
+
+        // Cached turn lengths for the rest of this set and for the next one
+        int64 ThisSetTicks = 0;
+        int64 NextSetTicks = 0;
+    };
+
+    // Refreshes Slot from State. Returns true if any input changed.
+    static bool UpdateSlot(FSlot& Slot, const FBattleSimState& State, int32 Position, bool bRateChanged);
+
+    void AddEntry(int32 Unit, bool bNextSet, int64 StartTicks, int64 DurationTicks);
+
+    TArray<FSlot> Slots;
+    FTurnTimelineEntry Entries[MaxEntries];
+    int32 NumEntries = 0;
+    bool bHasCurrentTurn = false;
+
+    // Turn flow inputs
+    EBattleState BattleState = EBattleState::PlayerTurn;
+    int32 CurrentUnitIndex = INDEX_NONE;
+    int32 TFNRate = 0;
+    bool bIsSetComplete = false;
+
+    uint32 Version = 0;
+};
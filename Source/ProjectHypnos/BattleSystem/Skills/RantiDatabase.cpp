@@ -0,0 +1,31 @@
+// RantiDatabase.cpp
+#include "RantiDatabase.h"
+#include "SkillDatabase.h"
+#include "../Simulation/RantiRegistry.h"
+#include "../BattleLog.h"
+
+void URantiDatabase::BuildRegistry(FRantiRegistry& OutRegistry, const USkillDatabase* Skills) const
+{
+    OutRegistry.Reset();
+
+    for (const FRantiComboDefinition& Definition : Combos)
+    {
+        FRantiComboDesc Desc;
+        Desc.Members = Definition.Members;
+        Desc.MembersInEOForm = Definition.MembersInEOForm;
+        Desc.AllowedPositions = Definition.AllowedPositions;
+        Desc.SkillIndex = Skills ? Skills->FindSkillIndex(Definition.SkillId) : INDEX_NONE;
+
+        // Indices stay lined up with Combos even when a combo cannot be registered
+        if (!OutRegistry.AddCombo(Desc))
+        {
+            BATTLE_LOG(LogBattle, Warning, TEXT("%s: Ranti combo %s has an empty member or more than %d characters in total, it will never be available"),
+                   *GetName(), *Definition.ComboId.ToString(), FRantiRegistry::MaxCharacters);
+        }
+    }
+}
+
+int32 URantiDatabase::FindComboIndex(FName ComboId) const
+{
+    return Combos.IndexOfByPredicate([ComboId](const FRantiComboDefinition& Definition) { return Definition.ComboId == ComboId; });
+}
@@ -0,0 +1,51 @@
+// RantiDatabase.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "../Simulation/BattleSimTypes.h"
+#include "RantiDatabase.generated.h"
+
+class USkillDatabase;
+struct FRantiRegistry;
+
+USTRUCT(BlueprintType)
+struct FRantiComboDefinition
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ranti")
+    FName ComboId;
+
+    // Matched against ACombatUnit::CharacterId
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ranti")
+    TArray<FName> Members;
+
+    // Members that must be in EO form
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ranti")
+    TArray<FName> MembersInEOForm;
+
+    // Quadrants every member must stand in. Empty means anywhere.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ranti")
+    TArray<EBattlePosition> AllowedPositions;
+
+    // Skill performed, by ID in the skill database
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ranti")
+    FName SkillId;
+};
+
+// Every Ranti combo. Compiled into an FRantiRegistry of bitmasks when a battle begins.
+UCLASS(BlueprintType)
+class PROJECTHYPNOS_API URantiDatabase : public UDataAsset
+{
+    GENERATED_BODY()
+
+public:
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ranti")
+    TArray<FRantiComboDefinition> Combos;
+
+    // Fills OutRegistry, combo i matching Combos[i]. Unknown skills leave the combo with no effect.
+    void BuildRegistry(FRantiRegistry& OutRegistry, const USkillDatabase* Skills) const;
+
+    int32 FindComboIndex(FName ComboId) const;
+};
@@ -0,0 +1,19 @@
+// SkillDataAsset.cpp
+#include "SkillDataAsset.h"
+
+FName USkillDataAsset::GetSkillId() const
+{
+    return SkillId.IsNone() ? GetFName() : SkillId;
+}
+
+FSkillEntry USkillDataAsset::Compile() const
+{
+    FSkillEntry Entry;
+    Entry.MPCost = MPCost;
+    Entry.DamageCoefficient = DamageCoefficient;
+    Entry.Element = Element;
+    Entry.Targeting = Targeting;
+    Entry.HitCount = (uint8)FMath::Clamp(HitCount, 1, 255);
+    Entry.Flags = bRequiresEOForm ? ESkillFlags::RequiresEOForm : ESkillFlags::None;
+    return Entry;
+}
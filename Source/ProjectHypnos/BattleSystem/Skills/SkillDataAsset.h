@@ -0,0 +1,44 @@
+// SkillDataAsset.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "../Simulation/SkillTable.h"
+#include "SkillDataAsset.generated.h"
+
+// One authored skill. Only read in the editor; battles use the table USkillDatabase compiles.
+UCLASS(BlueprintType)
+class PROJECTHYPNOS_API USkillDataAsset : public UPrimaryDataAsset
+{
+    GENERATED_BODY()
+
+public:
+    // Defaults to the asset name when left empty
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Skill")
+    FName SkillId;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Skill")
+    FText DisplayName;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Skill")
+    EElementalType Element = EElementalType::Physical;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Skill")
+    ESkillTargeting Targeting = ESkillTargeting::SingleEnemy;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Skill", meta = (ClampMin = "0.0"))
+    float MPCost = 0.0f;
+
+    // Damage per hit as a multiple of the base attack damage. Zero for skills that deal no damage.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Skill", meta = (ClampMin = "0.0"))
+    float DamageCoefficient = 1.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Skill", meta = (ClampMin = "1", ClampMax = "255"))
+    int32 HitCount = 1;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Skill")
+    bool bRequiresEOForm = false;
+
+    FName GetSkillId() const;
+    FSkillEntry Compile() const;
+};
@@ -0,0 +1,76 @@
+// SkillDatabase.cpp
+#include "SkillDatabase.h"
+#include "SkillDataAsset.h"
+#include "../BattleLog.h"
+#include "UObject/ObjectSaveContext.h"
+
+void USkillDatabase::PostLoad()
+{
+    Super::PostLoad();
+    RebuildIdLookup();
+}
+
+#if WITH_EDITOR
+void USkillDatabase::PreSave(FObjectPreSaveContext SaveContext)
+{
+    CompileSkills();
+    Super::PreSave(SaveContext);
+}
+
+void USkillDatabase::CompileSkills()
+{
+    FSkillTable Table;
+    SkillIds.Reset();
+
+    for (const TSoftObjectPtr<USkillDataAsset>& SkillPtr : Skills)
+    {
+        const USkillDataAsset* Skill = SkillPtr.LoadSynchronous();
+        if (!Skill) continue;
+
+        const FName Id = Skill->GetSkillId();
+        if (SkillIds.Contains(Id))
+        {
+            BATTLE_LOG(LogBattle, Warning, TEXT("%s: skill ID %s is used more than once, keeping the first"), *GetName(), *Id.ToString());
+            continue;
+        }
+
+        SkillIds.Add(Id);
+        Table.Entries.Add(Skill->Compile());
+    }
+
+    Table.Save(CompiledTable);
+    RebuildIdLookup();
+}
+#endif
+
+bool USkillDatabase::LoadTable(FSkillTable& OutTable) const
+{
+    if (!OutTable.Load(CompiledTable) || OutTable.Num() != SkillIds.Num())
+    {
+        OutTable.Entries.Reset();
+        BATTLE_LOG(LogBattle, Warning, TEXT("%s: compiled skill table is out of date, resave the asset"), *GetName());
+        return false;
+    }
+    return true;
+}
+
+int32 USkillDatabase::FindSkillIndex(FName SkillId) const
+{
+    const int32* Index = IdToIndex.Find(SkillId);
+    return Index ? *Index : INDEX_NONE;
+}
+
+FName USkillDatabase::GetSkillId(int32 SkillIndex) const
+{
+    return SkillIds.IsValidIndex(SkillIndex) ? SkillIds[SkillIndex] : NAME_None;
+}
+
+void USkillDatabase::RebuildIdLookup()
+{
+    IdToIndex.Reset();
+    IdToIndex.Reserve(SkillIds.Num());
+    for (int32 Index = 0; Index < SkillIds.Num(); ++Index)
+    {
+        IdToIndex.Add(SkillIds[Index], Index);
+    }
+}
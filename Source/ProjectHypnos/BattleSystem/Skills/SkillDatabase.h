@@ -0,0 +1,55 @@
+// SkillDatabase.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "../Simulation/SkillTable.h"
+#include "SkillDatabase.generated.h"
+
+class USkillDataAsset;
+
+/**
+ * The skill catalog. Authored skills are compiled into a binary FSkillTable when this asset is
+ * saved, so a battle loads one asset and one block of bytes however many skills exist.
+ */
+UCLASS(BlueprintType)
+class PROJECTHYPNOS_API USkillDatabase : public UDataAsset
+{
+    GENERATED_BODY()
+
+public:
+#if WITH_EDITORONLY_DATA
+    // Soft references, so the individual skill assets are never loaded with the database
+    UPROPERTY(EditAnywhere, Category = "Skills")
+    TArray<TSoftObjectPtr<USkillDataAsset>> Skills;
+#endif
+
+    virtual void PostLoad() override;
+
+#if WITH_EDITOR
+    virtual void PreSave(FObjectPreSaveContext SaveContext) override;
+
+    // Rebuilds the compiled table from Skills
+    UFUNCTION(CallInEditor, Category = "Skills")
+    void CompileSkills();
+#endif
+
+    // Copies the compiled table into OutTable. Returns false if it was built by an older version.
+    bool LoadTable(FSkillTable& OutTable) const;
+
+    // Index into the compiled table, or INDEX_NONE. Used when building actions, not while running them.
+    int32 FindSkillIndex(FName SkillId) const;
+    FName GetSkillId(int32 SkillIndex) const;
+
+private:
+    void RebuildIdLookup();
+
+    // Compiled output, parallel: SkillIds[i] names entry i of the table
+    UPROPERTY()
+    TArray<FName> SkillIds;
+
+    UPROPERTY()
+    TArray<uint8> CompiledTable;
+
+    TMap<FName, int32> IdToIndex;
+};
@@ -0,0 +1,88 @@
+// BattleSimPauseTest.cpp
+#include "Misc/AutomationTest.h"
+#include "../Simulation/BattleSimRules.h"
+#include "../Simulation/BattleSimHash.h"
+#include "../Simulation/BattleSnapshot.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    void BuildPauseTestRoster(FBattleSimState& State)
+    {
+        for (int32 PlayerIndex = 0; PlayerIndex < 2; ++PlayerIndex)
+        {
+            FBattleSimUnit Player;
+            Player.UnitType = EUnitType::Player;
+            BattleSim::AddUnit(State, Player);
+        }
+
+        FBattleSimUnit Enemy;
+        Enemy.UnitType = EUnitType::Enemy;
+        Enemy.Position = EBattlePosition::Center;
+        BattleSim::AddUnit(State, Enemy);
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBattleSimPauseDuringEnemyPhaseTest, "ProjectHypnos.BattleSim.PauseDuringEnemyPhase",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBattleSimPauseDuringEnemyPhaseTest::RunTest(const FString& Parameters)
+{
+    FBattleSimState State;
+    BuildPauseTestRoster(State);
+    BattleSim::StartBattle(State);
+
+    // Let every player turn run out, which completes the set and starts the enemy phase
+    for (int32 Second = 0; Second < 600 && State.BattleState == EBattleState::PlayerTurn; ++Second)
+    {
+        BattleSim::StepTicks(State, BattleClock::TicksPerSecond);
+    }
+    if (!TestTrue(TEXT("Set runs into the enemy phase"), State.BattleState == EBattleState::EnemyTurn)) return false;
+
+    // First of the planned enemy actions lands before the pause
+    FBattleSimAction Attack;
+    Attack.ActingUnit = State.EnemyIndices[0];
+    Attack.ActionType = EActionType::Attack;
+    Attack.TargetUnit = State.PlayerOrder[0];
+    BattleSim::ExecuteAction(State, Attack);
+
+    const int32 SetNumber = State.CurrentSetNumber;
+    const int32 UnitIndex = State.CurrentUnitIndex;
+    const uint64 EnemyPhaseHash = BattleSim::HashState(State);
+
+    BattleSim::PauseBattle(State);
+    TestTrue(TEXT("Paused"), State.BattleState == EBattleState::Paused);
+    TestNotEqual(TEXT("A paused enemy phase hashes apart from a running one"), BattleSim::HashState(State), EnemyPhaseHash);
+
+    // Pausing twice must not forget what was paused
+    BattleSim::PauseBattle(State);
+    TestTrue(TEXT("Second pause keeps the paused phase"), State.StateBeforePause == EBattleState::EnemyTurn);
+
+    // Snapshots taken while paused resume into the same phase
+    FBattleSnapshot PausedSnapshot;
+    TestTrue(TEXT("Snapshot captured"), BattleSim::CaptureSnapshot(State, EBattleSnapshotKind::Action, PausedSnapshot));
+
+    BattleSim::ResumeBattle(State);
+    TestTrue(TEXT("Resume returns to the enemy phase"), State.BattleState == EBattleState::EnemyTurn);
+    TestTrue(TEXT("Set is still complete"), State.bIsSetComplete);
+    TestEqual(TEXT("Set number unchanged"), State.CurrentSetNumber, SetNumber);
+    TestEqual(TEXT("Current unit unchanged"), State.CurrentUnitIndex, UnitIndex);
+    TestEqual(TEXT("Hash matches the state before the pause"), BattleSim::HashState(State), EnemyPhaseHash);
+
+    // The rest of the enemy phase plays out and the next set starts with a live deadline
+    BattleSim::ExecuteAction(State, Attack);
+    BattleSim::EndEnemyTurn(State);
+    TestTrue(TEXT("Next set is a player turn"), State.BattleState == EBattleState::PlayerTurn);
+    TestEqual(TEXT("Next set started"), State.CurrentSetNumber, SetNumber + 1);
+    TestNotEqual(TEXT("Next turn has a deadline"), State.TurnDeadlineTick, MAX_int64);
+
+    BattleSim::RestoreSnapshot(State, PausedSnapshot);
+    TestTrue(TEXT("Restored snapshot is paused"), State.BattleState == EBattleState::Paused);
+    BattleSim::ResumeBattle(State);
+    TestTrue(TEXT("Restored snapshot resumes into the enemy phase"), State.BattleState == EBattleState::EnemyTurn);
+
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,90 @@
+// BattleHUDText.cpp
+#include "BattleHUDText.h"
+
+namespace BattleHUDText
+{
+
+const FString& NumberString(int32 Value)
+{
+    static const TArray<FString> Numbers = []()
+    {
+        TArray<FString> Result;
+        Result.Reserve(MaxCachedNumber + 1);
+        for (int32 Number = 0; Number <= MaxCachedNumber; ++Number)
+        {
+            Result.Add(FString::FromInt(Number));
+        }
+        return Result;
+    }();
+    return Numbers[FMath::Clamp(Value, 0, MaxCachedNumber)];
+}
+
+const FText& Clock(int32 TotalSeconds)
+{
+    // Built on first use, 6000 entries, so the running timer never formats
+    static const TArray<FText> Clocks = []()
+    {
+        TArray<FText> Result;
+        Result.Reserve(MaxClockSeconds + 1);
+        for (int32 Seconds = 0; Seconds <= MaxClockSeconds; ++Seconds)
+        {
+            Result.Add(FText::FromString(FString::Printf(TEXT("%02d:%02d"), Seconds / 60, Seconds % 60)));
+        }
+        return Result;
+    }();
+    return Clocks[FMath::Clamp(TotalSeconds, 0, MaxClockSeconds)];
+}
+
+const FText& BattleState(EBattleState State)
+{
+    static const FText PlayerTurn = FText::FromString(TEXT("Player Turn"));
+    static const FText EnemyTurn = FText::FromString(TEXT("Enemy Turn"));
+    static const FText Victory = FText::FromString(TEXT("Victory!"));
+    static const FText Defeat = FText::FromString(TEXT("Defeat!"));
+    static const FText Paused = FText::FromString(TEXT("Paused"));
+    static const FText Unknown = FText::FromString(TEXT("Unknown"));
+
+    switch (State)
+    {
+        case EBattleState::PlayerTurn: return PlayerTurn;
+        case EBattleState::EnemyTurn: return EnemyTurn;
+        case EBattleState::Victory: return Victory;
+        case EBattleState::Defeat: return Defeat;
+        case EBattleState::Paused: return Paused;
+        default: return Unknown;
+    }
+}
+
+} // namespace BattleHUDText
+
+namespace
+{
+    void AppendNumber(FString& Out, int32 Value)
+    {
+        if (Value >= 0 && Value <= BattleHUDText::MaxCachedNumber)
+        {
+            Out += BattleHUDText::NumberString(Value);
+        }
+        else
+        {
+            Out.AppendInt(Value);
+        }
+    }
+}
+
+const FText& FBattleHUDTextCache::GetRatio(float Current, float Max)
+{
+    const int32 CurrentValue = FMath::RoundToInt(Current);
+    const int32 MaxValue = FMath::RoundToInt(Max);
+    const uint64 Key = ((uint64)(uint32)CurrentValue << 32) | (uint32)MaxValue;
+
+    return Get(Key, [CurrentValue, MaxValue]()
+    {
+        FString Result;
+        Result.Reserve(16);
+        AppendNumber(Result, CurrentValue);
+        Result += TEXT('/');
+        AppendNumber(Result, MaxValue);
+        return FText::FromString(MoveTemp(Result));
+    });
+}
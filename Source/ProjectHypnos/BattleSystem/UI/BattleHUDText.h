@@ -0,0 +1,52 @@
+// BattleHUDText.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "../Simulation/BattleSimTypes.h"
+
+/**
+ * Texts for the battle HUD's numeric labels. Each distinct value is formatted once and the same
+ * FText is handed out after that, so showing a value again costs a lookup and no allocation, and
+ * text blocks given an identical text skip their re-layout. Game thread only.
+ */
+namespace BattleHUDText
+{
+    static constexpr int32 MaxCachedNumber = 999;
+    static constexpr int32 MaxClockSeconds = 99 * 60 + 59;
+
+    // "0" to "999"; larger values are clamped
+    PROJECTHYPNOS_API const FString& NumberString(int32 Value);
+
+    // "mm:ss" for whole seconds, clamped to [0, 99:59]
+    PROJECTHYPNOS_API const FText& Clock(int32 TotalSeconds);
+
+    PROJECTHYPNOS_API const FText& BattleState(EBattleState State);
+}
+
+/**
+ * Formatted texts of one label, by an integer key for the value shown (e.g. a rounded number, or
+ * two packed together). Holds at most MaxEntries texts and starts over when full.
+ */
+class PROJECTHYPNOS_API FBattleHUDTextCache
+{
+public:
+    static constexpr int32 MaxEntries = 1024;
+
+    template <typename FormatFunc>
+    const FText& Get(uint64 Key, FormatFunc&& Format)
+    {
+        if (const FText* Found = Texts.Find(Key)) return *Found;
+
+        if (Texts.Num() >= MaxEntries)
+        {
+            Texts.Reset();
+        }
+        return Texts.Add(Key, Format());
+    }
+
+    // "Current/Max", both rounded to whole numbers
+    const FText& GetRatio(float Current, float Max);
+
+private:
+    TMap<uint64, FText> Texts;
+};
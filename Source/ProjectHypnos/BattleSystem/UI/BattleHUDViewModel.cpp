@@ -0,0 +1,127 @@
+// BattleHUDViewModel.cpp
+#include "BattleHUDViewModel.h"
+#include "../Managers/BattleManager.h"
+#include "../Units/CombatUnit.h"
+
+namespace
+{
+    // Value as it is formatted on screen, in steps of 1/Scale
+    int32 ToDisplayed(float Value, int32 Scale = 1)
+    {
+        return FMath::RoundToInt(Value * Scale);
+    }
+
+    // Takes New if it displays differently from Current, and marks Field
+    void Update(float& Current, float New, int32 Scale, EBattleHUDField Field, EBattleHUDField& Changed)
+    {
+        if (ToDisplayed(Current, Scale) != ToDisplayed(New, Scale))
+        {
+            Current = New;
+            Changed |= Field;
+        }
+    }
+
+    template <typename T>
+    void Update(T& Current, const T& New, EBattleHUDField Field, EBattleHUDField& Changed)
+    {
+        if (Current != New)
+        {
+            Current = New;
+            Changed |= Field;
+        }
+    }
+}
+
+void UBattleHUDViewModel::Refresh(const ABattleManager& Manager)
+{
+    EBattleHUDField Changed = bHasRefreshed ? EBattleHUDField::None : EBattleHUDField::All;
+    bHasRefreshed = true;
+
+    ACombatUnit* Unit = Manager.GetCurrentUnit();
+    if (CurrentUnit.Get() != Unit)
+    {
+        // A new unit redraws its whole panel, which may have been hidden or left over from setup
+        CurrentUnit = Unit;
+        Changed |= Unit ? EBattleHUDField::UnitFields : EBattleHUDField::CurrentUnit;
+    }
+
+    if (Unit)
+    {
+        // The text shows whole seconds, rounded down
+        const float Remaining = Manager.CurrentTimerRemaining;
+        if (FMath::FloorToInt(TimerRemaining) != FMath::FloorToInt(Remaining))
+        {
+            Changed |= EBattleHUDField::TimerText;
+        }
+        TimerRemaining = Remaining;
+
+        const float TimerPercent = Unit->TimerDuration > 0.0f ? FMath::Clamp(Remaining / Unit->TimerDuration, 0.0f, 1.0f) : 0.0f;
+        Update(TimerBarStep, FMath::RoundToInt(TimerPercent * BarSteps), EBattleHUDField::TimerBar, Changed);
+
+        Update(HP, Unit->CurrentHP, 1, EBattleHUDField::HP, Changed);
+        Update(MaxHP, Unit->MaxHP, 1, EBattleHUDField::HP, Changed);
+        Update(EO, Unit->GetCurrentEO(), 1, EBattleHUDField::EO, Changed);
+        Update(MaxEO, Unit->MaxEO, 1, EBattleHUDField::EO, Changed);
+        Update(MP, Unit->CurrentMP, 1, EBattleHUDField::MP, Changed);
+        Update(MaxMP, Unit->MaxMP, 1, EBattleHUDField::MP, Changed);
+        Update(bInEOForm, Unit->bIsInEOForm, EBattleHUDField::EOForm, Changed);
+        Update(bStressedOut, Unit->bIsStressedOut, EBattleHUDField::StressedOut, Changed);
+        Update(StockpiledTime, Unit->StockpiledTime, 10, EBattleHUDField::Stockpile, Changed);
+    }
+
+    Update(SetNumber, Manager.CurrentSetNumber, EBattleHUDField::BattleInfo, Changed);
+    Update(BattleState, Manager.CurrentBattleState, EBattleHUDField::BattleInfo, Changed);
+    Update(bTFNActive, Manager.bTFNActive, EBattleHUDField::TFN, Changed);
+    Update(TFNSpeedMultiplier, Manager.TFNSpeedMultiplier, 100, EBattleHUDField::TFN, Changed);
+
+    Update(TurnOrderVersion, Manager.GetTurnTimeline().GetVersion(), EBattleHUDField::TurnOrder, Changed);
+
+    RefreshParty(Manager, Changed);
+
+    if (Changed != EBattleHUDField::None)
+    {
+        OnChanged.Broadcast(Changed);
+    }
+}
+
+void UBattleHUDViewModel::RefreshParty(const ABattleManager& Manager, EBattleHUDField& Changed)
+{
+    const TArray<ACombatUnit*>& Members = Manager.PlayerUnits;
+    if (Party.Num() != Members.Num())
+    {
+        Party.SetNum(Members.Num());
+        PartyUnits.SetNum(Members.Num());
+        Changed |= EBattleHUDField::Party;
+    }
+
+    const ACombatUnit* ActingUnit = CurrentUnit.Get();
+    for (int32 Index = 0; Index < Members.Num(); ++Index)
+    {
+        ACombatUnit* Member = Members[Index];
+        if (!Member) continue;
+
+        FBattlePartyStatusRow& Row = Party[Index];
+        if (PartyUnits[Index].Get() != Member)
+        {
+            PartyUnits[Index] = Member;
+            Row.Name = FText::FromString(Member->UnitName);
+            Changed |= EBattleHUDField::Party;
+        }
+
+        // Only the acting unit's timer drains between syncs
+        const bool bIsActing = Member == ActingUnit;
+        const float Remaining = bIsActing ? Manager.CurrentTimerRemaining : Member->TimerRemaining;
+        const float TimerFraction = Member->TimerDuration > 0.0f ? FMath::Clamp(Remaining / Member->TimerDuration, 0.0f, 1.0f) : 0.0f;
+
+        Update(Row.HP, Member->CurrentHP, 1, EBattleHUDField::Party, Changed);
+        Update(Row.MaxHP, Member->MaxHP, 1, EBattleHUDField::Party, Changed);
+        Update(Row.EO, Member->GetCurrentEO(), 1, EBattleHUDField::Party, Changed);
+        Update(Row.MaxEO, Member->MaxEO, 1, EBattleHUDField::Party, Changed);
+        Update(Row.MP, Member->CurrentMP, 1, EBattleHUDField::Party, Changed);
+        Update(Row.MaxMP, Member->MaxMP, 1, EBattleHUDField::Party, Changed);
+        Update(Row.TimerFraction, TimerFraction, BarSteps, EBattleHUDField::Party, Changed);
+        Update(Row.bInEOForm, Member->bIsInEOForm, EBattleHUDField::Party, Changed);
+        Update(Row.bIsActing, bIsActing, EBattleHUDField::Party, Changed);
+        Update(Row.bIsAlive, Member->IsAlive(), EBattleHUDField::Party, Changed);
+    }
+}
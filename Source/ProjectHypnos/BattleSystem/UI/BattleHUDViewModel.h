@@ -0,0 +1,108 @@
+// BattleHUDViewModel.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "../Simulation/BattleSimTypes.h"
+#include "SBattlePartyStatus.h"
+#include "BattleHUDViewModel.generated.h"
+
+class ABattleManager;
+class ACombatUnit;
+
+// What a Refresh changed. Each flag covers the widgets that show one displayed value.
+enum class EBattleHUDField : uint16
+{
+    None        = 0,
+    CurrentUnit = 1 << 0,
+    TimerBar    = 1 << 1,
+    TimerText   = 1 << 2,
+    HP          = 1 << 3,
+    EO          = 1 << 4,
+    MP          = 1 << 5,
+    EOForm      = 1 << 6,
+    StressedOut = 1 << 7,
+    Stockpile   = 1 << 8,
+    BattleInfo  = 1 << 9,
+    TFN         = 1 << 10,
+    Party       = 1 << 11,
+    TurnOrder   = 1 << 12,
+    UnitFields  = CurrentUnit | TimerBar | TimerText | HP | EO | MP | EOForm | StressedOut | Stockpile,
+    All         = (1 << 13) - 1
+};
+ENUM_CLASS_FLAGS(EBattleHUDField);
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnBattleHUDChanged, EBattleHUDField /*Changed*/);
+
+/**
+ * What the battle HUD shows, kept at display precision. The battle manager refreshes it as the
+ * simulation moves; a value only counts as changed once its on-screen form does (the timer text
+ * once a second, bars in BarSteps increments), so widgets rebuild text and layout only then.
+ */
+UCLASS()
+class PROJECTHYPNOS_API UBattleHUDViewModel : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    static constexpr int32 BarSteps = 200;
+
+    // Broadcast at most once per Refresh, with every field that changed
+    FOnBattleHUDChanged OnChanged;
+
+    void Refresh(const ABattleManager& Manager);
+
+    ACombatUnit* GetCurrentUnit() const { return CurrentUnit.Get(); }
+    float GetTimerRemaining() const { return TimerRemaining; }
+    float GetTimerPercent() const { return (float)TimerBarStep / BarSteps; }
+
+    float GetHP() const { return HP; }
+    float GetMaxHP() const { return MaxHP; }
+    float GetEO() const { return EO; }
+    float GetMaxEO() const { return MaxEO; }
+    float GetMP() const { return MP; }
+    float GetMaxMP() const { return MaxMP; }
+    bool IsInEOForm() const { return bInEOForm; }
+    bool IsStressedOut() const { return bStressedOut; }
+    float GetStockpiledTime() const { return StockpiledTime; }
+
+    int32 GetSetNumber() const { return SetNumber; }
+    EBattleState GetBattleState() const { return BattleState; }
+    bool IsTFNActive() const { return bTFNActive; }
+    float GetTFNSpeedMultiplier() const { return TFNSpeedMultiplier; }
+
+    // One row per player unit, in PlayerUnits order
+    TArrayView<const FBattlePartyStatusRow> GetParty() const { return Party; }
+
+private:
+    TWeakObjectPtr<ACombatUnit> CurrentUnit;
+
+    float TimerRemaining = 0.0f;
+    int32 TimerBarStep = 0;
+
+    float HP = 0.0f;
+    float MaxHP = 0.0f;
+    float EO = 0.0f;
+    float MaxEO = 0.0f;
+    float MP = 0.0f;
+    float MaxMP = 0.0f;
+    bool bInEOForm = false;
+    bool bStressedOut = false;
+    float StockpiledTime = 0.0f;
+
+    int32 SetNumber = 0;
+    EBattleState BattleState = EBattleState::PlayerTurn;
+    bool bTFNActive = false;
+    float TFNSpeedMultiplier = 1.0f;
+
+    TArray<FBattlePartyStatusRow> Party;
+    TArray<TWeakObjectPtr<ACombatUnit>> PartyUnits;
+
+    // Turn order is read from the manager's timeline; only its version is tracked here
+    uint32 TurnOrderVersion = 0;
+
+    void RefreshParty(const ABattleManager& Manager, EBattleHUDField& Changed);
+
+    // First Refresh reports everything, so a widget bound before the battle starts still fills in
+    bool bHasRefreshed = false;
+};
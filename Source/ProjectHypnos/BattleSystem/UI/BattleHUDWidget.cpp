@@ -1,12 +1,15 @@
 // BattleHUDWidget.cpp
 #include "BattleHUDWidget.h"
+#include "BattleHUDText.h"
+#include "BattlePartyStatusPanel.h"
 #include "Components/ProgressBar.h"
 #include "Components/TextBlock.h"
 #include "Components/Button.h"
 #include "../Managers/BattleManager.h"
 #include "../Managers/DefenseManager.h"
 #include "../Managers/PositionManager.h"
-#include "Kismet/GameplayStatics.h"
+#include "../Managers/BattleWorldSubsystem.h"
+#include "../BattleLog.h"
 
 UBattleHUDWidget::UBattleHUDWidget(const FObjectInitializer& ObjectInitializer)
     : Super(ObjectInitializer)
@@ -21,45 +24,25 @@ void UBattleHUDWidget::NativeConstruct()
     Super::NativeConstruct();
     InitializeManagers();
     BindButtonEvents();
+    BindViewModel();
 }
 
-void UBattleHUDWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
+void UBattleHUDWidget::NativeDestruct()
 {
-    Super::NativeTick(MyGeometry, InDeltaTime);
-
-    // Update timer display if we have a current unit
-    if (BattleManager && BattleManager->GetCurrentUnit())
-    {
-        ACombatUnit* Unit = BattleManager->GetCurrentUnit();
-        UpdateTimerDisplay(Unit->TimerRemaining, Unit->TimerDuration);
-        UpdateUnitStatus(Unit);
-    }
+    UnbindViewModel();
+    Super::NativeDestruct();
 }
 
 void UBattleHUDWidget::InitializeManagers()
 {
-    // Find managers in the world
-    TArray<AActor*> FoundActors;
-    
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABattleManager::StaticClass(), FoundActors);
-    if (FoundActors.Num() > 0)
-    {
-        BattleManager = Cast<ABattleManager>(FoundActors[0]);
-    }
+    // Find the managers of this widget's battle
+    UBattleWorldSubsystem* Battles = UBattleWorldSubsystem::Get(this);
+    if (!Battles) return;
 
-    FoundActors.Empty();
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), ADefenseManager::StaticClass(), FoundActors);
-    if (FoundActors.Num() > 0)
-    {
-        DefenseManager = Cast<ADefenseManager>(FoundActors[0]);
-    }
-
-    FoundActors.Empty();
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), APositionManager::StaticClass(), FoundActors);
-    if (FoundActors.Num() > 0)
-    {
-        PositionManager = Cast<APositionManager>(FoundActors[0]);
-    }
+    const FBattleHandle Battle = Battles->FindBattle(BattleId);
+    BattleManager = Battles->GetBattleManager(Battle);
+    DefenseManager = Battles->GetDefenseManager(Battle);
+    PositionManager = Battles->GetPositionManager(Battle);
 }
 
 void UBattleHUDWidget::BindButtonEvents()
@@ -135,7 +118,7 @@ void UBattleHUDWidget::OnUnitTurnEnded(ACombatUnit* InUnit)
     // Clear current unit display
     if (CurrentUnitText)
     {
-        CurrentUnitText->SetText(FText::FromString(TEXT("")));
+        CurrentUnitText->SetText(FText::GetEmpty());
     }
 }
 
@@ -144,7 +127,7 @@ void UBattleHUDWidget::OnSetComplete()
     if (SetNumberText)
     {
         CurrentSetNumber++;
-        SetNumberText->SetText(FText::FromString(FString::Printf(TEXT("Set %d"), CurrentSetNumber)));
+        SetNumberText->SetText(GetSetNumberText(CurrentSetNumber));
     }
 }
 
@@ -152,7 +135,7 @@ void UBattleHUDWidget::OnEnemyTurnStarted()
 {
     if (BattleStateText)
     {
-        BattleStateText->SetText(FText::FromString(TEXT("Enemy Turn")));
+        BattleStateText->SetText(BattleHUDText::BattleState(EBattleState::EnemyTurn));
     }
 }
 
@@ -166,7 +149,7 @@ void UBattleHUDWidget::UpdateTimerDisplay(float RemainingTime, float MaxTime)
 
     if (TimerText)
     {
-        TimerText->SetText(FText::FromString(FormatTime(RemainingTime)));
+        TimerText->SetText(BattleHUDText::Clock(FMath::FloorToInt(RemainingTime)));
     }
 }
 
@@ -183,19 +166,19 @@ void UBattleHUDWidget::UpdateUnitStatus(ACombatUnit* Unit)
 
     if (HPText)
     {
-        HPText->SetText(FText::FromString(FString::Printf(TEXT("%.0f/%.0f"), Unit->CurrentHP, Unit->MaxHP)));
+        HPText->SetText(HPTexts.GetRatio(Unit->CurrentHP, Unit->MaxHP));
     }
 
     // Update EO Bar
     if (EOBar)
     {
-        float EOPercent = Unit->CurrentEO / Unit->MaxEO;
+        float EOPercent = Unit->GetCurrentEO() / Unit->MaxEO;
         EOBar->SetPercent(EOPercent);
     }
 
     if (EOText)
     {
-        EOText->SetText(FText::FromString(FString::Printf(TEXT("%.0f/%.0f"), Unit->CurrentEO, Unit->MaxEO)));
+        EOText->SetText(EOTexts.GetRatio(Unit->GetCurrentEO(), Unit->MaxEO));
     }
 
     // Update MP Bar (only visible in EO form)
@@ -217,7 +200,7 @@ void UBattleHUDWidget::UpdateUnitStatus(ACombatUnit* Unit)
     {
         if (Unit->bIsInEOForm)
         {
-            MPText->SetText(FText::FromString(FString::Printf(TEXT("%.0f/%.0f"), Unit->CurrentMP, Unit->MaxMP)));
+            MPText->SetText(MPTexts.GetRatio(Unit->CurrentMP, Unit->MaxMP));
             MPText->SetVisibility(ESlateVisibility::Visible);
         }
         else
@@ -234,12 +217,12 @@ void UBattleHUDWidget::UpdateBattleInfo(int32 SetNumber, EBattleState BattleStat
 {
     if (SetNumberText)
     {
-        SetNumberText->SetText(FText::FromString(FString::Printf(TEXT("Set %d"), SetNumber)));
+        SetNumberText->SetText(GetSetNumberText(SetNumber));
     }
 
     if (BattleStateText)
     {
-        BattleStateText->SetText(FText::FromString(GetBattleStateString(BattleState)));
+        BattleStateText->SetText(BattleHUDText::BattleState(BattleState));
     }
 }
 
@@ -252,7 +235,7 @@ void UBattleHUDWidget::UpdateActionButtons(bool bIsPlayerTurn, ACombatUnit* InCu
     SetButtonEnabled(SkillButton, bCanAct);
     SetButtonEnabled(ItemButton, bCanAct);
     SetButtonEnabled(PassButton, bCanAct);
-    SetButtonEnabled(RantiButton, bCanAct);
+    SetButtonEnabled(RantiButton, bCanAct && BattleManager && BattleManager->IsAnyRantiAvailable(InCurrentUnit));
     SetButtonEnabled(TransformButton, bCanAct && InCurrentUnit && InCurrentUnit->CanTransformToEO());
 }
 
@@ -271,9 +254,11 @@ void UBattleHUDWidget::UpdateDefenseButtons(EBattlePosition CurrentPosition)
 {
     if (!DefenseManager) return;
 
-    SetButtonEnabled(GuardButton, DefenseManager->CanUseGuard(CurrentPosition));
-    SetButtonEnabled(DodgeButton, DefenseManager->CanUseDodge(CurrentPosition));
-    SetButtonEnabled(ParryButton, DefenseManager->CanUseParry(CurrentPosition));
+    // One lookup covers all three buttons
+    const FDefenseOptions& Options = DefenseManager->GetDefenseOptions(CurrentPosition);
+    SetButtonEnabled(GuardButton, Options.IsAvailable(EDefenseType::Guard));
+    SetButtonEnabled(DodgeButton, Options.IsAvailable(EDefenseType::Dodge));
+    SetButtonEnabled(ParryButton, Options.IsAvailable(EDefenseType::Parry));
 }
 
 void UBattleHUDWidget::ShowTFNStatus(bool bActive, float SpeedMultiplier)
@@ -282,7 +267,10 @@ void UBattleHUDWidget::ShowTFNStatus(bool bActive, float SpeedMultiplier)
     {
         if (bActive)
         {
-            TFNStatusText->SetText(FText::FromString(FString::Printf(TEXT("TFN Active: %.2fx Speed"), SpeedMultiplier)));
+            TFNStatusText->SetText(TFNTexts.Get(FMath::RoundToInt(SpeedMultiplier * 100.0f), [SpeedMultiplier]()
+            {
+                return FText::FromString(FString::Printf(TEXT("TFN Active: %.2fx Speed"), SpeedMultiplier));
+            }));
             TFNStatusText->SetVisibility(ESlateVisibility::Visible);
         }
         else
@@ -301,7 +289,7 @@ void UBattleHUDWidget::ShowStatusEffects(ACombatUnit* Unit)
     {
         if (Unit->bIsStressedOut)
         {
-            StressedOutText->SetText(FText::FromString(TEXT("STRESSED OUT")));
+            StressedOutText->SetText(GetStressedOutText());
             StressedOutText->SetVisibility(ESlateVisibility::Visible);
         }
         else
@@ -315,7 +303,155 @@ void UBattleHUDWidget::ShowStatusEffects(ACombatUnit* Unit)
     {
         if (Unit->StockpiledTime > 0.0f)
         {
-            StockpileText->SetText(FText::FromString(FString::Printf(TEXT("SP: +%.1fs"), Unit->StockpiledTime)));
+            StockpileText->SetText(GetStockpileText(Unit->StockpiledTime));
+            StockpileText->SetVisibility(ESlateVisibility::Visible);
+        }
+        else
+        {
+            StockpileText->SetVisibility(ESlateVisibility::Hidden);
+        }
+    }
+}
+
+void UBattleHUDWidget::BindViewModel()
+{
+    UnbindViewModel();
+    if (!BattleManager || !BattleManager->GetHUDViewModel()) return;
+
+    ViewModel = BattleManager->GetHUDViewModel();
+    ViewModelChangedHandle = ViewModel->OnChanged.AddUObject(this, &UBattleHUDWidget::OnViewModelChanged);
+
+    // Fill in whatever the battle already shows
+    OnViewModelChanged(EBattleHUDField::All);
+}
+
+void UBattleHUDWidget::UnbindViewModel()
+{
+    if (UBattleHUDViewModel* Bound = ViewModel.Get())
+    {
+        Bound->OnChanged.Remove(ViewModelChangedHandle);
+    }
+    ViewModel.Reset();
+    ViewModelChangedHandle.Reset();
+}
+
+void UBattleHUDWidget::OnViewModelChanged(EBattleHUDField Changed)
+{
+    const UBattleHUDViewModel* Model = ViewModel.Get();
+    if (!Model) return;
+
+    if (EnumHasAnyFlags(Changed, EBattleHUDField::CurrentUnit))
+    {
+        CurrentUnit = Model->GetCurrentUnit();
+        if (CurrentUnitText)
+        {
+            CurrentUnitText->SetText(CurrentUnit ? FText::FromString(CurrentUnit->UnitName) : FText::GetEmpty());
+        }
+    }
+
+    if (EnumHasAnyFlags(Changed, EBattleHUDField::BattleInfo))
+    {
+        CurrentSetNumber = Model->GetSetNumber();
+        CurrentBattleState = Model->GetBattleState();
+        UpdateBattleInfo(CurrentSetNumber, CurrentBattleState);
+    }
+
+    if (EnumHasAnyFlags(Changed, EBattleHUDField::TFN))
+    {
+        ShowTFNStatus(Model->IsTFNActive(), Model->GetTFNSpeedMultiplier());
+    }
+
+    if (PartyStatus && EnumHasAnyFlags(Changed, EBattleHUDField::Party))
+    {
+        PartyStatus->SetRows(Model->GetParty());
+    }
+
+    if (EnumHasAnyFlags(Changed, EBattleHUDField::TurnOrder))
+    {
+        UpdateTurnOrder();
+    }
+
+    // The rest describes the current unit
+    if (!CurrentUnit) return;
+
+    if (TimerBar && EnumHasAnyFlags(Changed, EBattleHUDField::TimerBar))
+    {
+        TimerBar->SetPercent(Model->GetTimerPercent());
+    }
+
+    if (TimerText && EnumHasAnyFlags(Changed, EBattleHUDField::TimerText))
+    {
+        TimerText->SetText(BattleHUDText::Clock(FMath::FloorToInt(Model->GetTimerRemaining())));
+    }
+
+    if (EnumHasAnyFlags(Changed, EBattleHUDField::HP))
+    {
+        if (HPBar)
+        {
+            HPBar->SetPercent(Model->GetMaxHP() > 0.0f ? Model->GetHP() / Model->GetMaxHP() : 0.0f);
+        }
+        if (HPText)
+        {
+            HPText->SetText(HPTexts.GetRatio(Model->GetHP(), Model->GetMaxHP()));
+        }
+    }
+
+    if (EnumHasAnyFlags(Changed, EBattleHUDField::EO))
+    {
+        if (EOBar)
+        {
+            EOBar->SetPercent(Model->GetMaxEO() > 0.0f ? Model->GetEO() / Model->GetMaxEO() : 0.0f);
+        }
+        if (EOText)
+        {
+            EOText->SetText(EOTexts.GetRatio(Model->GetEO(), Model->GetMaxEO()));
+        }
+    }
+
+    // MP only shows in EO form
+    if (EnumHasAnyFlags(Changed, EBattleHUDField::EOForm))
+    {
+        const ESlateVisibility MPVisibility = Model->IsInEOForm() ? ESlateVisibility::Visible : ESlateVisibility::Hidden;
+        if (MPBar)
+        {
+            MPBar->SetVisibility(MPVisibility);
+        }
+        if (MPText)
+        {
+            MPText->SetVisibility(MPVisibility);
+        }
+    }
+
+    if (Model->IsInEOForm() && EnumHasAnyFlags(Changed, EBattleHUDField::MP | EBattleHUDField::EOForm))
+    {
+        if (MPBar)
+        {
+            MPBar->SetPercent(Model->GetMaxMP() > 0.0f ? Model->GetMP() / Model->GetMaxMP() : 0.0f);
+        }
+        if (MPText)
+        {
+            MPText->SetText(MPTexts.GetRatio(Model->GetMP(), Model->GetMaxMP()));
+        }
+    }
+
+    if (StressedOutText && EnumHasAnyFlags(Changed, EBattleHUDField::StressedOut))
+    {
+        if (Model->IsStressedOut())
+        {
+            StressedOutText->SetText(GetStressedOutText());
+            StressedOutText->SetVisibility(ESlateVisibility::Visible);
+        }
+        else
+        {
+            StressedOutText->SetVisibility(ESlateVisibility::Hidden);
+        }
+    }
+
+    if (StockpileText && EnumHasAnyFlags(Changed, EBattleHUDField::Stockpile))
+    {
+        if (Model->GetStockpiledTime() > 0.0f)
+        {
+            StockpileText->SetText(GetStockpileText(Model->GetStockpiledTime()));
             StockpileText->SetVisibility(ESlateVisibility::Visible);
         }
         else
@@ -325,6 +461,33 @@ void UBattleHUDWidget::ShowStatusEffects(ACombatUnit* Unit)
     }
 }
 
+void UBattleHUDWidget::UpdateTurnOrder()
+{
+    if (!TurnOrderText || !BattleManager) return;
+
+    // Only rebuilt when the prediction changes, at most once per turn or TFN/SP change
+    static constexpr int32 MaxShownTurns = 6;
+    const FTurnTimeline& Timeline = BattleManager->GetTurnTimeline();
+
+    FString Order;
+    bool bInNextSet = false;
+    for (int32 Turn = 0; Turn < FMath::Min(Timeline.Num(), MaxShownTurns); ++Turn)
+    {
+        const ACombatUnit* Unit = BattleManager->GetUnitActor(Timeline[Turn].Unit);
+        if (Timeline[Turn].bNextSet && !bInNextSet)
+        {
+            Order += Turn > 0 ? TEXT(" | Next set: ") : TEXT("Next set: ");
+            bInNextSet = true;
+        }
+        else if (Turn > 0)
+        {
+            Order += TEXT(" > ");
+        }
+        Order += Unit ? Unit->UnitName : TEXT("?");
+    }
+    TurnOrderText->SetText(FText::FromString(MoveTemp(Order)));
+}
+
 // Button Click Handlers
 void UBattleHUDWidget::OnMoveButtonClicked()
 {
@@ -340,7 +503,7 @@ void UBattleHUDWidget::OnAttackButtonClicked()
     if (BattleManager && CurrentUnit)
     {
         // TODO: Implement target selection
-        UE_LOG(LogTemp, Log, TEXT("%s attacks!"), *CurrentUnit->UnitName);
+        BATTLE_LOG(LogBattle, Log, TEXT("%s attacks!"), *CurrentUnit->UnitName);
     }
 }
 
@@ -349,7 +512,7 @@ void UBattleHUDWidget::OnSkillButtonClicked()
     if (BattleManager && CurrentUnit)
     {
         // TODO: Implement skill selection
-        UE_LOG(LogTemp, Log, TEXT("%s uses skill!"), *CurrentUnit->UnitName);
+        BATTLE_LOG(LogBattle, Log, TEXT("%s uses skill!"), *CurrentUnit->UnitName);
     }
 }
 
@@ -358,7 +521,7 @@ void UBattleHUDWidget::OnItemButtonClicked()
     if (BattleManager && CurrentUnit)
     {
         // TODO: Implement item selection
-        UE_LOG(LogTemp, Log, TEXT("%s uses item!"), *CurrentUnit->UnitName);
+        BATTLE_LOG(LogBattle, Log, TEXT("%s uses item!"), *CurrentUnit->UnitName);
     }
 }
 
@@ -383,15 +546,15 @@ void UBattleHUDWidget::OnRantiButtonClicked()
     if (BattleManager && CurrentUnit)
     {
         // TODO: Implement Ranti skill selection
-        UE_LOG(LogTemp, Log, TEXT("%s uses Ranti skill!"), *CurrentUnit->UnitName);
+        BATTLE_LOG(LogBattle, Log, TEXT("%s uses Ranti skill!"), *CurrentUnit->UnitName);
     }
 }
 
 void UBattleHUDWidget::OnTransformButtonClicked()
 {
-    if (CurrentUnit && CurrentUnit->CanTransformToEO())
+    if (BattleManager && CurrentUnit && CurrentUnit->CanTransformToEO())
     {
-        CurrentUnit->TransformToEO();
+        BattleManager->TransformToEO(CurrentUnit);
         UpdateUnitStatus(CurrentUnit);
     }
 }
@@ -483,28 +646,34 @@ void UBattleHUDWidget::SetButtonVisible(UButton* Button, bool bVisible)
 
 FString UBattleHUDWidget::FormatTime(float TimeInSeconds)
 {
-    int32 Minutes = FMath::FloorToInt(TimeInSeconds / 60.0f);
-    int32 Seconds = FMath::FloorToInt(TimeInSeconds) % 60;
-    return FString::Printf(TEXT("%02d:%02d"), Minutes, Seconds);
+    return BattleHUDText::Clock(FMath::FloorToInt(TimeInSeconds)).ToString();
 }
 
 FString UBattleHUDWidget::GetBattleStateString(EBattleState State)
 {
-    switch (State)
-    {
-        case EBattleState::PlayerTurn:
-            return TEXT("Player Turn");
-        case EBattleState::EnemyTurn:
-            return TEXT("Enemy Turn");
-        case EBattleState::Victory:
-            return TEXT("Victory!");
-        case EBattleState::Defeat:
-            return TEXT("Defeat!");
-        case EBattleState::Paused:
-            return TEXT("Paused");
-        default:
-            return TEXT("Unknown");
-    }
+    return BattleHUDText::BattleState(State).ToString();
+}
+
+const FText& UBattleHUDWidget::GetSetNumberText(int32 SetNumber)
+{
+    return SetNumberTexts.Get((uint32)SetNumber, [SetNumber]()
+    {
+        return FText::FromString(FString::Printf(TEXT("Set %d"), SetNumber));
+    });
+}
+
+const FText& UBattleHUDWidget::GetStockpileText(float StockpiledTime)
+{
+    return StockpileTexts.Get(FMath::RoundToInt(StockpiledTime * 10.0f), [StockpiledTime]()
+    {
+        return FText::FromString(FString::Printf(TEXT("SP: +%.1fs"), StockpiledTime));
+    });
+}
+
+const FText& UBattleHUDWidget::GetStressedOutText()
+{
+    static const FText StressedOut = FText::FromString(TEXT("STRESSED OUT"));
+    return StressedOut;
 }
 
 void UBattleHUDWidget::UpdateAllUI()
@@ -5,6 +5,8 @@
 #include "Blueprint/UserWidget.h"
 #include "../Units/CombatUnit.h"
 #include "../Managers/BattleManager.h" // For EBattleState
+#include "BattleHUDViewModel.h"
+#include "BattleHUDText.h"
 #include "BattleHUDWidget.generated.h"
 
 UCLASS(Blueprintable)
@@ -16,7 +18,11 @@ public:
     UBattleHUDWidget(const FObjectInitializer& ObjectInitializer);
 
     virtual void NativeConstruct() override;
-    virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
+    virtual void NativeDestruct() override;
+
+    // Battle this HUD shows, matching the managers' BattleId
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Battle UI", meta = (ExposeOnSpawn = true))
+    FName BattleId;
 
     // UI Elements - Timer
     UPROPERTY(meta = (BindWidget))
@@ -113,6 +119,10 @@ public:
     UPROPERTY(meta = (BindWidget))
     class UTextBlock* StockpileText;
 
+    // UI Elements - Party Status (optional)
+    UPROPERTY(meta = (BindWidgetOptional))
+    class UBattlePartyStatusPanel* PartyStatus;
+
     // Events
     UFUNCTION(BlueprintCallable, Category = "Battle UI")
     void OnBattleStateChanged(EBattleState NewState);
@@ -203,6 +213,10 @@ public:
     UPROPERTY(meta = (BindWidget))
     class UTextBlock* TurnOrderHelpText;
 
+    // Predicted turn order, e.g. "A > B > C | Next set: A > B" (optional)
+    UPROPERTY(meta = (BindWidgetOptional))
+    class UTextBlock* TurnOrderText;
+
     UFUNCTION(BlueprintCallable, Category = "Battle UI")
     void ShowTFNStatus(bool bActive, float SpeedMultiplier);
 
@@ -231,7 +245,27 @@ protected:
     EBattleState CurrentBattleState;
     int32 CurrentSetNumber;
 
+    // Shows the battle manager's view model. Widgets are only touched when a shown value changes.
+    TWeakObjectPtr<UBattleHUDViewModel> ViewModel;
+    FDelegateHandle ViewModelChangedHandle;
+
     void InitializeManagers();
     void BindButtonEvents();
+    void BindViewModel();
+    void UnbindViewModel();
+    void OnViewModelChanged(EBattleHUDField Changed);
+    void UpdateTurnOrder();
     void UpdateAllUI();
+
+    // Label texts, formatted once per distinct value and reused after that
+    FBattleHUDTextCache HPTexts;
+    FBattleHUDTextCache EOTexts;
+    FBattleHUDTextCache MPTexts;
+    FBattleHUDTextCache StockpileTexts;
+    FBattleHUDTextCache TFNTexts;
+    FBattleHUDTextCache SetNumberTexts;
+
+    const FText& GetSetNumberText(int32 SetNumber);
+    const FText& GetStockpileText(float StockpiledTime);
+    static const FText& GetStressedOutText();
 };
\ No newline at end of file
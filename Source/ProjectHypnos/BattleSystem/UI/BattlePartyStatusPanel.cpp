@@ -0,0 +1,57 @@
+// BattlePartyStatusPanel.cpp
+#include "BattlePartyStatusPanel.h"
+
+#define LOCTEXT_NAMESPACE "BattlePartyStatusPanel"
+
+void UBattlePartyStatusPanel::SetRows(TArrayView<const FBattlePartyStatusRow> Rows)
+{
+    if (MyPartyStatus.IsValid())
+    {
+        MyPartyStatus->SetRows(Rows);
+    }
+}
+
+TSharedRef<SWidget> UBattlePartyStatusPanel::RebuildWidget()
+{
+    MyPartyStatus = SNew(SBattlePartyStatus);
+    return MyPartyStatus.ToSharedRef();
+}
+
+void UBattlePartyStatusPanel::SynchronizeProperties()
+{
+    Super::SynchronizeProperties();
+
+    if (!MyPartyStatus.IsValid()) return;
+
+    FBattlePartyStatusAppearance Appearance;
+    Appearance.RowHeight = RowHeight;
+    Appearance.NameWidth = NameWidth;
+    Appearance.BarWidth = BarWidth;
+    Appearance.BarHeight = BarHeight;
+    Appearance.Spacing = Spacing;
+    Appearance.Font = Font;
+    Appearance.NameColor = NameColor;
+    Appearance.ActingColor = ActingColor;
+    Appearance.TextColor = TextColor;
+    Appearance.BackgroundColor = BackgroundColor;
+    Appearance.HPColor = HPColor;
+    Appearance.EOColor = EOColor;
+    Appearance.MPColor = MPColor;
+    Appearance.TimerColor = TimerColor;
+    MyPartyStatus->SetAppearance(Appearance);
+}
+
+void UBattlePartyStatusPanel::ReleaseSlateResources(bool bReleaseChildren)
+{
+    Super::ReleaseSlateResources(bReleaseChildren);
+    MyPartyStatus.Reset();
+}
+
+#if WITH_EDITOR
+const FText UBattlePartyStatusPanel::GetPaletteCategory()
+{
+    return LOCTEXT("Battle", "Battle");
+}
+#endif
+
+#undef LOCTEXT_NAMESPACE
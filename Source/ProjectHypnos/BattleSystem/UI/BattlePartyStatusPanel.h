@@ -0,0 +1,73 @@
+// BattlePartyStatusPanel.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/Widget.h"
+#include "SBattlePartyStatus.h"
+#include "BattlePartyStatusPanel.generated.h"
+
+// UMG wrapper for SBattlePartyStatus: the whole party's status bars as one widget
+UCLASS()
+class PROJECTHYPNOS_API UBattlePartyStatusPanel : public UWidget
+{
+    GENERATED_BODY()
+
+public:
+    UPROPERTY(EditAnywhere, Category = "Appearance", meta = (ClampMin = "1.0"))
+    float RowHeight = 28.0f;
+
+    UPROPERTY(EditAnywhere, Category = "Appearance", meta = (ClampMin = "0.0"))
+    float NameWidth = 90.0f;
+
+    UPROPERTY(EditAnywhere, Category = "Appearance", meta = (ClampMin = "1.0"))
+    float BarWidth = 110.0f;
+
+    UPROPERTY(EditAnywhere, Category = "Appearance", meta = (ClampMin = "1.0"))
+    float BarHeight = 12.0f;
+
+    UPROPERTY(EditAnywhere, Category = "Appearance", meta = (ClampMin = "0.0"))
+    float Spacing = 6.0f;
+
+    UPROPERTY(EditAnywhere, Category = "Appearance")
+    FSlateFontInfo Font;
+
+    UPROPERTY(EditAnywhere, Category = "Appearance")
+    FLinearColor NameColor = FLinearColor::White;
+
+    // Name color of the unit whose turn it is
+    UPROPERTY(EditAnywhere, Category = "Appearance")
+    FLinearColor ActingColor = FLinearColor(1.0f, 0.85f, 0.2f);
+
+    UPROPERTY(EditAnywhere, Category = "Appearance")
+    FLinearColor TextColor = FLinearColor::White;
+
+    UPROPERTY(EditAnywhere, Category = "Appearance")
+    FLinearColor BackgroundColor = FLinearColor(0.0f, 0.0f, 0.0f, 0.6f);
+
+    UPROPERTY(EditAnywhere, Category = "Appearance")
+    FLinearColor HPColor = FLinearColor(0.2f, 0.8f, 0.3f);
+
+    UPROPERTY(EditAnywhere, Category = "Appearance")
+    FLinearColor EOColor = FLinearColor(0.3f, 0.5f, 1.0f);
+
+    UPROPERTY(EditAnywhere, Category = "Appearance")
+    FLinearColor MPColor = FLinearColor(0.7f, 0.3f, 0.9f);
+
+    UPROPERTY(EditAnywhere, Category = "Appearance")
+    FLinearColor TimerColor = FLinearColor(1.0f, 0.85f, 0.2f);
+
+    // Repaints only the parts that changed on screen
+    void SetRows(TArrayView<const FBattlePartyStatusRow> Rows);
+
+    virtual void SynchronizeProperties() override;
+    virtual void ReleaseSlateResources(bool bReleaseChildren) override;
+
+#if WITH_EDITOR
+    virtual const FText GetPaletteCategory() override;
+#endif
+
+protected:
+    virtual TSharedRef<SWidget> RebuildWidget() override;
+
+    TSharedPtr<SBattlePartyStatus> MyPartyStatus;
+};
@@ -0,0 +1,173 @@
+// SBattlePartyStatus.cpp
+#include "SBattlePartyStatus.h"
+#include "Rendering/DrawElements.h"
+#include "Styling/CoreStyle.h"
+
+void SBattlePartyStatus::Construct(const FArguments& InArgs)
+{
+    Brush = FCoreStyle::Get().GetBrush("WhiteBrush");
+    SetAppearance(FBattlePartyStatusAppearance());
+}
+
+void SBattlePartyStatus::SetAppearance(const FBattlePartyStatusAppearance& InAppearance)
+{
+    Appearance = InAppearance;
+    if (!Appearance.Font.HasValidFont())
+    {
+        Appearance.Font = FCoreStyle::GetDefaultFontStyle("Regular", 10);
+    }
+
+    float Offset = Appearance.NameWidth + Appearance.Spacing;
+    for (int32 Bar = 0; Bar < NumBars; ++Bar)
+    {
+        BarOffsets[Bar] = Offset;
+        Offset += Appearance.BarWidth + Appearance.Spacing;
+    }
+
+    // Fills are measured in bar pixels, so every row is stale now
+    for (FRowState& State : Rows)
+    {
+        for (int32& Pixels : State.FillPixels)
+        {
+            Pixels = INDEX_NONE;
+        }
+    }
+    Invalidate(EInvalidateWidgetReason::Layout);
+}
+
+void SBattlePartyStatus::SetRows(TArrayView<const FBattlePartyStatusRow> InRows)
+{
+    bool bChanged = false;
+    if (Rows.Num() != InRows.Num())
+    {
+        Rows.SetNum(InRows.Num());
+        Invalidate(EInvalidateWidgetReason::Layout);
+    }
+
+    for (int32 Row = 0; Row < InRows.Num(); ++Row)
+    {
+        bChanged |= UpdateRowState(Rows[Row], InRows[Row]);
+    }
+
+    if (bChanged)
+    {
+        Invalidate(EInvalidateWidgetReason::Paint);
+    }
+}
+
+bool SBattlePartyStatus::UpdateRowState(FRowState& State, const FBattlePartyStatusRow& Row)
+{
+    bool bChanged = false;
+
+    const float BarPixels = Appearance.BarWidth * PaintScale;
+    for (int32 Bar = 0; Bar < NumBars; ++Bar)
+    {
+        const int32 Pixels = FMath::RoundToInt(GetFraction(Row, Bar) * BarPixels);
+        if (State.FillPixels[Bar] != Pixels)
+        {
+            State.FillPixels[Bar] = Pixels;
+            bChanged = true;
+        }
+    }
+
+    const float Current[] = { Row.HP, Row.EO, Row.MP };
+    const float Max[] = { Row.MaxHP, Row.MaxEO, Row.MaxMP };
+    for (int32 Bar = 0; Bar <= MPBar; ++Bar)
+    {
+        const FText& Number = NumberTexts[Bar].GetRatio(Current[Bar], Max[Bar]);
+        if (!State.Numbers[Bar].IdenticalTo(Number))
+        {
+            State.Numbers[Bar] = Number;
+            bChanged = true;
+        }
+    }
+
+    if (!State.Values.Name.IdenticalTo(Row.Name) || State.Values.bInEOForm != Row.bInEOForm
+        || State.Values.bIsActing != Row.bIsActing || State.Values.bIsAlive != Row.bIsAlive)
+    {
+        bChanged = true;
+    }
+
+    if (bChanged)
+    {
+        State.Values = Row;
+    }
+    return bChanged;
+}
+
+float SBattlePartyStatus::GetFraction(const FBattlePartyStatusRow& Row, int32 Bar)
+{
+    switch (Bar)
+    {
+        case HPBar: return Row.MaxHP > 0.0f ? FMath::Clamp(Row.HP / Row.MaxHP, 0.0f, 1.0f) : 0.0f;
+        case EOBar: return Row.MaxEO > 0.0f ? FMath::Clamp(Row.EO / Row.MaxEO, 0.0f, 1.0f) : 0.0f;
+        case MPBar: return Row.bInEOForm && Row.MaxMP > 0.0f ? FMath::Clamp(Row.MP / Row.MaxMP, 0.0f, 1.0f) : 0.0f;
+        case TimerBar: return FMath::Clamp(Row.TimerFraction, 0.0f, 1.0f);
+        default: return 0.0f;
+    }
+}
+
+FVector2D SBattlePartyStatus::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+    const float Width = BarOffsets[NumBars - 1] + Appearance.BarWidth;
+    return FVector2D(Width, Rows.Num() * Appearance.RowHeight);
+}
+
+int32 SBattlePartyStatus::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
+                                  FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle,
+                                  bool bParentEnabled) const
+{
+    PaintScale = AllottedGeometry.Scale;
+
+    const ESlateDrawEffect DrawEffects = ShouldBeEnabled(bParentEnabled) ? ESlateDrawEffect::None : ESlateDrawEffect::DisabledEffect;
+    const FLinearColor Tint = InWidgetStyle.GetColorAndOpacityTint();
+    const FLinearColor BarColors[NumBars] = { Appearance.HPColor, Appearance.EOColor, Appearance.MPColor, Appearance.TimerColor };
+
+    // Backgrounds and fills on one layer, text on the next, so the batcher can merge each
+    const int32 BarLayer = LayerId;
+    const int32 TextLayer = LayerId + 1;
+
+    const float BarTop = (Appearance.RowHeight - Appearance.BarHeight) * 0.5f;
+    const FVector2f BarSize(Appearance.BarWidth, Appearance.BarHeight);
+
+    for (int32 Row = 0; Row < Rows.Num(); ++Row)
+    {
+        const FRowState& State = Rows[Row];
+        const FBattlePartyStatusRow& Values = State.Values;
+        const float RowTop = Row * Appearance.RowHeight;
+        const float Alpha = Values.bIsAlive ? 1.0f : 0.5f;
+
+        const FLinearColor NameColor = (Values.bIsActing ? Appearance.ActingColor : Appearance.NameColor).CopyWithNewOpacity(Alpha);
+        FSlateDrawElement::MakeText(OutDrawElements, TextLayer,
+                                    AllottedGeometry.ToPaintGeometry(FVector2f(Appearance.NameWidth, Appearance.RowHeight), FSlateLayoutTransform(FVector2f(0.0f, RowTop + BarTop))),
+                                    Values.Name, Appearance.Font, DrawEffects, NameColor * Tint);
+
+        for (int32 Bar = 0; Bar < NumBars; ++Bar)
+        {
+            // MP only exists in EO form
+            if (Bar == MPBar && !Values.bInEOForm) continue;
+
+            const FVector2f BarOffset(BarOffsets[Bar], RowTop + BarTop);
+            FSlateDrawElement::MakeBox(OutDrawElements, BarLayer,
+                                       AllottedGeometry.ToPaintGeometry(BarSize, FSlateLayoutTransform(BarOffset)),
+                                       Brush, DrawEffects, Appearance.BackgroundColor * Tint);
+
+            const float FillWidth = GetFraction(Values, Bar) * Appearance.BarWidth;
+            if (FillWidth > 0.0f)
+            {
+                FSlateDrawElement::MakeBox(OutDrawElements, BarLayer,
+                                           AllottedGeometry.ToPaintGeometry(FVector2f(FillWidth, Appearance.BarHeight), FSlateLayoutTransform(BarOffset)),
+                                           Brush, DrawEffects, BarColors[Bar].CopyWithNewOpacity(Alpha) * Tint);
+            }
+
+            if (Bar <= MPBar)
+            {
+                FSlateDrawElement::MakeText(OutDrawElements, TextLayer,
+                                            AllottedGeometry.ToPaintGeometry(BarSize, FSlateLayoutTransform(BarOffset + FVector2f(4.0f, 0.0f))),
+                                            State.Numbers[Bar], Appearance.Font, DrawEffects, Appearance.TextColor * Tint);
+            }
+        }
+    }
+
+    return TextLayer;
+}
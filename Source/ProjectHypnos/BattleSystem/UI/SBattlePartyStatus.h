@@ -0,0 +1,97 @@
+// SBattlePartyStatus.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SLeafWidget.h"
+#include "Fonts/SlateFontInfo.h"
+#include "BattleHUDText.h"
+
+// One party member as the status panel shows it
+struct FBattlePartyStatusRow
+{
+    FText Name;
+    float HP = 0.0f;
+    float MaxHP = 0.0f;
+    float EO = 0.0f;
+    float MaxEO = 0.0f;
+    float MP = 0.0f;
+    float MaxMP = 0.0f;
+    float TimerFraction = 0.0f;
+    bool bInEOForm = false;
+    bool bIsActing = false;
+    bool bIsAlive = true;
+};
+
+struct FBattlePartyStatusAppearance
+{
+    float RowHeight = 28.0f;
+    float NameWidth = 90.0f;
+    float BarWidth = 110.0f;
+    float BarHeight = 12.0f;
+    float Spacing = 6.0f;
+    FSlateFontInfo Font;
+    FLinearColor NameColor = FLinearColor::White;
+    FLinearColor ActingColor = FLinearColor(1.0f, 0.85f, 0.2f);
+    FLinearColor TextColor = FLinearColor::White;
+    FLinearColor BackgroundColor = FLinearColor(0.0f, 0.0f, 0.0f, 0.6f);
+    FLinearColor HPColor = FLinearColor(0.2f, 0.8f, 0.3f);
+    FLinearColor EOColor = FLinearColor(0.3f, 0.5f, 1.0f);
+    FLinearColor MPColor = FLinearColor(0.7f, 0.3f, 0.9f);
+    FLinearColor TimerColor = FLinearColor(1.0f, 0.85f, 0.2f);
+};
+
+/**
+ * Name, HP/EO/MP bars with their numbers, and turn timer for the whole party, drawn by one leaf
+ * widget in a single paint pass instead of a progress bar and text block per value.
+ *
+ * SetRows only invalidates paint when a bar's fill crosses a whole pixel or a number changes, and
+ * layout only when the number of rows does. Column positions are computed once per appearance.
+ */
+class PROJECTHYPNOS_API SBattlePartyStatus : public SLeafWidget
+{
+public:
+    SLATE_BEGIN_ARGS(SBattlePartyStatus) {}
+    SLATE_END_ARGS()
+
+    void Construct(const FArguments& InArgs);
+
+    void SetAppearance(const FBattlePartyStatusAppearance& InAppearance);
+    void SetRows(TArrayView<const FBattlePartyStatusRow> InRows);
+
+    virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
+                          FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle,
+                          bool bParentEnabled) const override;
+
+protected:
+    virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+
+private:
+    enum EBar { HPBar, EOBar, MPBar, TimerBar, NumBars };
+
+    // What was last handed to paint for one row
+    struct FRowState
+    {
+        FBattlePartyStatusRow Values;
+        int32 FillPixels[NumBars] = {};
+        FText Numbers[MPBar + 1];
+    };
+
+    // Returns true if Row paints differently from State, and updates State
+    bool UpdateRowState(FRowState& State, const FBattlePartyStatusRow& Row);
+
+    static float GetFraction(const FBattlePartyStatusRow& Row, int32 Bar);
+
+    FBattlePartyStatusAppearance Appearance;
+    const FSlateBrush* Brush = nullptr;
+
+    // Left edge of each bar within a row
+    float BarOffsets[NumBars] = {};
+
+    // Scale of the last paint, to turn bar fractions into pixels
+    mutable float PaintScale = 1.0f;
+
+    TArray<FRowState> Rows;
+
+    // Number labels by value, shared by every row
+    FBattleHUDTextCache NumberTexts[MPBar + 1];
+};
@@ -1,10 +1,15 @@
 // CombatUnit.cpp
 #include "CombatUnit.h"
 #include "Engine/DamageEvents.h"
+#include "Engine/World.h"
+#include "../Managers/BattleManager.h"
+#include "../Simulation/BattleSimRules.h"
+#include "../BattleLog.h"
 
 ACombatUnit::ACombatUnit()
 {
-    PrimaryActorTick.bCanEverTick = true;
+    // Nothing here runs per frame: passive EO is settled on demand and timers belong to the battle
+    PrimaryActorTick.bCanEverTick = false;
     CurrentHP = MaxHP;
     TimerRemaining = TimerDuration;
     CurrentEO = 0.0f;
@@ -15,42 +20,57 @@ ACombatUnit::ACombatUnit()
     bIsStressedOut = false;
 }
 
+void ACombatUnit::PostInitializeComponents()
+{
+    Super::PostInitializeComponents();
+
+    if (UBattleWorldSubsystem* Battles = UBattleWorldSubsystem::Get(this))
+    {
+        BattleHandle = Battles->Register(this, BattleId);
+    }
+}
+
+void ACombatUnit::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UBattleWorldSubsystem* Battles = UBattleWorldSubsystem::Get(this))
+    {
+        Battles->Unregister(this, BattleHandle);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
 void ACombatUnit::BeginPlay()
 {
     Super::BeginPlay();
     CurrentHP = MaxHP;
     CurrentMP = MaxMP; // Will be 0 unless in EO form
-}
-
-void ACombatUnit::Tick(float DeltaTime)
-{
-    Super::Tick(DeltaTime);
 
-    // Passive EO gain over time (very small)
-    if (!bIsInEOForm && IsAlive())
+    // Passive EO starts accruing from here
+    if (!IsBoundToSimulation())
     {
-        GainEO(5.0f * DeltaTime * EOGainRate); // 5 EO per second base rate
+        EOSettledTick = GetWorldClockTick();
     }
 }
 
 void ACombatUnit::ResetTimer()
 {
-    TimerRemaining = TimerDuration + StockpiledTime;
-    StockpiledTime = 0.0f; // Reset stockpiled time after using it
-    TimerTickRate = 1.0f; // Reset TFN effect
+    if (!EnsureNotBound(TEXT("ResetTimer"))) return;
+
+    int32 SimUnit;
+    FCombatUnitStore& SimUnits = AccessSimUnit(SimUnit);
+    BattleSim::ResetTimer(SimUnits, SimUnit);
+    ApplySimUnit(SimUnits, SimUnit);
 }
 
 void ACombatUnit::ResetForBattle()
 {
-    CurrentHP = MaxHP;
-    CurrentEO = 0.0f;
-    CurrentMP = 0.0f;
-    bIsInEOForm = false;
-    bIsStressedOut = false;
-    bIsIncapacitated = false;
-    EOGainRate = 1.0f;
-    StockpiledTime = 0.0f;
-    ResetTimer();
+    if (!EnsureNotBound(TEXT("ResetForBattle"))) return;
+
+    int32 SimUnit;
+    FCombatUnitStore& SimUnits = AccessSimUnit(SimUnit);
+    BattleSim::ResetForBattle(SimUnits, SimUnit);
+    ApplySimUnit(SimUnits, SimUnit);
 }
 
 bool ACombatUnit::CanAct() const
@@ -60,7 +80,12 @@ bool ACombatUnit::CanAct() const
 
 void ACombatUnit::SetIncapacitated(bool bIncapacitated)
 {
-    bIsIncapacitated = bIncapacitated;
+    if (!EnsureNotBound(TEXT("SetIncapacitated"))) return;
+
+    int32 SimUnit;
+    FCombatUnitStore& SimUnits = AccessSimUnit(SimUnit);
+    SimUnits.bIsIncapacitated[SimUnit] = bIncapacitated;
+    ApplySimUnit(SimUnits, SimUnit);
 }
 
 bool ACombatUnit::IsAlive() const
@@ -70,82 +95,144 @@ bool ACombatUnit::IsAlive() const
 
 void ACombatUnit::SetPosition(EBattlePosition NewPosition)
 {
-    CurrentPosition = NewPosition;
-    UE_LOG(LogTemp, Log, TEXT("%s moved to position %d"), *UnitName, (int32)NewPosition);
+    if (IsBoundToSimulation())
+    {
+        ABattleManager* Battle = GetBoundBattleManager();
+        if (ensure(Battle))
+        {
+            Battle->MoveUnit(this, NewPosition);
+        }
+        return;
+    }
+
+    int32 SimUnit;
+    FCombatUnitStore& SimUnits = AccessSimUnit(SimUnit);
+    SimUnits.Position[SimUnit] = NewPosition;
+    ApplySimUnit(SimUnits, SimUnit);
+    BATTLE_LOG(LogBattleUnits, Verbose, TEXT("%s moved to position %d"), *UnitName, (int32)NewPosition);
 }
 
 void ACombatUnit::ApplyTFN(float SpeedMultiplier)
 {
-    TimerTickRate = FMath::Max(0.25f, SpeedMultiplier); // Capped at 0.25x speed
-    UE_LOG(LogTemp, Log, TEXT("%s timer speed set to %f"), *UnitName, TimerTickRate);
+    if (!EnsureNotBound(TEXT("ApplyTFN"))) return;
+
+    int32 SimUnit;
+    FCombatUnitStore& SimUnits = AccessSimUnit(SimUnit);
+    BattleSim::ApplyTFN(SimUnits, SimUnit, SpeedMultiplier, GetSimTuning());
+    ApplySimUnit(SimUnits, SimUnit);
+    BATTLE_LOG(LogBattleUnits, Verbose, TEXT("%s timer speed set to %f"), *UnitName, TimerTickRate);
 }
 
 void ACombatUnit::AddStockpiledTime(float TimeToAdd)
 {
-    StockpiledTime += TimeToAdd;
-    UE_LOG(LogTemp, Log, TEXT("%s gained %f stockpiled time (Total: %f)"), *UnitName, TimeToAdd, StockpiledTime);
+    if (IsBoundToSimulation())
+    {
+        ABattleManager* Battle = GetBoundBattleManager();
+        if (ensure(Battle))
+        {
+            Battle->AddStockpiledTime(this, TimeToAdd);
+        }
+        return;
+    }
+
+    int32 SimUnit;
+    FCombatUnitStore& SimUnits = AccessSimUnit(SimUnit);
+    BattleSim::AddStockpiledTime(SimUnits, SimUnit, TimeToAdd);
+    ApplySimUnit(SimUnits, SimUnit);
+    BATTLE_LOG(LogBattleUnits, Verbose, TEXT("%s gained %f stockpiled time (Total: %f)"), *UnitName, TimeToAdd, StockpiledTime);
 }
 
 void ACombatUnit::GainEO(float Amount)
 {
-    if (bIsInEOForm) return; // Can't gain EO while in EO form
+    if (!EnsureNotBound(TEXT("GainEO"))) return;
 
-    float ActualGain = Amount * EOGainRate;
-    CurrentEO = FMath::Clamp(CurrentEO + ActualGain, 0.0f, MaxEO);
+    int32 SimUnit;
+    FCombatUnitStore& SimUnits = AccessSimUnit(SimUnit);
+    const bool bWasFull = SimUnits.CurrentEO[SimUnit] >= SimUnits.MaxEO[SimUnit];
+    const bool bFull = BattleSim::GainEO(SimUnits, SimUnit, Amount);
+    ApplySimUnit(SimUnits, SimUnit);
 
-    if (CurrentEO >= MaxEO)
+    // Only when the bar fills, not on every gain while it stays full
+    if (bFull && !bWasFull)
     {
-        UE_LOG(LogTemp, Warning, TEXT("%s EO bar is full! Can transform!"), *UnitName);
+        BATTLE_LOG(LogBattleUnits, Log, TEXT("%s EO bar is full! Can transform!"), *UnitName);
     }
 }
 
+float ACombatUnit::GetCurrentEO() const
+{
+    if (IsBoundToSimulation())
+    {
+        return BattleSim::GetCurrentEO(BoundSimState->Units, SimUnitIndex, BoundSimState->ClockTick, BoundSimState->Tuning);
+    }
+
+    const int64 Elapsed = GetWorldClockTick() - EOSettledTick;
+    const bool bAccrues = !bIsInEOForm && IsAlive() && Elapsed > 0;
+    return FCombatUnitStore::ComputeSettledEO(CurrentEO, MaxEO, EOGainRate, Elapsed, bAccrues, GetSimTuning().PassiveEOPerSecond);
+}
+
 bool ACombatUnit::CanTransformToEO() const
 {
-    return CurrentEO >= MaxEO && !bIsInEOForm && IsAlive();
+    return GetCurrentEO() >= MaxEO && !bIsInEOForm && IsAlive();
 }
 
 void ACombatUnit::TransformToEO()
 {
-    if (!CanTransformToEO()) return;
+    if (IsBoundToSimulation())
+    {
+        ABattleManager* Battle = GetBoundBattleManager();
+        if (ensure(Battle))
+        {
+            Battle->TransformToEO(this);
+        }
+        return;
+    }
 
-    bIsInEOForm = true;
-    CurrentMP = MaxMP; // Gain access to MP
+    int32 SimUnit;
+    FCombatUnitStore& SimUnits = AccessSimUnit(SimUnit);
+    if (!BattleSim::TransformToEO(SimUnits, SimUnit)) return;
+    ApplySimUnit(SimUnits, SimUnit);
 
-    // TODO: Apply stat boosts here
     // TODO: Change visual representation later
 
-    UE_LOG(LogTemp, Warning, TEXT("%s transformed into EO form!"), *UnitName);
+    BATTLE_LOG(LogBattleUnits, Warning, TEXT("%s transformed into EO form!"), *UnitName);
 }
 
 void ACombatUnit::ExitEOForm(bool bForced)
 {
-    if (!bIsInEOForm) return;
+    if (!EnsureNotBound(TEXT("ExitEOForm"))) return;
 
-    bIsInEOForm = false;
-    CurrentEO = 0.0f;
-    CurrentMP = 0.0f;
+    int32 SimUnit;
+    FCombatUnitStore& SimUnits = AccessSimUnit(SimUnit);
+    if (!BattleSim::ExitEOForm(SimUnits, SimUnit, bForced, GetSimTuning())) return;
+    ApplySimUnit(SimUnits, SimUnit);
 
     if (bForced)
     {
-        ApplyStressedOut();
-        UE_LOG(LogTemp, Error, TEXT("%s was forced out of EO form and is now Stressed Out!"), *UnitName);
+        BATTLE_LOG(LogBattleUnits, Error, TEXT("%s was forced out of EO form and is now Stressed Out!"), *UnitName);
     }
     else
     {
-        UE_LOG(LogTemp, Log, TEXT("%s exited EO form normally"), *UnitName);
+        BATTLE_LOG(LogBattleUnits, Log, TEXT("%s exited EO form normally"), *UnitName);
     }
 }
 
 float ACombatUnit::GetElementalDamageMultiplier(EElementalType AttackElement) const
 {
-    for (const FElementalResistance& Resistance : ElementalResistances)
+    if (IsBoundToSimulation())
     {
-        if (Resistance.ElementType == AttackElement)
-        {
-            return Resistance.ResistanceMultiplier;
-        }
+        return BattleSim::GetElementalDamageMultiplier(BoundSimState->Units, SimUnitIndex, AttackElement);
+    }
+    return BattleSim::GetElementalDamageMultiplier(ElementalResistances, AttackElement);
+}
+
+void ACombatUnit::SetElementalResistances(const TArray<FElementalResistance>& NewResistances)
+{
+    ElementalResistances = NewResistances;
+    if (IsBoundToSimulation())
+    {
+        BoundSimState->Units.SetElementalResistances(SimUnitIndex, ElementalResistances);
     }
-    return 1.0f; // No special resistance/weakness
 }
 
 // Override AActor's TakeDamage function
@@ -161,54 +248,192 @@ float ACombatUnit::TakeDamage(float DamageAmount, struct FDamageEvent const& Dam
 // Custom damage function for your battle system
 void ACombatUnit::TakeDamageCustom(float DamageAmount, EElementalType ElementType)
 {
-    if (!IsAlive()) return;
-
-    float Multiplier = GetElementalDamageMultiplier(ElementType);
-    float FinalDamage = DamageAmount * Multiplier;
-
-    if (bIsInEOForm)
+    if (IsBoundToSimulation())
     {
-        // In EO form, damage goes to EO bar instead of HP
-        CurrentEO -= FinalDamage;
-        if (CurrentEO <= 0.0f)
+        // Damage from outside the battle's own actions has no attacker to reward
+        ABattleManager* Battle = GetBoundBattleManager();
+        if (ensure(Battle))
         {
-            ExitEOForm(true); // Forced exit
+            Battle->QueueAttack(nullptr, this, ElementType, DamageAmount);
+            Battle->ResolvePendingDamage();
         }
+        return;
     }
-    else
+
+    int32 SimUnit;
+    FCombatUnitStore& SimUnits = AccessSimUnit(SimUnit);
+    const FBattleSimDamageResult Result = BattleSim::TakeDamage(SimUnits, SimUnit, DamageAmount, ElementType, GetSimTuning());
+    ApplySimUnit(SimUnits, SimUnit);
+
+    if (Result.bForcedOutOfEO)
     {
-        // Normal damage to HP
-        CurrentHP = FMath::Max(0.0f, CurrentHP - FinalDamage);
+        BATTLE_LOG(LogBattleUnits, Error, TEXT("%s was forced out of EO form and is now Stressed Out!"), *UnitName);
+    }
 
-        if (CurrentHP <= 0.0f)
-        {
-            UE_LOG(LogTemp, Error, TEXT("%s has been defeated!"), *UnitName);
-        }
+    if (Result.bDefeated)
+    {
+        BATTLE_LOG(LogBattleCombat, Error, TEXT("%s has been defeated!"), *UnitName);
     }
 
     // Check if this was a weakness hit
-    if (Multiplier > 1.0f)
+    if (Result.IsWeaknessHit())
     {
-        UE_LOG(LogTemp, Warning, TEXT("Weakness hit on %s! Damage multiplier: %f"), *UnitName, Multiplier);
+        BATTLE_LOG(LogBattleCombat, Warning, TEXT("Weakness hit on %s! Damage multiplier: %f"), *UnitName, Result.Multiplier);
     }
 }
 
 void ACombatUnit::ApplyStressedOut()
 {
-    bIsStressedOut = true;
-    EOGainRate = 0.5f; // Slower EO gain
+    if (!EnsureNotBound(TEXT("ApplyStressedOut"))) return;
 
-    // Set HP to 25% if it's higher than that
-    float TwentyFivePercent = MaxHP * 0.25f;
-    if (CurrentHP > TwentyFivePercent)
+    int32 SimUnit;
+    FCombatUnitStore& SimUnits = AccessSimUnit(SimUnit);
+    BattleSim::ApplyStressedOut(SimUnits, SimUnit, GetSimTuning());
+    ApplySimUnit(SimUnits, SimUnit);
+
+    BATTLE_LOG(LogBattleUnits, Error, TEXT("%s is now Stressed Out! EO gain reduced, HP set to 25%%"), *UnitName);
+}
+
+void ACombatUnit::SetDefenseType(EDefenseType DefenseType)
+{
+    if (!EnsureNotBound(TEXT("SetDefenseType"))) return;
+
+    int32 SimUnit;
+    FCombatUnitStore& SimUnits = AccessSimUnit(SimUnit);
+    SimUnits.DefenseType[SimUnit] = DefenseType;
+    ApplySimUnit(SimUnits, SimUnit);
+}
+
+void ACombatUnit::BindToSimulation(FBattleSimState* InState, int32 InUnitIndex)
+{
+    BoundSimState = InState;
+    SimUnitIndex = InUnitIndex;
+    RefreshFromSimUnit();
+}
+
+void ACombatUnit::UnbindFromSimulation()
+{
+    // Bank EO accrued on the battle clock and continue on world time
+    if (IsBoundToSimulation())
     {
-        CurrentHP = TwentyFivePercent;
+        BattleSim::SettleEO(BoundSimState->Units, SimUnitIndex, BoundSimState->ClockTick, BoundSimState->Tuning);
+        ApplySimUnit(BoundSimState->Units, SimUnitIndex);
+        EOSettledTick = GetWorldClockTick();
     }
 
-    UE_LOG(LogTemp, Error, TEXT("%s is now Stressed Out! EO gain reduced, HP set to 25%%"), *UnitName);
+    BoundSimState = nullptr;
+    SimUnitIndex = INDEX_NONE;
 }
 
-void ACombatUnit::SetDefenseType(EDefenseType DefenseType)
+bool ACombatUnit::IsBoundToSimulation() const
+{
+    return BoundSimState && BoundSimState->Units.IsValidIndex(SimUnitIndex);
+}
+
+ABattleManager* ACombatUnit::GetBoundBattleManager() const
+{
+    const UBattleWorldSubsystem* Battles = UBattleWorldSubsystem::Get(this);
+    ABattleManager* Battle = Battles ? Battles->GetBattleManager(BattleHandle) : nullptr;
+    return Battle && Battle->GetSimIndex(this) != INDEX_NONE ? Battle : nullptr;
+}
+
+bool ACombatUnit::EnsureNotBound(const TCHAR* Mutator) const
+{
+    return ensureMsgf(!IsBoundToSimulation(), TEXT("%s called on %s while it is in a battle. Change it through ABattleManager so the action log sees it."),
+        Mutator, *UnitName);
+}
+
+FBattleSimUnit ACombatUnit::MakeSimUnit() const
+{
+    FBattleSimUnit SimUnit;
+    SimUnit.UnitType = UnitType;
+    SimUnit.Position = CurrentPosition;
+    SimUnit.MaxHP = MaxHP;
+    SimUnit.CurrentHP = CurrentHP;
+    SimUnit.TimerDuration = BattleClock::SecondsToTimerUnits(TimerDuration);
+    SimUnit.TimerRemaining = BattleClock::SecondsToTimerUnits(TimerRemaining);
+    SimUnit.TimerTickRate = BattleClock::MultiplierToRate(TimerTickRate);
+    SimUnit.StockpiledTime = BattleClock::SecondsToTimerUnits(StockpiledTime);
+    SimUnit.MaxEO = MaxEO;
+    SimUnit.CurrentEO = CurrentEO;
+    SimUnit.EOGainRate = EOGainRate;
+    SimUnit.bIsInEOForm = bIsInEOForm;
+    SimUnit.EOSettledTick = EOSettledTick;
+    SimUnit.MaxMP = MaxMP;
+    SimUnit.CurrentMP = CurrentMP;
+    SimUnit.bIsStressedOut = bIsStressedOut;
+    SimUnit.bIsIncapacitated = bIsIncapacitated;
+    SimUnit.DefenseType = CurrentDefenseType;
+    SimUnit.ElementalResistances = ElementalResistances;
+    return SimUnit;
+}
+
+void ACombatUnit::RefreshFromSimUnit()
 {
-    CurrentDefenseType = DefenseType;
-}
\ No newline at end of file
+    if (IsBoundToSimulation())
+    {
+        const FCombatUnitStore& SimUnits = BoundSimState->Units;
+        ApplySimUnit(SimUnits, SimUnitIndex);
+
+        // The stored EO and active timer are only exact as of their last settle, so show the live values
+        CurrentEO = BattleSim::GetCurrentEO(SimUnits, SimUnitIndex, BoundSimState->ClockTick, BoundSimState->Tuning);
+        if (BoundSimState->DrainingUnit == SimUnitIndex)
+        {
+            TimerRemaining = BattleClock::TimerUnitsToSeconds(BattleSim::GetTimerRemaining(*BoundSimState));
+        }
+    }
+}
+
+FCombatUnitStore& ACombatUnit::AccessSimUnit(int32& OutUnit)
+{
+    FCombatUnitStore* SimUnits = &LocalSimUnits;
+    if (IsBoundToSimulation())
+    {
+        SimUnits = &BoundSimState->Units;
+        OutUnit = SimUnitIndex;
+    }
+    else
+    {
+        // Unbound units keep their Blueprint properties authoritative, so start from a fresh copy
+        LocalSimUnits.Reset();
+        OutUnit = LocalSimUnits.Add(MakeSimUnit());
+    }
+
+    // Every mutator may change the passive EO rate, so bank what has accrued first
+    BattleSim::SettleEO(*SimUnits, OutUnit, GetSimNowTick(), GetSimTuning());
+    return *SimUnits;
+}
+
+const FBattleSimTuning& ACombatUnit::GetSimTuning() const
+{
+    static const FBattleSimTuning DefaultTuning;
+    return IsBoundToSimulation() ? BoundSimState->Tuning : DefaultTuning;
+}
+
+void ACombatUnit::ApplySimUnit(const FCombatUnitStore& SimUnits, int32 SimUnit)
+{
+    CurrentPosition = SimUnits.Position[SimUnit];
+    CurrentHP = SimUnits.CurrentHP[SimUnit];
+    TimerRemaining = BattleClock::TimerUnitsToSeconds(SimUnits.TimerRemaining[SimUnit]);
+    TimerTickRate = BattleClock::RateToMultiplier(SimUnits.TimerTickRate[SimUnit]);
+    StockpiledTime = BattleClock::TimerUnitsToSeconds(SimUnits.StockpiledTime[SimUnit]);
+    CurrentEO = SimUnits.CurrentEO[SimUnit];
+    EOGainRate = SimUnits.EOGainRate[SimUnit];
+    bIsInEOForm = SimUnits.bIsInEOForm[SimUnit] != 0;
+    EOSettledTick = SimUnits.EOSettledTick[SimUnit];
+    CurrentMP = SimUnits.CurrentMP[SimUnit];
+    bIsStressedOut = SimUnits.bIsStressedOut[SimUnit] != 0;
+    bIsIncapacitated = SimUnits.bIsIncapacitated[SimUnit] != 0;
+    CurrentDefenseType = SimUnits.DefenseType[SimUnit];
+}
+
+int64 ACombatUnit::GetSimNowTick() const
+{
+    return IsBoundToSimulation() ? BoundSimState->ClockTick : GetWorldClockTick();
+}
+
+int64 ACombatUnit::GetWorldClockTick() const
+{
+    const UWorld* World = GetWorld();
+    return World ? FMath::FloorToInt64(World->GetTimeSeconds() * BattleClock::TicksPerSecond) : 0;
+}
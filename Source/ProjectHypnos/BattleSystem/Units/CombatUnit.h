@@ -4,65 +4,10 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Engine/DamageEvents.h"
+#include "../Simulation/BattleSimState.h"
+#include "../Managers/BattleWorldSubsystem.h"
 #include "CombatUnit.generated.h"
 
-UENUM(BlueprintType)
-enum class EUnitType : uint8
-{
-    Player,
-    Enemy
-};
-
-UENUM(BlueprintType)
-enum class EBattlePosition : uint8
-{
-    North,
-    East,
-    South,
-    West,
-    Center  // For enemies
-};
-
-UENUM(BlueprintType)
-enum class EElementalType : uint8
-{
-    None,
-    Fire,
-    Water,
-    Earth,
-    Air,
-    Light,
-    Dark,
-    Physical
-};
-
-UENUM(BlueprintType)
-enum class EDefenseType : uint8
-{
-    None,
-    Guard,
-    Dodge,
-    Parry
-};
-
-USTRUCT(BlueprintType)
-struct PROJECTHYPNOS_API FElementalResistance
-{
-    GENERATED_BODY()
-
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Resistance")
-    EElementalType ElementType;
-
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Resistance")
-    float ResistanceMultiplier;
-
-    FElementalResistance()
-    {
-        ElementType = EElementalType::None;
-        ResistanceMultiplier = 1.0f;
-    }
-};
-
 UCLASS(Blueprintable)
 class PROJECTHYPNOS_API ACombatUnit : public AActor
 {
@@ -72,18 +17,30 @@ public:
     ACombatUnit();
 
 protected:
+    virtual void PostInitializeComponents() override;
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
-    virtual void Tick(float DeltaTime) override;
+    // Managers and units with the same ID form one battle
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Battle")
+    FName BattleId;
 
     // Basic Unit Properties
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
     FString UnitName;
 
+    // Stable character identity, used by Ranti combos to name their members
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
+    FName CharacterId;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
     EUnitType UnitType;
 
+    // Bosses plan their turns with a full lookahead search instead of sampled rollouts
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
+    bool bIsBoss = false;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
     EBattlePosition CurrentPosition = EBattlePosition::West;
 
@@ -112,6 +69,7 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
     float MaxEO = 100.0f;
 
+    // Passive EO accrues lazily, so this is the value as of the last change. Use GetCurrentEO for a live reading.
     UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Combat")
     float CurrentEO = 0.0f;
 
@@ -172,6 +130,10 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Combat")
     void GainEO(float Amount);
 
+    // CurrentEO plus passive gain accrued since it was last settled
+    UFUNCTION(BlueprintPure, Category = "Combat")
+    float GetCurrentEO() const;
+
     UFUNCTION(BlueprintCallable, Category = "Combat")
     bool CanTransformToEO() const;
 
@@ -184,6 +146,10 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Combat")
     float GetElementalDamageMultiplier(EElementalType AttackElement) const;
 
+    // Use this rather than writing ElementalResistances directly, so a bound battle recompiles its multiplier table
+    UFUNCTION(BlueprintCallable, Category = "Combat")
+    void SetElementalResistances(const TArray<FElementalResistance>& NewResistances);
+
     // Override the AActor TakeDamage function properly
     virtual float TakeDamage(float DamageAmount, struct FDamageEvent const& DamageEvent, class AController* EventInstigator, AActor* DamageCauser) override;
 
@@ -196,4 +162,47 @@ public:
 
     UFUNCTION(BlueprintCallable, Category = "Combat")
     void SetDefenseType(EDefenseType DefenseType);
+
+    // Simulation binding. While bound to a battle, the runtime fields above are a view over
+    // the unit's lane in that battle's FCombatUnitStore and all rules run against the store.
+    // Every change then has to go through the battle's ABattleManager, which logs it for replays:
+    // SetPosition, AddStockpiledTime, TransformToEO and TakeDamageCustom forward there, and the
+    // other mutators above must not be called while bound.
+    void BindToSimulation(FBattleSimState* InState, int32 InUnitIndex);
+    void UnbindFromSimulation();
+    bool IsBoundToSimulation() const;
+    int32 GetSimUnitIndex() const { return SimUnitIndex; }
+
+    // Builds a simulation unit from the authored and current runtime properties
+    FBattleSimUnit MakeSimUnit() const;
+
+    // Copies runtime values from the simulation back into the Blueprint-visible properties
+    void RefreshFromSimUnit();
+
+protected:
+    // Returns the store holding this unit and its handle in OutUnit: the bound battle's store, or a
+    // one-unit scratch store built from this actor's properties when unbound
+    FCombatUnitStore& AccessSimUnit(int32& OutUnit);
+    const FBattleSimTuning& GetSimTuning() const;
+
+    // The manager of the battle this unit is bound into, if it is in one
+    class ABattleManager* GetBoundBattleManager() const;
+
+    // Fails an ensure if the unit is bound, for mutators with no logged path through the battle
+    bool EnsureNotBound(const TCHAR* Mutator) const;
+
+    void ApplySimUnit(const FCombatUnitStore& SimUnits, int32 SimUnit);
+
+    // Clock the EO settle tick is measured on: the battle clock while bound, world time otherwise
+    int64 GetSimNowTick() const;
+    int64 GetWorldClockTick() const;
+
+    FBattleHandle BattleHandle;
+
+    FBattleSimState* BoundSimState = nullptr;
+    int32 SimUnitIndex = INDEX_NONE;
+    FCombatUnitStore LocalSimUnits;
+
+    // Tick CurrentEO was last settled at, on the clock GetSimNowTick returns
+    int64 EOSettledTick = 0;
 };
\ No newline at end of file